@@ -46,9 +46,11 @@ fn main() {
         "../src/core/huffman.cc",
         "../src/core/initializer.cc",
         "../src/core/movegenerator.cc",
+        "../src/core/movepicker.cc",
         "../src/core/position.cc",
         "../src/core/positionbuilder.cc",
         "../src/core/state.cc",
+        "../src/core/statearena.cc",
         "../src/core/statebuilder.cc",
         "../src/io/csa.cc",
         "../src/io/file.cc",
@@ -59,11 +61,16 @@ fn main() {
         "../src/ml/simpleteacher.cc",
         "../src/ml/teacherloader.cc",
         "../src/ml/utils.cc",
+        "../src/solver/internal/batcheddfpn.cc",
         "../src/solver/internal/dfpn.cc",
+        "../src/solver/internal/dfs.cc",
         "../src/solver/internal/mate1ply.cc",
+        "../src/solver/internal/mate3ply.cc",
+        "../src/solver/internal/tablememory.cc",
         "../src/solver/dfpn.cc",
         "../src/solver/dfs.cc",
         "../src/solver/mate1ply.cc",
+        "../src/solver/mate3ply.cc",
     ]);
 
     build.flag("-std=c++20");
@@ -0,0 +1,92 @@
+#include "../core/initializer.h"
+#include "../core/movegenerator.h"
+#include "../core/state.h"
+#include "../core/statearena.h"
+#include "../io/sfen.h"
+#include "../ml/simpleteacher.h"
+#include "common.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <random>
+#include <vector>
+
+void benchSimpleTeacherGetState(const std::vector<nshogi::ml::SimpleTeacher>&);
+void benchSimpleTeacherGetStateWithArena(
+    const std::vector<nshogi::ml::SimpleTeacher>&, nshogi::core::StateArena&);
+
+namespace {
+
+std::atomic<uint64_t> NumAllocations(0);
+
+uint64_t countAllocations() {
+    return NumAllocations.load(std::memory_order_relaxed);
+}
+
+} // namespace
+
+// Count the heap allocations of this binary, so that the benches below can
+// report allocations per loaded teacher. This binary is separate from the
+// main bench so that the replacement does not affect the other benches.
+void* operator new(std::size_t Size) {
+    NumAllocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* Pointer = std::malloc(Size == 0 ? 1 : Size)) {
+        return Pointer;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* Pointer) noexcept {
+    std::free(Pointer);
+}
+
+void operator delete(void* Pointer, std::size_t) noexcept {
+    std::free(Pointer);
+}
+
+int main() {
+    using namespace nshogi::bench;
+
+    nshogi::core::initializer::initializeAll();
+
+    std::mt19937_64 Mt(20260302);
+    std::vector<nshogi::ml::SimpleTeacher> Teachers;
+    for (int Game = 0; Game < 100; ++Game) {
+        nshogi::core::State State =
+            nshogi::io::sfen::StateBuilder::getInitialState();
+        for (int Ply = 0; Ply < 256; ++Ply) {
+            const auto Moves =
+                nshogi::core::MoveGenerator::generateLegalMoves(State);
+            if (Moves.size() == 0) {
+                break;
+            }
+            State.doMove(Moves[Mt() % Moves.size()]);
+            Teachers.emplace_back().setState(State);
+        }
+    }
+
+    const auto PrintAllocations = [&](uint64_t Allocations, uint64_t Called) {
+        std::cout << "    +---- Allocations per teacher: "
+                  << (double)Allocations / (double)(Called * Teachers.size())
+                  << std::endl;
+    };
+
+    uint64_t Allocations = countAllocations();
+    auto Result = runCountBench("SimpleTeacher::getState()",
+                                benchSimpleTeacherGetState, 100, Teachers);
+    PrintAllocations(countAllocations() - Allocations, Result.Called);
+
+    // The first pass warms the arena up.
+    nshogi::core::StateArena Arena;
+    benchSimpleTeacherGetStateWithArena(Teachers, Arena);
+
+    Allocations = countAllocations();
+    Result = runCountBench("SimpleTeacher::getState() with an arena",
+                           benchSimpleTeacherGetStateWithArena, 100, Teachers,
+                           Arena);
+    PrintAllocations(countAllocations() - Allocations, Result.Called);
+
+    return 0;
+}
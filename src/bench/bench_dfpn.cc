@@ -0,0 +1,49 @@
+#include "../core/state.h"
+#include "../solver/dfpn.h"
+#include "common.hpp"
+#include <vector>
+
+// Constructs a solver per problem, which is what callers without a reusable
+// solver pay: the allocation and the first touch of every table page.
+void benchDfPnFreshSolver(std::vector<nshogi::core::State>& States,
+                          std::size_t MemoryMB) {
+    for (auto& State : States) {
+        nshogi::solver::dfpn::Solver Solver(MemoryMB);
+        const auto CheckmateMove = Solver.solve(&State, 10000);
+        nshogi::bench::doNotOptimize(CheckmateMove);
+    }
+}
+
+// Reuses one solver; starting a new problem only bumps the generation.
+void benchDfPnReusedSolver(std::vector<nshogi::core::State>& States,
+                           nshogi::solver::dfpn::Solver& Solver) {
+    for (auto& State : States) {
+        const auto CheckmateMove = Solver.solve(&State, 10000);
+        nshogi::bench::doNotOptimize(CheckmateMove);
+    }
+}
+
+// Solves every problem with a generous node limit and accumulates the
+// searched nodes, so that the caller can report nodes per second.
+void benchDfPnProblems(std::vector<nshogi::core::State>& States,
+                       nshogi::solver::dfpn::Solver& Solver,
+                       uint64_t& NodeCount) {
+    for (auto& State : States) {
+        const auto CheckmateMove = Solver.solve(&State, 1000000);
+        nshogi::bench::doNotOptimize(CheckmateMove);
+        NodeCount += Solver.searchedNodeCount();
+    }
+}
+
+// Counts the problems solved within `MaxNodeCount` nodes each, to compare
+// how well tables of different sizes hold the proofs.
+void benchDfPnSolvedProblems(std::vector<nshogi::core::State>& States,
+                             nshogi::solver::dfpn::Solver& Solver,
+                             uint64_t MaxNodeCount, uint64_t& Solved) {
+    for (auto& State : States) {
+        const auto CheckmateMove = Solver.solve(&State, MaxNodeCount);
+        if (!CheckmateMove.isNone()) {
+            ++Solved;
+        }
+    }
+}
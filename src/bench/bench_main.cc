@@ -5,23 +5,50 @@
 #include "../io/csa.h"
 #include "../io/sfen.h"
 #include "../ml/featurestack.h"
+#include "../solver/dfpn.h"
 #include "../solver/mate1ply.h"
 #include "common.hpp"
+#include "perft.hpp"
+#include <algorithm>
 #include <fstream>
+#include <numeric>
 #include <random>
+#include <thread>
 
 void benchMoveGeneration(const nshogi::core::State&);
 // void benchMoveGenerationInternal(const nshogi::core::internal::StateImpl&);
 void benchMoveGenerationSet(const std::vector<nshogi::core::State>&);
+void benchMovePickerSet(const std::vector<nshogi::core::State>&, std::size_t);
 void benchMate1ply(const std::vector<nshogi::core::State>&);
+void benchMate1plyBatch(const std::vector<nshogi::core::State>&,
+                        std::vector<nshogi::core::Move32>&, std::size_t);
+void benchMate3ply(std::vector<nshogi::core::State>&);
+void benchMate5ply(std::vector<nshogi::core::State>&);
 void benchPerft(int Ply);
+void benchPerftDoMove(nshogi::core::State&, int, uint64_t&);
+void benchPerftWithOptions(const nshogi::core::State&,
+                           const nshogi::bench::PerftOptions&, uint64_t&);
+void benchDfPnFreshSolver(std::vector<nshogi::core::State>&, std::size_t);
+void benchDfPnReusedSolver(std::vector<nshogi::core::State>&,
+                           nshogi::solver::dfpn::Solver&);
+void benchDfPnProblems(std::vector<nshogi::core::State>&,
+                       nshogi::solver::dfpn::Solver&, uint64_t&);
+void benchDfPnSolvedProblems(std::vector<nshogi::core::State>&,
+                             nshogi::solver::dfpn::Solver&, uint64_t,
+                             uint64_t&);
+void benchRepetitionStatus(const std::vector<nshogi::core::State>&);
+void benchRepetitionStatusAlongGames(std::vector<nshogi::core::State>&);
 
-int main() {
+int main(int Argc, char** Argv) {
     using namespace nshogi;
     using namespace nshogi::bench;
 
     nshogi::core::initializer::initializeAll();
 
+    if (Argc > 1 && std::string(Argv[1]) == "perft") {
+        return runPerftCommand(Argc - 2, Argv + 2);
+    }
+
     // std::mt19937_64 Mt(12345);
     // for (int i = 0; i < 10000; ++i) {
     //     core::State State = core::StateBuilder::getInitialState();
@@ -121,6 +148,38 @@ int main() {
 
         runCountBench("Movegeneration position set", benchMoveGenerationSet,
                       200, States);
+        runCountBench("MovePicker position set (first 3 moves)",
+                      benchMovePickerSet, 200, States, (std::size_t)3);
+        runCountBench("MovePicker position set (all moves)",
+                      benchMovePickerSet, 200, States, (std::size_t)600);
+    }
+
+    // Long games, whose whole history a repetition check used to scan.
+    {
+        std::mt19937_64 Mt(20260304);
+        std::vector<nshogi::core::State> States;
+        uint64_t TotalPly = 0;
+        for (int Game = 0; Game < 100; ++Game) {
+            nshogi::core::State State =
+                nshogi::io::sfen::StateBuilder::getInitialState();
+            for (int Ply = 0; Ply < 1000; ++Ply) {
+                const auto Moves =
+                    nshogi::core::MoveGenerator::generateLegalMoves(State);
+                if (Moves.size() == 0) {
+                    break;
+                }
+                State.doMove(Moves[Mt() % Moves.size()]);
+            }
+            TotalPly += State.getPly(false);
+            States.push_back(std::move(State));
+        }
+
+        std::cout << "Average game length: "
+                  << (double)TotalPly / (double)States.size() << std::endl;
+        runCountBench("Repetition status at the end of long games",
+                      benchRepetitionStatus, 100000, States);
+        runCountBench("Repetition status along long games",
+                      benchRepetitionStatusAlongGames, 100, States);
     }
 
     // {
@@ -175,6 +234,185 @@ int main() {
                       NegativeStates);
     }
 
+    {
+        // Throughput on a set much larger than the caches, visited in an
+        // order unrelated to the memory layout, as when filtering training
+        // data: one position at a time against the batch API.
+        std::mt19937_64 Mt(20260720);
+        std::vector<nshogi::core::State> Generated;
+        for (int Game = 0; Game < 100; ++Game) {
+            nshogi::core::State State =
+                nshogi::io::sfen::StateBuilder::getInitialState();
+            for (int Ply = 0; Ply < 256; ++Ply) {
+                const auto Moves =
+                    nshogi::core::MoveGenerator::generateLegalMoves(State);
+                if (Moves.size() == 0) {
+                    break;
+                }
+                State.doMove(Moves[Mt() % Moves.size()]);
+                Generated.push_back(State.clone());
+            }
+        }
+
+        std::vector<std::size_t> Order(Generated.size());
+        std::iota(Order.begin(), Order.end(), 0);
+        std::shuffle(Order.begin(), Order.end(), Mt);
+
+        std::vector<nshogi::core::State> States;
+        States.reserve(Generated.size());
+        for (const std::size_t Index : Order) {
+            States.push_back(std::move(Generated[Index]));
+        }
+
+        std::vector<nshogi::core::Move32> Out(States.size());
+        const std::size_t NumThreads =
+            std::max(1U, std::thread::hardware_concurrency());
+
+        const auto PrintPositionsPerSecond = [&](const BenchResult& Result) {
+            std::cout << "    +---- Positions per second: "
+                      << (double)Result.Called * (double)States.size() *
+                             1000 / Result.MilliSeconds
+                      << std::endl;
+        };
+
+        PrintPositionsPerSecond(runCountBench("Mate1Ply position set",
+                                              benchMate1ply, 100, States));
+        PrintPositionsPerSecond(runCountBench("Mate1Ply position set (batch)",
+                                              benchMate1plyBatch, 100, States,
+                                              Out, (std::size_t)1));
+        PrintPositionsPerSecond(
+            runCountBench("Mate1Ply position set (batch, " +
+                              std::to_string(NumThreads) + " threads)",
+                          benchMate1plyBatch, 100, States, Out, NumThreads));
+    }
+
+    {
+        // Per-problem overhead of the df-pn solver on short problems: the
+        // difference between the two benches is the setup cost that reusing
+        // a solver (generation bump instead of a table wipe) avoids.
+        std::vector<nshogi::core::State> States;
+        std::ifstream Ifs("./res/test/mate-3-ply.txt");
+
+        std::string Line;
+        while (std::getline(Ifs, Line) && States.size() < 100) {
+            States.push_back(nshogi::io::sfen::StateBuilder::newState(Line));
+        }
+
+        const std::size_t MemoryMB = 256;
+        runCountBench("DfPn 100 mate-3-ply (fresh 256MB solver per problem)",
+                      benchDfPnFreshSolver, 1, States, MemoryMB);
+
+        nshogi::solver::dfpn::Solver Solver(MemoryMB);
+        runCountBench("DfPn 100 mate-3-ply (reused 256MB solver)",
+                      benchDfPnReusedSolver, 100, States, Solver);
+
+        // The table-free search on the same problems.
+        runCountBench("Mate3Ply 100 mate-3-ply", benchMate3ply, 100, States);
+    }
+
+    {
+        // The same comparison one mate deeper, where df-pn starts to gain
+        // from its table.
+        std::vector<nshogi::core::State> States;
+        std::ifstream Ifs("./res/test/mate-5-ply.txt");
+
+        std::string Line;
+        while (std::getline(Ifs, Line) && States.size() < 100) {
+            States.push_back(nshogi::io::sfen::StateBuilder::newState(Line));
+        }
+
+        nshogi::solver::dfpn::Solver Solver(256);
+        runCountBench("DfPn 100 mate-5-ply (reused 256MB solver)",
+                      benchDfPnReusedSolver, 10, States, Solver);
+        runCountBench("Mate5Ply 100 mate-5-ply", benchMate5ply, 10, States);
+    }
+
+    // Search speed of df-pn on the problem sets of test_solver.cc.
+    for (const char* Name : {"mate-5-ply", "mate-7-ply", "mate-9-ply",
+                             "mate-11-ply"}) {
+        std::vector<nshogi::core::State> States;
+        std::ifstream Ifs(std::string("./res/test/") + Name + ".txt");
+
+        std::string Line;
+        while (std::getline(Ifs, Line)) {
+            States.push_back(nshogi::io::sfen::StateBuilder::newState(Line));
+        }
+
+        nshogi::solver::dfpn::Solver Solver(256);
+        uint64_t NodeCount = 0;
+        const auto Result =
+            runCountBench(std::string("DfPn ") + Name, benchDfPnProblems, 1,
+                          States, Solver, NodeCount);
+        std::cout << "    +---- Nodes: " << NodeCount << std::endl;
+        std::cout << "    +---- Nodes per second: "
+                  << (double)NodeCount * 1000 / Result.MilliSeconds
+                  << std::endl;
+    }
+
+    // Node counts of the df-pn heuristics on the longest bundled mates.
+    {
+        std::vector<nshogi::core::State> States;
+        std::ifstream Ifs("./res/test/mate-11-ply.txt");
+
+        std::string Line;
+        while (std::getline(Ifs, Line)) {
+            States.push_back(nshogi::io::sfen::StateBuilder::newState(Line));
+        }
+
+        struct HeuristicsCase {
+            const char* Name;
+            bool InitialNumbers;
+            double ThresholdEpsilon;
+        };
+
+        for (const HeuristicsCase& Case :
+             {HeuristicsCase{"plain", false, 0.0},
+              HeuristicsCase{"df-pn+ initial numbers", true, 0.0},
+              HeuristicsCase{"1+epsilon (0.25)", false, 0.25},
+              HeuristicsCase{"df-pn+ and 1+epsilon (0.25)", true, 0.25}}) {
+            nshogi::solver::dfpn::Solver Solver(256);
+            nshogi::solver::dfpn::Heuristics H;
+            H.InitialNumbers = Case.InitialNumbers;
+            H.ThresholdEpsilon = Case.ThresholdEpsilon;
+            Solver.setHeuristics(H);
+
+            uint64_t NodeCount = 0;
+            const auto Result = runCountBench(
+                std::string("DfPn mate-11-ply ") + Case.Name,
+                benchDfPnProblems, 1, States, Solver, NodeCount);
+            std::cout << "    +---- Nodes: " << NodeCount << std::endl;
+            std::cout << "    +---- Nodes per second: "
+                      << (double)NodeCount * 1000 / Result.MilliSeconds
+                      << std::endl;
+        }
+    }
+
+    // Solved problems per GB of table on the longest bundled mates, with
+    // tables small enough to saturate.
+    {
+        std::vector<nshogi::core::State> States;
+        std::ifstream Ifs("./res/test/mate-11-ply.txt");
+
+        std::string Line;
+        while (std::getline(Ifs, Line)) {
+            States.push_back(nshogi::io::sfen::StateBuilder::newState(Line));
+        }
+
+        for (const std::size_t MemoryMB : {1, 2, 4}) {
+            nshogi::solver::dfpn::Solver Solver(MemoryMB);
+            uint64_t Solved = 0;
+            runCountBench("DfPn mate-11-ply (" + std::to_string(MemoryMB) +
+                              "MB solver, 200000 nodes)",
+                          benchDfPnSolvedProblems, 1, States, Solver,
+                          (uint64_t)200000, Solved);
+            std::cout << "    +---- Solved: " << Solved << " / "
+                      << States.size() << std::endl;
+            std::cout << "    +---- Solved per GB: "
+                      << (double)Solved * 1024 / (double)MemoryMB
+                      << std::endl;
+        }
+    }
+
     runCountBench("perft 1", benchPerft, 1, 1);
     runCountBench("perft 2", benchPerft, 1, 2);
     runCountBench("perft 3", benchPerft, 1, 3);
@@ -182,5 +420,55 @@ int main() {
     runCountBench("perft 5", benchPerft, 1, 5);
     runCountBench("perft 6", benchPerft, 1, 6);
 
+    // Every node is reached by doMove(), which writes one step record.
+    {
+        nshogi::core::State State =
+            nshogi::core::StateBuilder::getInitialState();
+        uint64_t Nodes = 0;
+        const auto Result = runCountBench("perft 5 (doMove at every leaf)",
+                                          benchPerftDoMove, 1, State, 5,
+                                          Nodes);
+        std::cout << "    +---- Nodes per second: "
+                  << (double)Nodes * 1000 / Result.MilliSeconds << std::endl;
+        std::cout << "    +---- Step record: "
+                  << sizeof(nshogi::core::internal::StepHelper)
+                  << " (bytes per ply)" << std::endl;
+    }
+
+    // Move generation throughput across cores, and what caching the
+    // transpositions saves.
+    {
+        const nshogi::core::State State =
+            nshogi::core::StateBuilder::getInitialState();
+        const std::size_t NumThreads =
+            std::max(1U, std::thread::hardware_concurrency());
+
+        struct PerftCase {
+            std::string Name;
+            std::size_t NumThreads;
+            std::size_t HashMB;
+        };
+
+        for (const PerftCase& Case :
+             {PerftCase{"perft 6 (1 thread)", 1, 0},
+              PerftCase{"perft 6 (" + std::to_string(NumThreads) +
+                            " threads)",
+                        NumThreads, 0},
+              PerftCase{"perft 6 (1 thread, 64MB hash)", 1, 64}}) {
+            PerftOptions Options;
+            Options.Depth = 6;
+            Options.NumThreads = Case.NumThreads;
+            Options.HashMB = Case.HashMB;
+
+            uint64_t Nodes = 0;
+            const auto Result = runCountBench(Case.Name, benchPerftWithOptions,
+                                              1, State, Options, Nodes);
+            std::cout << "    +---- Nodes: " << Nodes << std::endl;
+            std::cout << "    +---- Nodes per second: "
+                      << (double)Nodes * 1000 / Result.MilliSeconds
+                      << std::endl;
+        }
+    }
+
     return 0;
 }
@@ -8,3 +8,10 @@ void benchMate1ply(const std::vector<nshogi::core::State>& States) {
         nshogi::bench::doNotOptimize(CheckmateMove);
     }
 }
+
+void benchMate1plyBatch(const std::vector<nshogi::core::State>& States,
+                        std::vector<nshogi::core::Move32>& Out,
+                        std::size_t NumThreads) {
+    nshogi::solver::mate1ply::solveBatch(States, Out.data(), NumThreads);
+    nshogi::bench::doNotOptimize(Out.data());
+}
@@ -0,0 +1,17 @@
+#include "../solver/mate3ply.h"
+#include "common.hpp"
+#include <vector>
+
+void benchMate3ply(std::vector<nshogi::core::State>& States) {
+    for (auto& State : States) {
+        const auto CheckmateMove = nshogi::solver::mate3ply::solve(&State);
+        nshogi::bench::doNotOptimize(CheckmateMove);
+    }
+}
+
+void benchMate5ply(std::vector<nshogi::core::State>& States) {
+    for (auto& State : States) {
+        const auto CheckmateMove = nshogi::solver::mate5ply::solve(&State);
+        nshogi::bench::doNotOptimize(CheckmateMove);
+    }
+}
@@ -1,5 +1,6 @@
 #include "../core/internal/stateimpl.h"
 #include "../core/movegenerator.h"
+#include "../core/movepicker.h"
 #include "../core/position.h"
 #include "../io/sfen.h"
 #include "common.hpp"
@@ -31,6 +32,22 @@ void benchMoveGenerationSet(const std::vector<nshogi::core::State>& States) {
     }
 }
 
+// Takes up to `NumMoves` moves from a MovePicker, as a search node that
+// cuts off after `NumMoves` moves would.
+void benchMovePickerSet(const std::vector<nshogi::core::State>& States,
+                        std::size_t NumMoves) {
+    for (const auto& State : States) {
+        nshogi::core::MovePicker<> Picker(State);
+        for (std::size_t I = 0; I < NumMoves; ++I) {
+            const nshogi::core::Move32 Move = Picker.next();
+            nshogi::bench::doNotOptimize(Move);
+            if (Move.isNone()) {
+                break;
+            }
+        }
+    }
+}
+
 // void benchMoveGenerationInternal(const nshogi::core::internal::StateImpl&
 // State) {
 //     [[maybe_unused]]
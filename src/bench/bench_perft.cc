@@ -1,16 +1,85 @@
 #include "../core/movegenerator.h"
 #include "../core/state.h"
 #include "../core/statebuilder.h"
+#include "../io/sfen.h"
+#include "common.hpp"
+#include "perft.hpp"
+
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+
+namespace nshogi {
+namespace bench {
 
 namespace {
 
-uint64_t perftImpl(nshogi::core::State& State, int Limit) {
+// Subtree counts keyed by position hash and depth, shared by all threads
+// without locks: an entry stores its key xor-ed with its data, so that a
+// torn write reads as a miss.
+class PerftTable {
+ public:
+    explicit PerftTable(std::size_t MemoryMB) {
+        const std::size_t Size = std::bit_floor(std::max<std::size_t>(
+            1, MemoryMB * 1024 * 1024 / sizeof(Entry)));
+        Entries = std::make_unique<Entry[]>(Size);
+        Mask = Size - 1;
+    }
+
+    bool probe(uint64_t Hash, int Depth, uint64_t* Nodes) const {
+        const Entry& E = Entries[index(Hash, Depth)];
+        const uint64_t Data = E.Data.load(std::memory_order_relaxed);
+        const uint64_t Key = E.Key.load(std::memory_order_relaxed);
+        if ((Key ^ Data) != Hash || (int)(Data & DepthMask) != Depth) {
+            return false;
+        }
+        *Nodes = Data >> DepthBits;
+        return true;
+    }
+
+    void store(uint64_t Hash, int Depth, uint64_t Nodes) {
+        Entry& E = Entries[index(Hash, Depth)];
+        const uint64_t Data = Nodes << DepthBits | (uint64_t)Depth;
+        E.Key.store(Hash ^ Data, std::memory_order_relaxed);
+        E.Data.store(Data, std::memory_order_relaxed);
+    }
+
+ private:
+    static constexpr int DepthBits = 8;
+    static constexpr uint64_t DepthMask = (1ULL << DepthBits) - 1;
+
+    struct Entry {
+        std::atomic<uint64_t> Key{0};
+        std::atomic<uint64_t> Data{0};
+    };
+
+    std::size_t index(uint64_t Hash, int Depth) const {
+        return (Hash ^ ((uint64_t)Depth * 0x9e3779b97f4a7c15ULL)) & Mask;
+    }
+
+    std::unique_ptr<Entry[]> Entries;
+    std::size_t Mask;
+};
+
+uint64_t perftImpl(core::State& State, int Limit, PerftTable* Table) {
     if (Limit == 0) {
         return 1;
     }
 
-    const auto Moves =
-        nshogi::core::MoveGenerator::generateLegalMoves<false>(State);
+    // The last ply only counts the moves (bulk counting), which is far
+    // cheaper than a table probe.
+    uint64_t Cached = 0;
+    if (Table != nullptr && Limit >= 2 &&
+        Table->probe(State.getHash(), Limit, &Cached)) {
+        return Cached;
+    }
+
+    const auto Moves = core::MoveGenerator::generateLegalMoves<false>(State);
 
     if (Limit == 1) {
         return (uint64_t)Moves.size();
@@ -19,18 +88,189 @@ uint64_t perftImpl(nshogi::core::State& State, int Limit) {
     uint64_t Sum = 0;
     for (const auto& Move : Moves) {
         State.doMove(Move);
-        Sum += perftImpl(State, Limit - 1);
+        Sum += perftImpl(State, Limit - 1, Table);
         State.undoMove();
     }
 
+    if (Table != nullptr) {
+        Table->store(State.getHash(), Limit, Sum);
+    }
     return Sum;
 }
 
 } // namespace
 
+PerftResult perft(const core::State& Root, const PerftOptions& Options) {
+    PerftResult Result;
+    if (Options.Depth <= 0) {
+        Result.Nodes = 1;
+        return Result;
+    }
+
+    std::unique_ptr<PerftTable> Table;
+    if (Options.HashMB > 0) {
+        Table = std::make_unique<PerftTable>(Options.HashMB);
+    }
+
+    const auto Moves = core::MoveGenerator::generateLegalMoves<false>(Root);
+    Result.Divide.resize(Moves.size());
+
+    // Threads take the root moves one at a time, which balances the load
+    // well enough since there are far more root moves than threads.
+    std::atomic<std::size_t> Next(0);
+    const auto Work = [&]() {
+        core::State State = Root.clone();
+        while (true) {
+            const std::size_t I = Next.fetch_add(1, std::memory_order_relaxed);
+            if (I >= Moves.size()) {
+                break;
+            }
+            State.doMove(Moves[I]);
+            Result.Divide[I] = {Moves[I], perftImpl(State, Options.Depth - 1,
+                                                    Table.get())};
+            State.undoMove();
+        }
+    };
+
+    std::vector<std::thread> Threads;
+    for (std::size_t I = 1; I < Options.NumThreads; ++I) {
+        Threads.emplace_back(Work);
+    }
+    Work();
+    for (auto& Thread : Threads) {
+        Thread.join();
+    }
+
+    for (const auto& [Move, Nodes] : Result.Divide) {
+        Result.Nodes += Nodes;
+    }
+    return Result;
+}
+
+int runPerftCommand(int Argc, char** Argv) {
+    const auto Usage = []() {
+        std::cerr << "Usage: nshogi_bench perft <depth> [--threads N] "
+                     "[--hash MB] [--divide] [--sfen SFEN | --sfen-file PATH]"
+                  << std::endl;
+        return 1;
+    };
+
+    if (Argc < 1) {
+        return Usage();
+    }
+
+    PerftOptions Options;
+    bool Divide = false;
+    std::vector<std::string> Sfens;
+    try {
+        Options.Depth = std::stoi(Argv[0]);
+        for (int I = 1; I < Argc; ++I) {
+            const std::string Arg = Argv[I];
+            if (Arg == "--divide") {
+                Divide = true;
+            } else if (I + 1 >= Argc) {
+                return Usage();
+            } else if (Arg == "--threads") {
+                Options.NumThreads = std::stoul(Argv[++I]);
+            } else if (Arg == "--hash") {
+                Options.HashMB = std::stoul(Argv[++I]);
+            } else if (Arg == "--sfen") {
+                Sfens.push_back(Argv[++I]);
+            } else if (Arg == "--sfen-file") {
+                std::ifstream Ifs(Argv[++I]);
+                if (!Ifs) {
+                    std::cerr << "Failed to open " << Argv[I] << "."
+                              << std::endl;
+                    return 1;
+                }
+                std::string Line;
+                while (std::getline(Ifs, Line)) {
+                    if (!Line.empty() && Line[0] != '#') {
+                        Sfens.push_back(Line);
+                    }
+                }
+            } else {
+                return Usage();
+            }
+        }
+    } catch (const std::logic_error&) {
+        return Usage();
+    }
+
+    if (Sfens.empty()) {
+        Sfens.push_back(io::sfen::stateToSfen(
+            core::StateBuilder::getInitialState()));
+    }
+
+    uint64_t TotalNodes = 0;
+    double TotalMilliSeconds = 0;
+    for (const std::string& Sfen : Sfens) {
+        const core::State Root = io::sfen::StateBuilder::newState(Sfen);
+
+        const auto Start = std::chrono::steady_clock::now();
+        const PerftResult Result = perft(Root, Options);
+        const double MilliSeconds =
+            std::chrono::duration<double, std::milli>(
+                std::chrono::steady_clock::now() - Start)
+                .count();
+
+        std::cout << "Position: " << Sfen << std::endl;
+        if (Divide) {
+            for (const auto& [Move, Nodes] : Result.Divide) {
+                std::cout << "    " << io::sfen::move32ToSfen(Move) << ": "
+                          << Nodes << std::endl;
+            }
+        }
+        std::cout << "    +---- Depth: " << Options.Depth << std::endl;
+        std::cout << "    +---- Nodes: " << Result.Nodes << std::endl;
+        std::cout << "    +---- Elapsed: " << MilliSeconds << " (ms)"
+                  << std::endl;
+
+        TotalNodes += Result.Nodes;
+        TotalMilliSeconds += MilliSeconds;
+    }
+
+    std::cout << "Total nodes: " << TotalNodes << std::endl;
+    std::cout << "Nodes per second: "
+              << (double)TotalNodes * 1000 / TotalMilliSeconds << std::endl;
+    return 0;
+}
+
+} // namespace bench
+} // namespace nshogi
+
 void benchPerft(int Ply) {
     nshogi::core::State State = nshogi::core::StateBuilder::getInitialState();
 
-    [[maybe_unused]]
-    volatile const auto Result = perftImpl(State, Ply);
+    nshogi::bench::PerftOptions Options;
+    Options.Depth = Ply;
+    nshogi::bench::doNotOptimize(nshogi::bench::perft(State, Options).Nodes);
+}
+
+// Unlike perft(), reaches every leaf with doMove() instead of counting the
+// last ply, so that it measures doMove() and undoMove().
+uint64_t perftDoMove(nshogi::core::State& State, int Limit) {
+    if (Limit == 0) {
+        return 1;
+    }
+
+    uint64_t Sum = 0;
+    const auto Moves =
+        nshogi::core::MoveGenerator::generateLegalMoves<false>(State);
+    for (const auto& Move : Moves) {
+        State.doMove(Move);
+        Sum += perftDoMove(State, Limit - 1);
+        State.undoMove();
+    }
+    return Sum;
+}
+
+void benchPerftDoMove(nshogi::core::State& State, int Ply, uint64_t& Nodes) {
+    Nodes = perftDoMove(State, Ply);
+}
+
+void benchPerftWithOptions(const nshogi::core::State& State,
+                           const nshogi::bench::PerftOptions& Options,
+                           uint64_t& Nodes) {
+    Nodes = nshogi::bench::perft(State, Options).Nodes;
 }
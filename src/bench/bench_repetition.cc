@@ -0,0 +1,27 @@
+#include "../core/state.h"
+#include "common.hpp"
+
+#include <vector>
+
+void benchRepetitionStatus(const std::vector<nshogi::core::State>& States) {
+    for (const auto& State : States) {
+        nshogi::bench::doNotOptimize(State.getRepetitionStatus());
+    }
+}
+
+// Walks every game back to its start, checking the repetition at each ply
+// as a search does along its path, then replays it.
+void benchRepetitionStatusAlongGames(std::vector<nshogi::core::State>& States) {
+    std::vector<nshogi::core::Move32> Moves;
+    for (auto& State : States) {
+        Moves.clear();
+        while (State.getPly(false) > 0) {
+            nshogi::bench::doNotOptimize(State.getRepetitionStatus());
+            Moves.push_back(State.getLastMove());
+            State.undoMove();
+        }
+        for (auto It = Moves.rbegin(); It != Moves.rend(); ++It) {
+            State.doMove(*It);
+        }
+    }
+}
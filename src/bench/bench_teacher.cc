@@ -0,0 +1,23 @@
+#include "../core/state.h"
+#include "../core/statearena.h"
+#include "../ml/simpleteacher.h"
+#include "common.hpp"
+
+#include <vector>
+
+void benchSimpleTeacherGetState(
+    const std::vector<nshogi::ml::SimpleTeacher>& Teachers) {
+    for (const auto& Teacher : Teachers) {
+        const nshogi::core::State State = Teacher.getState();
+        nshogi::bench::doNotOptimize(State.getHash());
+    }
+}
+
+void benchSimpleTeacherGetStateWithArena(
+    const std::vector<nshogi::ml::SimpleTeacher>& Teachers,
+    nshogi::core::StateArena& Arena) {
+    for (const auto& Teacher : Teachers) {
+        const nshogi::core::State State = Teacher.getState(Arena);
+        nshogi::bench::doNotOptimize(State.getHash());
+    }
+}
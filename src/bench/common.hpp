@@ -65,13 +65,14 @@ inline void runDurationBench(const std::string& Name, Function&& F,
 }
 
 template <typename Function, typename... Arguments>
-inline void runCountBench(const std::string& Name, Function&& F, uint32_t Count,
-                          Arguments&&... Args) {
+inline BenchResult runCountBench(const std::string& Name, Function&& F,
+                                 uint32_t Count, Arguments&&... Args) {
     std::cout << "Name: " << Name << " (running)" << std::flush;
 
     auto Result = run_<Function, false, Arguments...>(Name, F, Count, std::forward<Arguments>(Args)...);
 
     print(Result);
+    return Result;
 }
 
 inline void print(const BenchResult& Result) {
@@ -0,0 +1,44 @@
+#ifndef NSHOGI_BENCH_PERFT_HPP
+#define NSHOGI_BENCH_PERFT_HPP
+
+#include "../core/state.h"
+#include "../core/types.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace nshogi {
+namespace bench {
+
+struct PerftOptions {
+    int Depth = 1;
+
+    // The root moves are split among this many threads.
+    std::size_t NumThreads = 1;
+
+    // The size of the table caching subtree counts by position hash, in
+    // megabytes. Zero disables it. Hash collisions may corrupt the count, so
+    // validate move generators without it.
+    std::size_t HashMB = 0;
+};
+
+struct PerftResult {
+    uint64_t Nodes = 0;
+
+    // The count below each root move, in the generation order.
+    std::vector<std::pair<core::Move32, uint64_t>> Divide;
+};
+
+PerftResult perft(const core::State& Root, const PerftOptions& Options);
+
+// Runs `perft <depth> [--threads N] [--hash MB] [--divide]
+// [--sfen SFEN | --sfen-file PATH]` and prints the counts. Each line of the
+// file is a start position. Returns the exit status.
+int runPerftCommand(int Argc, char** Argv);
+
+} // namespace bench
+} // namespace nshogi
+
+#endif // #ifndef NSHOGI_BENCH_PERFT_HPP
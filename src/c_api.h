@@ -350,6 +350,40 @@ typedef struct nshogi_state_api {
 } nshogi_state_api_t;
 
 typedef struct nshogi_solver_dfpn nshogi_solver_dfpn_t;
+typedef struct nshogi_solver_batched_dfpn nshogi_solver_batched_dfpn_t;
+
+typedef struct nshogi_solver_dfpn_progress {
+    uint64_t node_count;
+    uint64_t elapsed_ms;
+    double nodes_per_second;
+    uint32_t root_proof_number;
+    uint32_t root_disproof_number;
+    double tt_fill_rate;
+} nshogi_solver_dfpn_progress_t;
+
+// Filled only by a library built with SOLVER_STATS=1; `enabled` is 0 and
+// every counter is 0 otherwise. Branching factors are moves per node.
+typedef struct nshogi_solver_dfpn_statistics {
+    int enabled;
+    uint64_t node_tt_hits;
+    uint64_t node_tt_misses;
+    uint64_t node_tt_replacements;
+    uint64_t edge_tt_hits;
+    uint64_t edge_tt_misses;
+    uint64_t edge_tt_replacements;
+    uint64_t domination_hits;
+    uint64_t repetition_cutoffs;
+    uint64_t attacker_nodes;
+    uint64_t defender_nodes;
+    double attacker_branching_factor;
+    double defender_branching_factor;
+    uint64_t max_depth_reached;
+    uint64_t move_generation_ns;
+    uint64_t tt_ns;
+} nshogi_solver_dfpn_statistics_t;
+
+typedef void (*nshogi_solver_dfpn_progress_callback_t)(
+    const nshogi_solver_dfpn_progress_t* progress, void* user_data);
 
 typedef struct nshogi_solver_api {
     nshogi_move_t (*dfs)(nshogi_state_t*, int depth);
@@ -362,6 +396,43 @@ typedef struct nshogi_solver_api {
     int (*solveWithPVByDfPn)(nshogi_state_t*, nshogi_solver_dfpn_t*,
                              uint64_t max_node_count, int max_depth, int Strict,
                              nshogi_move_t* buffer, int buffer_size);
+    // Returns NULL if `num_threads` is less than one.
+    nshogi_solver_dfpn_t* (*createParallelDfPnSolver)(uint64_t memory_mb,
+                                                      int num_threads);
+
+    // Batched df-pn. `results` must have room for `num_problems` moves.
+    // Creating returns NULL if `num_workers` is less than one. Solving
+    // returns 0 on success, or -1 on failure (a negative `num_problems` or
+    // an invalid SFEN), in which case `results` is left unspecified.
+    nshogi_solver_batched_dfpn_t* (*createBatchedDfPnSolver)(uint64_t memory_mb,
+                                                             int num_workers);
+    void (*destroyBatchedDfPnSolver)(nshogi_solver_batched_dfpn_t*);
+    int (*solveBatchByDfPn)(nshogi_solver_batched_dfpn_t*,
+                            nshogi_state_t** states,
+                            const uint64_t* max_node_counts, int num_problems,
+                            int max_depth, int strict, nshogi_move_t* results);
+    int (*solveSfenBatchByDfPn)(nshogi_solver_batched_dfpn_t*,
+                                const char** sfens,
+                                const uint64_t* max_node_counts,
+                                int num_problems, int max_depth, int strict,
+                                nshogi_move_t* results);
+
+    // Snapshot of the proven and disproven positions. Return the number of
+    // saved or loaded entries, or -1 on failure.
+    int64_t (*saveDfPnTT)(const nshogi_solver_dfpn_t*, const char* path);
+    int64_t (*loadDfPnTT)(nshogi_solver_dfpn_t*, const char* path);
+
+    // Time limit (0 for none), cancellation from another thread, and
+    // periodic progress reports on the solving thread (NULL to disable).
+    void (*setDfPnTimeLimit)(nshogi_solver_dfpn_t*, uint64_t milliseconds);
+    void (*stopDfPn)(nshogi_solver_dfpn_t*);
+    void (*setDfPnProgressCallback)(
+        nshogi_solver_dfpn_t*, nshogi_solver_dfpn_progress_callback_t callback,
+        void* user_data, uint64_t interval_ms);
+
+    // Statistics of the last solve, summed over the threads.
+    void (*getDfPnStatistics)(const nshogi_solver_dfpn_t*,
+                              nshogi_solver_dfpn_statistics_t* statistics);
 } nshogi_solver_api_t;
 
 typedef struct nshogi_ml_api {
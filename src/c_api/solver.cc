@@ -12,6 +12,10 @@
 #include "../solver/dfpn.h"
 #include "../solver/dfs.h"
 
+#include <exception>
+#include <string>
+#include <vector>
+
 using namespace nshogi;
 
 namespace {
@@ -27,6 +31,17 @@ nshogi_solver_dfpn_t* solverApiCreateDfPnSolver(uint64_t MemoryMB) {
     return reinterpret_cast<nshogi_solver_dfpn_t*>(Solver);
 }
 
+nshogi_solver_dfpn_t* solverApiCreateParallelDfPnSolver(uint64_t MemoryMB,
+                                                        int NumThreads) {
+    if (NumThreads < 1) {
+        return nullptr;
+    }
+
+    auto Solver = new solver::dfpn::Solver((std::size_t)MemoryMB,
+                                           (std::size_t)NumThreads);
+    return reinterpret_cast<nshogi_solver_dfpn_t*>(Solver);
+}
+
 void solverApiDestroyDfPnSolver(nshogi_solver_dfpn_t* CSolver) {
     auto Solver = reinterpret_cast<solver::dfpn::Solver*>(CSolver);
     delete Solver;
@@ -68,6 +83,164 @@ int solverApiSolveWithPVByDfPn(nshogi_state_t* CState,
     return WriteCount;
 }
 
+nshogi_solver_batched_dfpn_t*
+solverApiCreateBatchedDfPnSolver(uint64_t MemoryMB, int NumWorkers) {
+    if (NumWorkers < 1) {
+        return nullptr;
+    }
+
+    auto Solver = new solver::dfpn::BatchedSolver((std::size_t)MemoryMB,
+                                                  (std::size_t)NumWorkers);
+    return reinterpret_cast<nshogi_solver_batched_dfpn_t*>(Solver);
+}
+
+void solverApiDestroyBatchedDfPnSolver(nshogi_solver_batched_dfpn_t* CSolver) {
+    auto Solver = reinterpret_cast<solver::dfpn::BatchedSolver*>(CSolver);
+    delete Solver;
+}
+
+int solverApiSolveBatchByDfPn(nshogi_solver_batched_dfpn_t* CSolver,
+                              nshogi_state_t** CStates,
+                              const uint64_t* MaxNodeCounts, int NumProblems,
+                              int MaxDepth, int Strict,
+                              nshogi_move_t* Results) {
+    if (NumProblems < 0) {
+        return -1;
+    }
+
+    auto Solver = reinterpret_cast<solver::dfpn::BatchedSolver*>(CSolver);
+
+    try {
+        std::vector<core::State*> States((std::size_t)NumProblems);
+        for (std::size_t I = 0; I < States.size(); ++I) {
+            States[I] = reinterpret_cast<core::State*>(CStates[I]);
+        }
+
+        const auto CheckmateMoves = Solver->solve(
+            States, std::span<const uint64_t>(MaxNodeCounts, States.size()),
+            (uint64_t)MaxDepth, (bool)Strict);
+
+        for (std::size_t I = 0; I < CheckmateMoves.size(); ++I) {
+            Results[I] = CheckmateMoves[I].value();
+        }
+    } catch (const std::exception&) {
+        return -1;
+    }
+
+    return 0;
+}
+
+int solverApiSolveSfenBatchByDfPn(nshogi_solver_batched_dfpn_t* CSolver,
+                                  const char** CSfens,
+                                  const uint64_t* MaxNodeCounts,
+                                  int NumProblems, int MaxDepth, int Strict,
+                                  nshogi_move_t* Results) {
+    if (NumProblems < 0) {
+        return -1;
+    }
+
+    auto Solver = reinterpret_cast<solver::dfpn::BatchedSolver*>(CSolver);
+
+    try {
+        std::vector<std::string> Sfens((std::size_t)NumProblems);
+        for (std::size_t I = 0; I < Sfens.size(); ++I) {
+            Sfens[I] = CSfens[I];
+        }
+
+        const auto CheckmateMoves = Solver->solve(
+            Sfens, std::span<const uint64_t>(MaxNodeCounts, Sfens.size()),
+            (uint64_t)MaxDepth, (bool)Strict);
+
+        for (std::size_t I = 0; I < CheckmateMoves.size(); ++I) {
+            Results[I] = CheckmateMoves[I].value();
+        }
+    } catch (const std::exception&) {
+        return -1;
+    }
+
+    return 0;
+}
+
+int64_t solverApiSaveDfPnTT(const nshogi_solver_dfpn_t* CSolver,
+                            const char* Path) {
+    auto Solver = reinterpret_cast<const solver::dfpn::Solver*>(CSolver);
+
+    try {
+        return (int64_t)Solver->saveTT(Path);
+    } catch (const std::exception&) {
+        return -1;
+    }
+}
+
+int64_t solverApiLoadDfPnTT(nshogi_solver_dfpn_t* CSolver, const char* Path) {
+    auto Solver = reinterpret_cast<solver::dfpn::Solver*>(CSolver);
+
+    try {
+        return (int64_t)Solver->loadTT(Path);
+    } catch (const std::exception&) {
+        return -1;
+    }
+}
+
+void solverApiSetDfPnTimeLimit(nshogi_solver_dfpn_t* CSolver,
+                               uint64_t Milliseconds) {
+    auto Solver = reinterpret_cast<solver::dfpn::Solver*>(CSolver);
+    Solver->setTimeLimit(Milliseconds);
+}
+
+void solverApiStopDfPn(nshogi_solver_dfpn_t* CSolver) {
+    auto Solver = reinterpret_cast<solver::dfpn::Solver*>(CSolver);
+    Solver->stop();
+}
+
+void solverApiSetDfPnProgressCallback(
+    nshogi_solver_dfpn_t* CSolver,
+    nshogi_solver_dfpn_progress_callback_t Callback, void* UserData,
+    uint64_t IntervalMilliseconds) {
+    auto Solver = reinterpret_cast<solver::dfpn::Solver*>(CSolver);
+
+    if (Callback == nullptr) {
+        Solver->setProgressCallback(nullptr);
+        return;
+    }
+
+    Solver->setProgressCallback(
+        [Callback, UserData](const solver::dfpn::Progress& P) {
+            nshogi_solver_dfpn_progress_t CProgress;
+            CProgress.node_count = P.NodeCount;
+            CProgress.elapsed_ms = P.ElapsedMilliseconds;
+            CProgress.nodes_per_second = P.NodesPerSecond;
+            CProgress.root_proof_number = P.RootProofNumber;
+            CProgress.root_disproof_number = P.RootDisproofNumber;
+            CProgress.tt_fill_rate = P.TTFillRate;
+            Callback(&CProgress, UserData);
+        },
+        IntervalMilliseconds);
+}
+
+void solverApiGetDfPnStatistics(const nshogi_solver_dfpn_t* CSolver,
+                                nshogi_solver_dfpn_statistics_t* CStatistics) {
+    auto Solver = reinterpret_cast<const solver::dfpn::Solver*>(CSolver);
+    const solver::dfpn::Statistics Stats = Solver->statistics();
+
+    CStatistics->enabled = Stats.Enabled ? 1 : 0;
+    CStatistics->node_tt_hits = Stats.NodeTT.Hits;
+    CStatistics->node_tt_misses = Stats.NodeTT.Misses;
+    CStatistics->node_tt_replacements = Stats.NodeTT.Replacements;
+    CStatistics->edge_tt_hits = Stats.EdgeTT.Hits;
+    CStatistics->edge_tt_misses = Stats.EdgeTT.Misses;
+    CStatistics->edge_tt_replacements = Stats.EdgeTT.Replacements;
+    CStatistics->domination_hits = Stats.DominationHits;
+    CStatistics->repetition_cutoffs = Stats.RepetitionCutoffs;
+    CStatistics->attacker_nodes = Stats.AttackerNodes;
+    CStatistics->defender_nodes = Stats.DefenderNodes;
+    CStatistics->attacker_branching_factor = Stats.attackerBranchingFactor();
+    CStatistics->defender_branching_factor = Stats.defenderBranchingFactor();
+    CStatistics->max_depth_reached = Stats.MaxDepthReached;
+    CStatistics->move_generation_ns = Stats.MoveGenerationNanoseconds;
+    CStatistics->tt_ns = Stats.TTNanoseconds;
+}
+
 } // namespace
 
 nshogi_solver_api_t* c_api::solver::getApi() {
@@ -79,6 +252,17 @@ nshogi_solver_api_t* c_api::solver::getApi() {
         A.destroyDfPnSolver = solverApiDestroyDfPnSolver;
         A.solveByDfPn = solverApiSolveByDfPn;
         A.solveWithPVByDfPn = solverApiSolveWithPVByDfPn;
+        A.createParallelDfPnSolver = solverApiCreateParallelDfPnSolver;
+        A.createBatchedDfPnSolver = solverApiCreateBatchedDfPnSolver;
+        A.destroyBatchedDfPnSolver = solverApiDestroyBatchedDfPnSolver;
+        A.solveBatchByDfPn = solverApiSolveBatchByDfPn;
+        A.solveSfenBatchByDfPn = solverApiSolveSfenBatchByDfPn;
+        A.saveDfPnTT = solverApiSaveDfPnTT;
+        A.loadDfPnTT = solverApiLoadDfPnTT;
+        A.setDfPnTimeLimit = solverApiSetDfPnTimeLimit;
+        A.stopDfPn = solverApiStopDfPn;
+        A.setDfPnProgressCallback = solverApiSetDfPnProgressCallback;
+        A.getDfPnStatistics = solverApiGetDfPnStatistics;
 
         return A;
     }();
@@ -0,0 +1,198 @@
+//
+// Copyright (c) 2025-2026 @nyashiki
+//
+// This software is licensed under the MIT license.
+// For details, see the LICENSE file in the root of this repository.
+//
+// SPDX-License-Identifier: MIT
+//
+
+#include "attackmapstate.h"
+#include "internal/bitboard.h"
+#include "internal/stateadapter.h"
+#include "internal/stateimpl.h"
+
+#include <cassert>
+#include <cstring>
+
+namespace nshogi {
+namespace core {
+
+using namespace internal;
+
+namespace {
+
+template <Color C>
+inline bitboard::Bitboard
+pieceAttackBB(PieceTypeKind Type, Square Sq,
+              const bitboard::Bitboard& OccupiedBB) noexcept {
+    return bitboard::getStepAttackBB<C>(Type, Sq) |
+           bitboard::getSliderAttackBB<C>(Type, Sq, OccupiedBB);
+}
+
+template <int Delta>
+inline void addAttackCounts(uint8_t* Counts,
+                            const bitboard::Bitboard& AttackBB) noexcept {
+    AttackBB.forEach(
+        [&](Square Sq) { Counts[Sq] = (uint8_t)(Counts[Sq] + Delta); });
+}
+
+template <int Delta>
+void addPieceAttackCounts(const StateImpl& S,
+                          uint8_t (*Counts)[NumSquares],
+                          const bitboard::Bitboard& PieceBB,
+                          const bitboard::Bitboard& OccupiedBB) noexcept {
+    PieceBB.forEach([&](Square Sq) {
+        const PieceKind Piece = S.getPosition().pieceOn(Sq);
+        const PieceTypeKind Type = getPieceType(Piece);
+
+        if (getColor(Piece) == Black) {
+            addAttackCounts<Delta>(Counts[Black],
+                                   pieceAttackBB<Black>(Type, Sq, OccupiedBB));
+        } else {
+            addAttackCounts<Delta>(Counts[White],
+                                   pieceAttackBB<White>(Type, Sq, OccupiedBB));
+        }
+    });
+}
+
+inline bitboard::Bitboard
+sliderAttackBB(Color C, PieceTypeKind Type, Square Sq,
+               const bitboard::Bitboard& OccupiedBB) noexcept {
+    return (C == Black)
+               ? bitboard::getSliderAttackBB<Black>(Type, Sq, OccupiedBB)
+               : bitboard::getSliderAttackBB<White>(Type, Sq, OccupiedBB);
+}
+
+// The sliders whose attacks a move may change, with their attacks before
+// the move. There are at most four lances, two bishops and two rooks.
+struct SliderAttacks {
+    static constexpr int Capacity = 8;
+
+    int Count;
+    Square Squares[Capacity];
+    Color Colors[Capacity];
+    PieceTypeKind Types[Capacity];
+    bitboard::Bitboard AttackBBs[Capacity];
+};
+
+inline bitboard::Bitboard changedBB(Square From, Square To) noexcept {
+    return (From == SqInvalid)
+               ? bitboard::SquareBB[To]
+               : (bitboard::SquareBB[From] | bitboard::SquareBB[To]);
+}
+
+// A move changes the contents of `From` (SqInvalid for a drop) and `To`
+// only. Apart from the pieces on these squares, the attacks that depend on
+// the occupancy are those of the sliders whose lines reach either square,
+// and a slider reaches one of them before the move if and only if it does
+// after the move. beginUpdate() is called before the move: it removes the
+// attacks of the pieces on the two squares and records the sliders with
+// their attacks. endUpdate() is called after the move: it adds the attacks
+// of the pieces now on the two squares and applies the squares each slider
+// has gained or lost.
+void beginUpdate(const StateImpl& S, uint8_t (*Counts)[NumSquares],
+                 Square From, Square To, SliderAttacks* Sliders) noexcept {
+    const bitboard::Bitboard OccupiedBB =
+        S.getBitboard<Black>() | S.getBitboard<White>();
+    const bitboard::Bitboard ChangedBB = changedBB(From, To);
+
+    const bitboard::Bitboard BishopBB =
+        S.getBitboard<PTK_Bishop>() | S.getBitboard<PTK_ProBishop>();
+    const bitboard::Bitboard RookBB =
+        S.getBitboard<PTK_Rook>() | S.getBitboard<PTK_ProRook>();
+
+    bitboard::Bitboard SliderBB = bitboard::Bitboard::ZeroBB();
+    ChangedBB.forEach([&](Square Sq) {
+        // A black lance reaching `Sq` is on the squares a white lance on
+        // `Sq` would attack, and vice versa.
+        SliderBB |= (bitboard::getLanceAttackBB<White>(Sq, OccupiedBB) &
+                     S.getBitboard<Black, PTK_Lance>()) |
+                    (bitboard::getLanceAttackBB<Black>(Sq, OccupiedBB) &
+                     S.getBitboard<White, PTK_Lance>()) |
+                    (bitboard::getBishopAttackBB<PTK_Bishop>(Sq, OccupiedBB) &
+                     BishopBB) |
+                    (bitboard::getRookAttackBB<PTK_Rook>(Sq, OccupiedBB) &
+                     RookBB);
+    });
+
+    // The step attacks of a dragon or a horse do not depend on the
+    // occupancy, so only the slider part is recorded.
+    Sliders->Count = 0;
+    ChangedBB.andNot(SliderBB).forEach([&](Square Sq) {
+        assert(Sliders->Count < SliderAttacks::Capacity);
+
+        const PieceKind Piece = S.getPosition().pieceOn(Sq);
+        const int I = Sliders->Count++;
+        Sliders->Squares[I] = Sq;
+        Sliders->Colors[I] = getColor(Piece);
+        Sliders->Types[I] = getPieceType(Piece);
+        Sliders->AttackBBs[I] =
+            sliderAttackBB(getColor(Piece), getPieceType(Piece), Sq,
+                           OccupiedBB);
+    });
+
+    addPieceAttackCounts<-1>(S, Counts, ChangedBB & OccupiedBB, OccupiedBB);
+}
+
+void endUpdate(const StateImpl& S, uint8_t (*Counts)[NumSquares],
+               Square From, Square To, const SliderAttacks& Sliders) noexcept {
+    const bitboard::Bitboard OccupiedBB =
+        S.getBitboard<Black>() | S.getBitboard<White>();
+    const bitboard::Bitboard ChangedBB = changedBB(From, To);
+
+    for (int I = 0; I < Sliders.Count; ++I) {
+        const bitboard::Bitboard& OldBB = Sliders.AttackBBs[I];
+        const bitboard::Bitboard NewBB = sliderAttackBB(
+            Sliders.Colors[I], Sliders.Types[I], Sliders.Squares[I],
+            OccupiedBB);
+
+        addAttackCounts<-1>(Counts[Sliders.Colors[I]], NewBB.andNot(OldBB));
+        addAttackCounts<1>(Counts[Sliders.Colors[I]], OldBB.andNot(NewBB));
+    }
+
+    addPieceAttackCounts<1>(S, Counts, ChangedBB & OccupiedBB, OccupiedBB);
+}
+
+} // namespace
+
+AttackMapState::AttackMapState(State&& S) noexcept
+    : WrappedState(std::move(S)) {
+    computeAttackCounts();
+}
+
+AttackMapState::~AttackMapState() {
+}
+
+void AttackMapState::doMove(Move32 Move) noexcept {
+    StateImpl* Impl = MutableStateAdapter(WrappedState).get();
+    const Square From = Move.drop() ? SqInvalid : Move.from();
+
+    SliderAttacks Sliders;
+    beginUpdate(*Impl, AttackCounts, From, Move.to(), &Sliders);
+    Impl->doMove(Move);
+    endUpdate(*Impl, AttackCounts, From, Move.to(), Sliders);
+}
+
+void AttackMapState::undoMove() {
+    StateImpl* Impl = MutableStateAdapter(WrappedState).get();
+    const Move32 Move = Impl->getLastMove();
+    const Square From = Move.drop() ? SqInvalid : Move.from();
+
+    SliderAttacks Sliders;
+    beginUpdate(*Impl, AttackCounts, From, Move.to(), &Sliders);
+    Impl->undoMove();
+    endUpdate(*Impl, AttackCounts, From, Move.to(), Sliders);
+}
+
+void AttackMapState::computeAttackCounts() noexcept {
+    std::memset(AttackCounts, 0, sizeof(AttackCounts));
+
+    const StateImpl* Impl = ImmutableStateAdapter(WrappedState).get();
+    const bitboard::Bitboard OccupiedBB =
+        Impl->getBitboard<Black>() | Impl->getBitboard<White>();
+    addPieceAttackCounts<1>(*Impl, AttackCounts, OccupiedBB, OccupiedBB);
+}
+
+} // namespace core
+} // namespace nshogi
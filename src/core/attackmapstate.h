@@ -0,0 +1,85 @@
+//
+// Copyright (c) 2025-2026 @nyashiki
+//
+// This software is licensed under the MIT license.
+// For details, see the LICENSE file in the root of this repository.
+//
+// SPDX-License-Identifier: MIT
+//
+
+#ifndef NSHOGI_CORE_ATTACKMAPSTATE_H
+#define NSHOGI_CORE_ATTACKMAPSTATE_H
+
+#include "state.h"
+#include "types.h"
+
+#include <cstdint>
+
+namespace nshogi {
+namespace core {
+
+///
+/// @class AttackMapState
+/// @brief A wrapper of `State` that keeps, for each color and square, the
+/// number of pieces of that color attacking the square.
+///
+/// The counts are updated incrementally by `doMove()` and `undoMove()`:
+/// only the moving and captured pieces and the sliders whose lines pass
+/// through the squares the move changes are looked at, so that reading the
+/// attack information of a square costs O(1) instead of scanning the
+/// attackers every time.
+///
+/// A square is attacked by a piece when the piece could move there if the
+/// square held an opponent piece, regardless of pins and of whether the
+/// square holds a piece of the same color.
+///
+/// The wrapped state is exposed only as a `const State&`, so that every move
+/// goes through `doMove()` and `undoMove()` and the counts cannot go stale.
+///
+class AttackMapState {
+ public:
+    AttackMapState(State&&) noexcept;
+    ~AttackMapState();
+
+    ///
+    /// @brief Get the wrapped state.
+    ///
+    inline const State& getState() const noexcept {
+        return WrappedState;
+    }
+
+    ///
+    /// @brief Apply a legal move and update the attack counts.
+    ///
+    void doMove(Move32 Move) noexcept;
+
+    ///
+    /// @brief Undo the last move and update the attack counts.
+    ///
+    void undoMove();
+
+    ///
+    /// @brief Get the number of pieces of color `C` attacking `Sq`.
+    ///
+    inline uint8_t getAttackCount(Color C, Square Sq) const noexcept {
+        return AttackCounts[C][Sq];
+    }
+
+    ///
+    /// @brief Get the attack counts of color `C`, indexed by `Square`.
+    ///
+    inline const uint8_t* getAttackCounts(Color C) const noexcept {
+        return AttackCounts[C];
+    }
+
+ private:
+    void computeAttackCounts() noexcept;
+
+    State WrappedState;
+    uint8_t AttackCounts[NumColors][NumSquares];
+};
+
+} // namespace core
+} // namespace nshogi
+
+#endif // #ifndef NSHOGI_CORE_ATTACKMAPSTATE_H
@@ -41,10 +41,36 @@ struct Hash {
         Value ^= ColorHash;
     }
 
+    // The value after `Move` by `C` is played, computed without playing it.
+    template <Color C>
+    HashValueType afterMove(Move32 Move) const noexcept {
+        HashValueType NewValue = Value ^ ColorHash;
+        const Square To = Move.to();
+        const PieceTypeKind Type = Move.pieceType();
+
+        if (Move.drop()) {
+            return NewValue ^ OnBoardHash[C][Type][To];
+        }
+
+        const PieceTypeKind CaptureType = Move.capturePieceType();
+        if (CaptureType != PTK_Empty) {
+            NewValue ^= OnBoardHash[~C][CaptureType][To];
+        }
+
+        NewValue ^= OnBoardHash[C][Type][Move.from()];
+        NewValue ^= OnBoardHash[C][Move.promote() ? promotePieceType(Type)
+                                                  : Type][To];
+        return NewValue;
+    }
+
     inline HashValueType getValue() const noexcept {
         return Value;
     }
 
+    inline void setValue(HashValueType V) noexcept {
+        Value = V;
+    }
+
  private:
     HashValueType Value;
 
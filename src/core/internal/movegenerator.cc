@@ -22,7 +22,19 @@ using namespace internal::bitboard;
 // the standard piece set contains two bishops and two rooks in total.
 constexpr std::size_t SliderAttackCacheSize = 4;
 
-template <Color C, bool Capture, bool WilyPromote>
+// The pieces whose moves must stay on the line to their king. Pseudo-legal
+// generation ignores the pins and leaves them to the legality check of the
+// moves actually played.
+template <Color C, bool PseudoLegal>
+inline Bitboard pinnedBB(const StateImpl& S) noexcept {
+    if constexpr (PseudoLegal) {
+        return Bitboard::ZeroBB();
+    } else {
+        return S.getDefendingOpponentSliderBB<C>();
+    }
+}
+
+template <Color C, bool Capture, bool WilyPromote, bool PseudoLegal = false>
 inline Move32*
 generateOnBoardOneStepPawnMovesImpl(const StateImpl& S,
                                     Move32* __restrict Moves,
@@ -41,7 +53,7 @@ generateOnBoardOneStepPawnMovesImpl(const StateImpl& S,
         const Square From = (C == Black) ? (To + South) : (To + North);
 
         const bool IsDefendingPiece =
-            S.getDefendingOpponentSliderBB<C>().isSet(From);
+            pinnedBB<C, PseudoLegal>(S).isSet(From);
 
         // If this pawn is defending a slider piece along a diagonal or
         // horizontal, this pawn cannot move.
@@ -82,7 +94,7 @@ generateOnBoardOneStepPawnMovesImpl(const StateImpl& S,
         const Square From = (C == Black) ? (To + South) : (To + North);
 
         const bool IsDefendingPiece =
-            S.getDefendingOpponentSliderBB<C>().isSet(From);
+            pinnedBB<C, PseudoLegal>(S).isSet(From);
 
         if (IsDefendingPiece) {
             const std::size_t KingSq = (std::size_t)S.getKingSquare<C>();
@@ -118,7 +130,7 @@ generateOnBoardOneStepPawnMovesImpl(const StateImpl& S,
     return Moves;
 }
 
-template <Color C, bool Capture>
+template <Color C, bool Capture, bool PseudoLegal = false>
 inline Move32* generateOnBoardOneStepGoldKindsMovesImpl(
     const StateImpl& S, Move32* __restrict Moves,
     const Bitboard& TargetSquares) noexcept {
@@ -128,7 +140,7 @@ inline Move32* generateOnBoardOneStepGoldKindsMovesImpl(
          S.getBitboard<PTK_ProSilver>()) &
         S.getBitboard<C>();
 
-    (FromBB & S.getDefendingOpponentSliderBB<C>()).forEach([&](Square From) {
+    (FromBB & pinnedBB<C, PseudoLegal>(S)).forEach([&](Square From) {
         const PieceTypeKind FromPieceType =
             getPieceType(S.getPosition().pieceOn(From));
 
@@ -146,7 +158,7 @@ inline Move32* generateOnBoardOneStepGoldKindsMovesImpl(
         });
     });
 
-    S.getDefendingOpponentSliderBB<C>().andNot(FromBB).forEach(
+    pinnedBB<C, PseudoLegal>(S).andNot(FromBB).forEach(
         [&](Square From) {
             const PieceTypeKind FromPieceType =
                 getPieceType(S.getPosition().pieceOn(From));
@@ -168,7 +180,7 @@ inline Move32* generateOnBoardOneStepGoldKindsMovesImpl(
     return Moves;
 }
 
-template <Color C, PieceTypeKind Type, bool Capture>
+template <Color C, PieceTypeKind Type, bool Capture, bool PseudoLegal = false>
 inline Move32*
 generateOnBoardOneStepMovesImpl(const StateImpl& S, Move32* __restrict Moves,
                                 const Bitboard& TargetSquares) noexcept {
@@ -188,7 +200,7 @@ generateOnBoardOneStepMovesImpl(const StateImpl& S, Move32* __restrict Moves,
 
     // Note: if a knight is defending a slider piece, it cannot move anywhere.
     if constexpr (Type != PTK_Knight) {
-        (FromBB & S.getDefendingOpponentSliderBB<C>())
+        (FromBB & pinnedBB<C, PseudoLegal>(S))
             .forEach([&](Square From) {
                 assert(checkRange(From));
 
@@ -200,7 +212,7 @@ generateOnBoardOneStepMovesImpl(const StateImpl& S, Move32* __restrict Moves,
 
                 // No promotion only.
                 ToBB.forEach([&](Square To) {
-                    if constexpr (Type == PTK_King) {
+                    if constexpr (Type == PTK_King && !PseudoLegal) {
                         if (S.isAttacked<C>(To, From)) {
                             return;
                         }
@@ -224,7 +236,7 @@ generateOnBoardOneStepMovesImpl(const StateImpl& S, Move32* __restrict Moves,
                                                     : (ToBB & PromotableBB[C]);
 
                     PromotableToBB.forEach([&](Square To) {
-                        if constexpr (Type == PTK_King) {
+                        if constexpr (Type == PTK_King && !PseudoLegal) {
                             if (S.isAttacked<C>(To, From)) {
                                 return;
                             }
@@ -251,7 +263,7 @@ generateOnBoardOneStepMovesImpl(const StateImpl& S, Move32* __restrict Moves,
             });
     }
 
-    S.getDefendingOpponentSliderBB<C>().andNot(FromBB).forEach(
+    pinnedBB<C, PseudoLegal>(S).andNot(FromBB).forEach(
         [&](Square From) {
             assert(checkRange(From));
 
@@ -272,7 +284,7 @@ generateOnBoardOneStepMovesImpl(const StateImpl& S, Move32* __restrict Moves,
                     });
             } else {
                 ToBB.forEach([&](Square To) {
-                    if constexpr (Type == PTK_King) {
+                    if constexpr (Type == PTK_King && !PseudoLegal) {
                         if (S.isAttacked<C>(To, From)) {
                             return;
                         }
@@ -297,7 +309,7 @@ generateOnBoardOneStepMovesImpl(const StateImpl& S, Move32* __restrict Moves,
                                                     : (ToBB & PromotableBB[C]);
 
                 PromotableToBB.forEach([&](Square To) {
-                    if constexpr (Type == PTK_King) {
+                    if constexpr (Type == PTK_King && !PseudoLegal) {
                         if (S.isAttacked<C>(To, From)) {
                             return;
                         }
@@ -336,7 +348,7 @@ generateOnBoardOneStepMovesImpl(const StateImpl& S, Move32* __restrict Moves,
     return Moves;
 }
 
-template <Color C, bool Capture, bool WilyPromote>
+template <Color C, bool Capture, bool WilyPromote, bool PseudoLegal = false>
 inline Move32*
 generateOnBoardLanceMovesImpl(const StateImpl& S, Move32* __restrict Moves,
                               const Bitboard& TargetSquares,
@@ -347,7 +359,7 @@ generateOnBoardLanceMovesImpl(const StateImpl& S, Move32* __restrict Moves,
     // or not inside the loop.
 
     const Bitboard FromBB = S.getBitboard<C, PTK_Lance>();
-    (FromBB & S.getDefendingOpponentSliderBB<C>()).forEach([&](Square From) {
+    (FromBB & pinnedBB<C, PseudoLegal>(S)).forEach([&](Square From) {
         const Bitboard ToBB = getLanceAttackBB<C>(From, OccupiedBB) &
                               TargetSquares &
                               LineBB[From][S.getKingSquare<C>()];
@@ -420,7 +432,7 @@ generateOnBoardLanceMovesImpl(const StateImpl& S, Move32* __restrict Moves,
         });
     });
 
-    S.getDefendingOpponentSliderBB<C>().andNot(FromBB).forEach(
+    pinnedBB<C, PseudoLegal>(S).andNot(FromBB).forEach(
         [&](Square From) {
             const Bitboard ToBB =
                 getLanceAttackBB<C>(From, OccupiedBB) & TargetSquares;
@@ -499,7 +511,8 @@ generateOnBoardLanceMovesImpl(const StateImpl& S, Move32* __restrict Moves,
 // and stores them through `AttackCache`; the no-capture pass that follows
 // with the same occupancy replays them instead of recomputing. Both passes
 // enumerate the pieces in the same order, so a single cursor suffices.
-template <Color C, PieceTypeKind Type, bool Capture, bool WilyPromote>
+template <Color C, PieceTypeKind Type, bool Capture, bool WilyPromote,
+          bool PseudoLegal = false>
 inline Move32* generateOnBoardBishopMovesImpl(const StateImpl& S,
                                               Move32* __restrict Moves,
                                               const Bitboard& TargetSquares,
@@ -521,7 +534,7 @@ inline Move32* generateOnBoardBishopMovesImpl(const StateImpl& S,
     };
 
     const Bitboard FromBB = S.getBitboard<C, Type>();
-    (FromBB & S.getDefendingOpponentSliderBB<C>()).forEach([&](Square From) {
+    (FromBB & pinnedBB<C, PseudoLegal>(S)).forEach([&](Square From) {
         const bool IsPromotableFrom = PromotableBB[C].isSet(From);
 
         const Bitboard ToBB = LoadAttackBB(From) & TargetSquares &
@@ -576,7 +589,7 @@ inline Move32* generateOnBoardBishopMovesImpl(const StateImpl& S,
         }
     });
 
-    S.getDefendingOpponentSliderBB<C>().andNot(FromBB).forEach(
+    pinnedBB<C, PseudoLegal>(S).andNot(FromBB).forEach(
         [&](Square From) {
             const bool IsPromotableFrom = PromotableBB[C].isSet(From);
 
@@ -637,7 +650,8 @@ inline Move32* generateOnBoardBishopMovesImpl(const StateImpl& S,
 }
 
 // See the comment on generateOnBoardBishopMovesImpl() about `AttackCache`.
-template <Color C, PieceTypeKind Type, bool Capture, bool WilyPromote>
+template <Color C, PieceTypeKind Type, bool Capture, bool WilyPromote,
+          bool PseudoLegal = false>
 inline Move32* generateOnBoardRookMovesImpl(const StateImpl& S,
                                             Move32* __restrict Moves,
                                             const Bitboard& TargetSquares,
@@ -659,7 +673,7 @@ inline Move32* generateOnBoardRookMovesImpl(const StateImpl& S,
     };
 
     const Bitboard FromBB = S.getBitboard<C, Type>();
-    (FromBB & S.getDefendingOpponentSliderBB<C>()).forEach([&](Square From) {
+    (FromBB & pinnedBB<C, PseudoLegal>(S)).forEach([&](Square From) {
         const bool IsPromotableFrom = PromotableBB[C].isSet(From);
 
         const Bitboard ToBB = LoadAttackBB(From) & TargetSquares &
@@ -714,7 +728,7 @@ inline Move32* generateOnBoardRookMovesImpl(const StateImpl& S,
         }
     });
 
-    S.getDefendingOpponentSliderBB<C>().andNot(FromBB).forEach(
+    pinnedBB<C, PseudoLegal>(S).andNot(FromBB).forEach(
         [&](Square From) {
             const bool IsPromotableFrom = PromotableBB[C].isSet(From);
 
@@ -2063,20 +2077,23 @@ inline Move32* generateOnBoardRookPromoteCheckMovesImpl(
     return Moves;
 }
 
-template <Color C, bool Capture, bool WilyPromote>
+template <Color C, bool Capture, bool WilyPromote, bool PseudoLegal = false>
 inline Move32*
 generateOnBoardOneStepMovesImpl(const StateImpl& S, Move32* __restrict Moves,
                                 const Bitboard& TargetSquares) noexcept {
-    Moves = generateOnBoardOneStepPawnMovesImpl<C, Capture, WilyPromote>(
-        S, Moves, TargetSquares);
-    Moves = generateOnBoardOneStepMovesImpl<C, PTK_Knight, Capture>(
-        S, Moves, TargetSquares);
-    Moves = generateOnBoardOneStepMovesImpl<C, PTK_Silver, Capture>(
+    Moves = generateOnBoardOneStepPawnMovesImpl<C, Capture, WilyPromote,
+                                                PseudoLegal>(S, Moves,
+                                                             TargetSquares);
+    Moves = generateOnBoardOneStepMovesImpl<C, PTK_Knight, Capture,
+                                            PseudoLegal>(S, Moves,
+                                                         TargetSquares);
+    Moves = generateOnBoardOneStepMovesImpl<C, PTK_Silver, Capture,
+                                            PseudoLegal>(S, Moves,
+                                                         TargetSquares);
+    Moves = generateOnBoardOneStepMovesImpl<C, PTK_King, Capture, PseudoLegal>(
         S, Moves, TargetSquares);
-    Moves = generateOnBoardOneStepMovesImpl<C, PTK_King, Capture>(
+    Moves = generateOnBoardOneStepGoldKindsMovesImpl<C, Capture, PseudoLegal>(
         S, Moves, TargetSquares);
-    Moves = generateOnBoardOneStepGoldKindsMovesImpl<C, Capture>(S, Moves,
-                                                                 TargetSquares);
 
     return Moves;
 }
@@ -2156,22 +2173,25 @@ inline Move32* generateOnBoardSliderCheckMovesImpl(
 // of side `C` (SliderAttackCacheSize entries). The capture pass fills it
 // and the following no-capture pass, called with the same state and
 // occupancy, consumes it.
-template <Color C, bool Capture, bool WilyPromote>
+template <Color C, bool Capture, bool WilyPromote, bool PseudoLegal = false>
 inline Move32* generateOnBoardSliderMovesImpl(const StateImpl& S,
                                               Move32* __restrict Moves,
                                               const Bitboard& TargetSquares,
                                               const Bitboard& OccupiedBB,
                                               Bitboard* AttackCache) noexcept {
-    Moves = generateOnBoardLanceMovesImpl<C, Capture, WilyPromote>(
+    Moves = generateOnBoardLanceMovesImpl<C, Capture, WilyPromote, PseudoLegal>(
         S, Moves, TargetSquares, OccupiedBB);
-    Moves =
-        generateOnBoardBishopMovesImpl<C, PTK_ProBishop, Capture, WilyPromote>(
-            S, Moves, TargetSquares, OccupiedBB, AttackCache);
-    Moves = generateOnBoardBishopMovesImpl<C, PTK_Bishop, Capture, WilyPromote>(
+    Moves = generateOnBoardBishopMovesImpl<C, PTK_ProBishop, Capture,
+                                           WilyPromote, PseudoLegal>(
+        S, Moves, TargetSquares, OccupiedBB, AttackCache);
+    Moves = generateOnBoardBishopMovesImpl<C, PTK_Bishop, Capture, WilyPromote,
+                                           PseudoLegal>(
         S, Moves, TargetSquares, OccupiedBB, AttackCache);
-    Moves = generateOnBoardRookMovesImpl<C, PTK_ProRook, Capture, WilyPromote>(
+    Moves = generateOnBoardRookMovesImpl<C, PTK_ProRook, Capture, WilyPromote,
+                                         PseudoLegal>(
         S, Moves, TargetSquares, OccupiedBB, AttackCache);
-    Moves = generateOnBoardRookMovesImpl<C, PTK_Rook, Capture, WilyPromote>(
+    Moves = generateOnBoardRookMovesImpl<C, PTK_Rook, Capture, WilyPromote,
+                                         PseudoLegal>(
         S, Moves, TargetSquares, OccupiedBB, AttackCache);
 
     return Moves;
@@ -2235,19 +2255,19 @@ inline Move32* generateLegalEvasionMovesImpl(
     return Moves;
 }
 
-template <Color C, bool CaptureOnly, bool WilyPromote>
+template <Color C, bool CaptureOnly, bool WilyPromote, bool PseudoLegal>
 inline Move32* generateLegalMovesImpl(const StateImpl& S,
                                       Move32* __restrict Moves,
                                       const Bitboard& OpponentBB,
                                       const Bitboard& OccupiedBB) noexcept {
     // Captures.
-    Moves = generateOnBoardOneStepMovesImpl<C, true, WilyPromote>(S, Moves,
-                                                                  OpponentBB);
+    Moves = generateOnBoardOneStepMovesImpl<C, true, WilyPromote, PseudoLegal>(
+        S, Moves, OpponentBB);
     assert((S.getBitboard<C, PTK_Bishop>() | S.getBitboard<C, PTK_ProBishop>() |
             S.getBitboard<C, PTK_Rook>() | S.getBitboard<C, PTK_ProRook>())
                .popCount() <= SliderAttackCacheSize);
     Bitboard SliderAttackCache[SliderAttackCacheSize];
-    Moves = generateOnBoardSliderMovesImpl<C, true, WilyPromote>(
+    Moves = generateOnBoardSliderMovesImpl<C, true, WilyPromote, PseudoLegal>(
         S, Moves, OpponentBB, OccupiedBB, SliderAttackCache);
 
     if constexpr (!CaptureOnly) {
@@ -2256,16 +2276,20 @@ inline Move32* generateLegalMovesImpl(const StateImpl& S,
         Moves = generateDroppingMovesImpl<C>(S, Moves, EmptyBB);
 
         // No captures.
-        Moves = generateOnBoardOneStepMovesImpl<C, false, WilyPromote>(S, Moves,
-                                                                       EmptyBB);
-        Moves = generateOnBoardSliderMovesImpl<C, false, WilyPromote>(
-            S, Moves, EmptyBB, OccupiedBB, SliderAttackCache);
+        Moves =
+            generateOnBoardOneStepMovesImpl<C, false, WilyPromote, PseudoLegal>(
+                S, Moves, EmptyBB);
+        Moves =
+            generateOnBoardSliderMovesImpl<C, false, WilyPromote, PseudoLegal>(
+                S, Moves, EmptyBB, OccupiedBB, SliderAttackCache);
     }
 
     return Moves;
 }
 
-template <Color C, bool CaptureOnly, bool WilyPromote>
+// A position in check gets its legal evasions even if `PseudoLegal`: there
+// are few of them, and most pseudo-legal moves would leave the king in check.
+template <Color C, bool CaptureOnly, bool WilyPromote, bool PseudoLegal = false>
 inline Move32* generateLegalMovesImpl(const StateImpl& S,
                                       Move32* Moves) noexcept {
     const Bitboard CheckerBB = S.getCheckerBB();
@@ -2279,8 +2303,9 @@ inline Move32* generateLegalMovesImpl(const StateImpl& S,
                 generateLegalEvasionMovesImpl<Black, CaptureOnly, WilyPromote>(
                     S, Moves, CheckerBB, WhiteBB, OccupiedBB);
         } else {
-            Moves = generateLegalMovesImpl<Black, CaptureOnly, WilyPromote>(
-                S, Moves, WhiteBB, OccupiedBB);
+            Moves = generateLegalMovesImpl<Black, CaptureOnly, WilyPromote,
+                                           PseudoLegal>(S, Moves, WhiteBB,
+                                                        OccupiedBB);
         }
     } else {
         if (!CheckerBB.isZero()) {
@@ -2288,15 +2313,63 @@ inline Move32* generateLegalMovesImpl(const StateImpl& S,
                 generateLegalEvasionMovesImpl<White, CaptureOnly, WilyPromote>(
                     S, Moves, CheckerBB, BlackBB, OccupiedBB);
         } else {
-            Moves = generateLegalMovesImpl<White, CaptureOnly, WilyPromote>(
-                S, Moves, BlackBB, OccupiedBB);
+            Moves = generateLegalMovesImpl<White, CaptureOnly, WilyPromote,
+                                           PseudoLegal>(S, Moves, BlackBB,
+                                                        OccupiedBB);
         }
     }
 
     return Moves;
 }
 
-template <Color C, bool WilyPromote>
+// Promotions to `TargetSquares`, which must be empty squares. A piece may
+// promote when it moves into, within or out of the promotion zone.
+template <Color C>
+inline Move32* generateOnBoardQuietPromotionMovesImpl(
+    const StateImpl& S, Move32* __restrict Moves, const Bitboard& TargetSquares,
+    const Bitboard& OccupiedBB) noexcept {
+    const Square KingSq = S.getKingSquare<C>();
+    const Bitboard PinnedBB = S.getDefendingOpponentSliderBB<C>();
+
+    const auto AddMoves = [&](Square From, PieceTypeKind Type,
+                              Bitboard ToBB) {
+        ToBB &= TargetSquares;
+        if (!PromotableBB[C].isSet(From)) {
+            ToBB &= PromotableBB[C];
+        }
+        if (PinnedBB.isSet(From)) {
+            ToBB &= LineBB[From][KingSq];
+        }
+        ToBB.forEach([&](Square To) {
+            *Moves++ = Move32::boardPromotingMove(From, To, Type);
+        });
+    };
+
+    S.getBitboard<C, PTK_Pawn>().forEach([&](Square From) {
+        AddMoves(From, PTK_Pawn, getAttackBB<C, PTK_Pawn>(From));
+    });
+    S.getBitboard<C, PTK_Lance>().forEach([&](Square From) {
+        AddMoves(From, PTK_Lance, getLanceAttackBB<C>(From, OccupiedBB));
+    });
+    S.getBitboard<C, PTK_Knight>().forEach([&](Square From) {
+        AddMoves(From, PTK_Knight, getAttackBB<C, PTK_Knight>(From));
+    });
+    S.getBitboard<C, PTK_Silver>().forEach([&](Square From) {
+        AddMoves(From, PTK_Silver, getAttackBB<C, PTK_Silver>(From));
+    });
+    S.getBitboard<C, PTK_Bishop>().forEach([&](Square From) {
+        AddMoves(From, PTK_Bishop,
+                 getBishopAttackBB<PTK_Bishop>(From, OccupiedBB));
+    });
+    S.getBitboard<C, PTK_Rook>().forEach([&](Square From) {
+        AddMoves(From, PTK_Rook, getRookAttackBB<PTK_Rook>(From, OccupiedBB));
+    });
+
+    return Moves;
+}
+
+// `QuietOnly` leaves out the checks that capture a piece.
+template <Color C, bool WilyPromote, bool QuietOnly = false>
 inline Move32* generateLegalCheckMovesImpl(const StateImpl& S,
                                            Move32* __restrict Moves) noexcept {
     const Bitboard BlackBB = S.getBitboard<Black>();
@@ -2318,9 +2391,11 @@ inline Move32* generateLegalCheckMovesImpl(const StateImpl& S,
             Moves = generateOnBoardOneStepNoPromoteCheckMovesImpl<
                 C, PTK_King, false, true, WilyPromote>(S, Moves, UnpinEmptyBB,
                                                        OccupiedBB);
-            Moves = generateOnBoardOneStepNoPromoteCheckMovesImpl<
-                C, PTK_King, true, true, WilyPromote>(S, Moves, UnpinCaptureBB,
-                                                      OccupiedBB);
+            if constexpr (!QuietOnly) {
+                Moves = generateOnBoardOneStepNoPromoteCheckMovesImpl<
+                    C, PTK_King, true, true, WilyPromote>(
+                    S, Moves, UnpinCaptureBB, OccupiedBB);
+            }
         }
 
         return Moves;
@@ -2357,38 +2432,48 @@ inline Move32* generateLegalCheckMovesImpl(const StateImpl& S,
                 Moves = generateOnBoardOneStepNoPromoteCheckMovesImpl<
                     C, PTK_King, false, true, WilyPromote>(
                     S, Moves, UnpinEmptyBB, OccupiedBB);
-                Moves = generateOnBoardOneStepNoPromoteCheckMovesImpl<
-                    C, PTK_King, true, true, WilyPromote>(
-                    S, Moves, UnpinCaptureBB, OccupiedBB);
+                if constexpr (!QuietOnly) {
+                    Moves = generateOnBoardOneStepNoPromoteCheckMovesImpl<
+                        C, PTK_King, true, true, WilyPromote>(
+                        S, Moves, UnpinCaptureBB, OccupiedBB);
+                }
             }
 
             Moves = generateOnBoardOneStepCheckMovesImpl<C, false, true,
                                                          WilyPromote, true>(
                 S, Moves, CheckerMyKingBetweenBB, PinnedBB);
-            Moves = generateOnBoardOneStepCheckMovesImpl<C, true, true,
-                                                         WilyPromote, true>(
-                S, Moves, CheckerBB, PinnedBB);
+            if constexpr (!QuietOnly) {
+                Moves = generateOnBoardOneStepCheckMovesImpl<C, true, true,
+                                                             WilyPromote, true>(
+                    S, Moves, CheckerBB, PinnedBB);
+            }
 
             Moves = generateOnBoardSliderCheckMovesImpl<C, false, true,
                                                         WilyPromote>(
                 S, Moves, CheckerMyKingBetweenBB, OccupiedBB, PinnedBB);
-            Moves =
-                generateOnBoardSliderCheckMovesImpl<C, true, true, WilyPromote>(
+            if constexpr (!QuietOnly) {
+                Moves = generateOnBoardSliderCheckMovesImpl<C, true, true,
+                                                            WilyPromote>(
                     S, Moves, CheckerBB, OccupiedBB, PinnedBB);
+            }
         }
 
         Moves =
             generateOnBoardOneStepCheckMovesImpl<C, false, false, WilyPromote>(
                 S, Moves, CheckerMyKingBetweenBB, NoPinnedBB);
-        Moves =
-            generateOnBoardOneStepCheckMovesImpl<C, true, false, WilyPromote>(
+        if constexpr (!QuietOnly) {
+            Moves = generateOnBoardOneStepCheckMovesImpl<C, true, false,
+                                                         WilyPromote>(
                 S, Moves, CheckerBB, NoPinnedBB);
+        }
         Moves =
             generateOnBoardSliderCheckMovesImpl<C, false, false, WilyPromote>(
                 S, Moves, CheckerMyKingBetweenBB, OccupiedBB, NoPinnedBB);
-        Moves =
-            generateOnBoardSliderCheckMovesImpl<C, true, false, WilyPromote>(
+        if constexpr (!QuietOnly) {
+            Moves = generateOnBoardSliderCheckMovesImpl<C, true, false,
+                                                        WilyPromote>(
                 S, Moves, CheckerBB, OccupiedBB, NoPinnedBB);
+        }
     } else {
         if (St != 0) {
             Moves = generateDroppingStepCheckMovesImpl<C>(S, Moves, EmptyBB);
@@ -2400,29 +2485,37 @@ inline Move32* generateLegalCheckMovesImpl(const StateImpl& S,
             Moves = generateOnBoardOneStepCheckMovesImpl<C, false, true,
                                                          WilyPromote>(
                 S, Moves, EmptyBB, PinnedBB);
-            Moves = generateOnBoardOneStepCheckMovesImpl<C, true, true,
-                                                         WilyPromote>(
-                S, Moves, S.getBitboard<~C>(), PinnedBB);
+            if constexpr (!QuietOnly) {
+                Moves = generateOnBoardOneStepCheckMovesImpl<C, true, true,
+                                                             WilyPromote>(
+                    S, Moves, S.getBitboard<~C>(), PinnedBB);
+            }
             Moves = generateOnBoardSliderCheckMovesImpl<C, false, true,
                                                         WilyPromote>(
                 S, Moves, EmptyBB, OccupiedBB, PinnedBB);
-            Moves =
-                generateOnBoardSliderCheckMovesImpl<C, true, true, WilyPromote>(
+            if constexpr (!QuietOnly) {
+                Moves = generateOnBoardSliderCheckMovesImpl<C, true, true,
+                                                            WilyPromote>(
                     S, Moves, S.getBitboard<~C>(), OccupiedBB, PinnedBB);
+            }
         }
 
         Moves =
             generateOnBoardOneStepCheckMovesImpl<C, false, false, WilyPromote>(
                 S, Moves, EmptyBB, NoPinnedBB);
-        Moves =
-            generateOnBoardOneStepCheckMovesImpl<C, true, false, WilyPromote>(
+        if constexpr (!QuietOnly) {
+            Moves = generateOnBoardOneStepCheckMovesImpl<C, true, false,
+                                                         WilyPromote>(
                 S, Moves, S.getBitboard<~C>(), NoPinnedBB);
+        }
         Moves =
             generateOnBoardSliderCheckMovesImpl<C, false, false, WilyPromote>(
                 S, Moves, EmptyBB, OccupiedBB, NoPinnedBB);
-        Moves =
-            generateOnBoardSliderCheckMovesImpl<C, true, false, WilyPromote>(
+        if constexpr (!QuietOnly) {
+            Moves = generateOnBoardSliderCheckMovesImpl<C, true, false,
+                                                        WilyPromote>(
                 S, Moves, S.getBitboard<~C>(), OccupiedBB, NoPinnedBB);
+        }
     }
 
     return Moves;
@@ -2438,6 +2531,73 @@ MoveGeneratorInternal::generateLegalMoves(const StateImpl& S) noexcept {
     return List;
 }
 
+template <Color C, bool WilyPromote>
+MoveList
+MoveGeneratorInternal::generatePseudoLegalMoves(const StateImpl& S) noexcept {
+    MoveList List;
+    List.Tail =
+        generateLegalMovesImpl<C, false, WilyPromote, true>(S, List.Tail);
+    return List;
+}
+
+template <Color C, bool WilyPromote>
+Move32* MoveGeneratorInternal::generatePseudoLegalCaptureMoves(
+    const StateImpl& S, Move32* Moves) noexcept {
+    assert(S.getCheckerBB().isZero());
+
+    const Bitboard OpponentBB = S.getBitboard<~C>();
+    const Bitboard OccupiedBB = S.getBitboard<C>() | OpponentBB;
+    return generateLegalMovesImpl<C, true, WilyPromote, true>(
+        S, Moves, OpponentBB, OccupiedBB);
+}
+
+template <Color C, bool WilyPromote>
+Move32* MoveGeneratorInternal::generatePseudoLegalQuietBoardMoves(
+    const StateImpl& S, Move32* Moves) noexcept {
+    assert(S.getCheckerBB().isZero());
+
+    const Bitboard OccupiedBB = S.getBitboard<Black>() | S.getBitboard<White>();
+    const Bitboard EmptyBB = ~OccupiedBB;
+
+    // The no-capture slider pass replays the attacks stored by a capture
+    // pass. A capture pass with no target squares stores them and generates
+    // nothing.
+    assert((S.getBitboard<C, PTK_Bishop>() | S.getBitboard<C, PTK_ProBishop>() |
+            S.getBitboard<C, PTK_Rook>() | S.getBitboard<C, PTK_ProRook>())
+               .popCount() <= SliderAttackCacheSize);
+    Bitboard SliderAttackCache[SliderAttackCacheSize];
+    generateOnBoardSliderMovesImpl<C, true, WilyPromote, true>(
+        S, Moves, Bitboard::ZeroBB(), OccupiedBB, SliderAttackCache);
+
+    Moves = generateOnBoardOneStepMovesImpl<C, false, WilyPromote, true>(
+        S, Moves, EmptyBB);
+    return generateOnBoardSliderMovesImpl<C, false, WilyPromote, true>(
+        S, Moves, EmptyBB, OccupiedBB, SliderAttackCache);
+}
+
+template <Color C>
+Move32* MoveGeneratorInternal::generateDroppingMoves(const StateImpl& S,
+                                                     Move32* Moves) noexcept {
+    assert(S.getCheckerBB().isZero());
+
+    return generateDroppingMovesImpl<C>(
+        S, Moves, ~(S.getBitboard<Black>() | S.getBitboard<White>()));
+}
+
+template <Color C, bool WilyPromote>
+Move32*
+MoveGeneratorInternal::generateLegalEvasionMoves(const StateImpl& S,
+                                                 Move32* Moves) noexcept {
+    const Bitboard CheckerBB = S.getCheckerBB();
+    const Bitboard OpBB = S.getBitboard<~C>();
+    const Bitboard OccupiedBB = S.getBitboard<C>() | OpBB;
+
+    assert(!CheckerBB.isZero());
+
+    return generateLegalEvasionMovesImpl<C, false, WilyPromote>(
+        S, Moves, CheckerBB, OpBB, OccupiedBB);
+}
+
 template <Color C, bool WilyPromote>
 MoveList
 MoveGeneratorInternal::generateLegalCheckMoves(const StateImpl& S) noexcept {
@@ -2446,6 +2606,15 @@ MoveGeneratorInternal::generateLegalCheckMoves(const StateImpl& S) noexcept {
     return List;
 }
 
+template <Color C, bool WilyPromote>
+MoveList MoveGeneratorInternal::generateLegalQuietCheckMoves(
+    const StateImpl& S) noexcept {
+    MoveList List;
+    List.Tail =
+        generateLegalCheckMovesImpl<C, WilyPromote, true>(S, List.Tail);
+    return List;
+}
+
 template <Color C, bool WilyPromote>
 MoveList
 MoveGeneratorInternal::generateLegalCaptureMoves(const StateImpl& S) noexcept {
@@ -2454,6 +2623,57 @@ MoveGeneratorInternal::generateLegalCaptureMoves(const StateImpl& S) noexcept {
     return List;
 }
 
+template <Color C, bool WilyPromote>
+MoveList
+MoveGeneratorInternal::generateLegalCaptureMovesOn(const StateImpl& S,
+                                                   Square To) noexcept {
+    MoveList List;
+
+    const Bitboard OpponentBB = S.getBitboard<~C>();
+    const Bitboard TargetBB = OpponentBB & SquareBB[To];
+    if (TargetBB.isZero()) {
+        return List;
+    }
+
+    const Bitboard OccupiedBB = S.getBitboard<C>() | OpponentBB;
+    const Bitboard CheckerBB = S.getCheckerBB();
+    if (CheckerBB.isZero()) {
+        List.Tail = generateLegalMovesImpl<C, true, WilyPromote, false>(
+            S, List.Tail, TargetBB, OccupiedBB);
+    } else if (CheckerBB == TargetBB) {
+        // Any piece may capture the only checker.
+        List.Tail = generateLegalEvasionMovesImpl<C, true, WilyPromote>(
+            S, List.Tail, CheckerBB, TargetBB, OccupiedBB);
+    } else {
+        // Only the king may capture something else.
+        List.Tail = generateOnBoardOneStepMovesImpl<C, PTK_King, true>(
+            S, List.Tail, TargetBB);
+    }
+
+    return List;
+}
+
+template <Color C>
+MoveList MoveGeneratorInternal::generateLegalQuietPromotionMoves(
+    const StateImpl& S) noexcept {
+    MoveList List;
+
+    const Bitboard OccupiedBB = S.getBitboard<Black>() | S.getBitboard<White>();
+    const Bitboard CheckerBB = S.getCheckerBB();
+    if (CheckerBB.isZero()) {
+        List.Tail = generateOnBoardQuietPromotionMovesImpl<C>(
+            S, List.Tail, ~OccupiedBB, OccupiedBB);
+    } else if (CheckerBB.popCount() == 1) {
+        // The king cannot promote, so only blocking the check remains.
+        const Bitboard BlockBB =
+            getBetweenBB(S.getKingSquare<C>(), CheckerBB.getOne());
+        List.Tail = generateOnBoardQuietPromotionMovesImpl<C>(
+            S, List.Tail, BlockBB, OccupiedBB);
+    }
+
+    return List;
+}
+
 template <Color C, bool WilyPromote>
 MoveList
 MoveGeneratorInternal::generateLegalEvasionMoves(const StateImpl& S) noexcept {
@@ -2693,6 +2913,17 @@ template MoveList MoveGeneratorInternal::generateLegalMoves<White, false>(
 template MoveList MoveGeneratorInternal::generateLegalMoves<White, true>(
     const StateImpl& S) noexcept;
 
+template MoveList
+MoveGeneratorInternal::generatePseudoLegalMoves<Black, false>(
+    const StateImpl& S) noexcept;
+template MoveList MoveGeneratorInternal::generatePseudoLegalMoves<Black, true>(
+    const StateImpl& S) noexcept;
+template MoveList
+MoveGeneratorInternal::generatePseudoLegalMoves<White, false>(
+    const StateImpl& S) noexcept;
+template MoveList MoveGeneratorInternal::generatePseudoLegalMoves<White, true>(
+    const StateImpl& S) noexcept;
+
 template MoveList MoveGeneratorInternal::generateLegalCheckMoves<Black, false>(
     const StateImpl& S) noexcept;
 template MoveList MoveGeneratorInternal::generateLegalCheckMoves<Black, true>(
@@ -2724,6 +2955,79 @@ MoveGeneratorInternal::generateLegalEvasionMoves<White, false>(
 template MoveList MoveGeneratorInternal::generateLegalEvasionMoves<White, true>(
     const StateImpl& S) noexcept;
 
+template MoveList
+MoveGeneratorInternal::generateLegalQuietCheckMoves<Black, false>(
+    const StateImpl& S) noexcept;
+template MoveList
+MoveGeneratorInternal::generateLegalQuietCheckMoves<Black, true>(
+    const StateImpl& S) noexcept;
+template MoveList
+MoveGeneratorInternal::generateLegalQuietCheckMoves<White, false>(
+    const StateImpl& S) noexcept;
+template MoveList
+MoveGeneratorInternal::generateLegalQuietCheckMoves<White, true>(
+    const StateImpl& S) noexcept;
+
+template MoveList
+MoveGeneratorInternal::generateLegalCaptureMovesOn<Black, false>(
+    const StateImpl& S, Square To) noexcept;
+template MoveList
+MoveGeneratorInternal::generateLegalCaptureMovesOn<Black, true>(
+    const StateImpl& S, Square To) noexcept;
+template MoveList
+MoveGeneratorInternal::generateLegalCaptureMovesOn<White, false>(
+    const StateImpl& S, Square To) noexcept;
+template MoveList
+MoveGeneratorInternal::generateLegalCaptureMovesOn<White, true>(
+    const StateImpl& S, Square To) noexcept;
+
+template MoveList
+MoveGeneratorInternal::generateLegalQuietPromotionMoves<Black>(
+    const StateImpl& S) noexcept;
+template MoveList
+MoveGeneratorInternal::generateLegalQuietPromotionMoves<White>(
+    const StateImpl& S) noexcept;
+
+template Move32*
+MoveGeneratorInternal::generatePseudoLegalCaptureMoves<Black, false>(
+    const StateImpl& S, Move32* Moves) noexcept;
+template Move32*
+MoveGeneratorInternal::generatePseudoLegalCaptureMoves<Black, true>(
+    const StateImpl& S, Move32* Moves) noexcept;
+template Move32*
+MoveGeneratorInternal::generatePseudoLegalCaptureMoves<White, false>(
+    const StateImpl& S, Move32* Moves) noexcept;
+template Move32*
+MoveGeneratorInternal::generatePseudoLegalCaptureMoves<White, true>(
+    const StateImpl& S, Move32* Moves) noexcept;
+
+template Move32*
+MoveGeneratorInternal::generatePseudoLegalQuietBoardMoves<Black, false>(
+    const StateImpl& S, Move32* Moves) noexcept;
+template Move32*
+MoveGeneratorInternal::generatePseudoLegalQuietBoardMoves<Black, true>(
+    const StateImpl& S, Move32* Moves) noexcept;
+template Move32*
+MoveGeneratorInternal::generatePseudoLegalQuietBoardMoves<White, false>(
+    const StateImpl& S, Move32* Moves) noexcept;
+template Move32*
+MoveGeneratorInternal::generatePseudoLegalQuietBoardMoves<White, true>(
+    const StateImpl& S, Move32* Moves) noexcept;
+
+template Move32* MoveGeneratorInternal::generateLegalEvasionMoves<Black, false>(
+    const StateImpl& S, Move32* Moves) noexcept;
+template Move32* MoveGeneratorInternal::generateLegalEvasionMoves<Black, true>(
+    const StateImpl& S, Move32* Moves) noexcept;
+template Move32* MoveGeneratorInternal::generateLegalEvasionMoves<White, false>(
+    const StateImpl& S, Move32* Moves) noexcept;
+template Move32* MoveGeneratorInternal::generateLegalEvasionMoves<White, true>(
+    const StateImpl& S, Move32* Moves) noexcept;
+
+template Move32* MoveGeneratorInternal::generateDroppingMoves<Black>(
+    const StateImpl& S, Move32* Moves) noexcept;
+template Move32* MoveGeneratorInternal::generateDroppingMoves<White>(
+    const StateImpl& S, Move32* Moves) noexcept;
+
 template Move32 MoveGeneratorInternal::generateLegalSmallestMove<Black>(
     const internal::StateImpl& S, Square To) noexcept;
 template Move32 MoveGeneratorInternal::generateLegalSmallestMove<White>(
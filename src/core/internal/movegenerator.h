@@ -24,6 +24,10 @@ class MoveGeneratorInternal {
     template <Color C, bool WilyPromote = true>
     static MoveList generateLegalMoves(const internal::StateImpl& S) noexcept;
 
+    template <Color C, bool WilyPromote = true>
+    static MoveList
+    generatePseudoLegalMoves(const internal::StateImpl& S) noexcept;
+
     template <Color C, bool WilyPromote = true>
     static MoveList
     generateLegalCheckMoves(const internal::StateImpl& S) noexcept;
@@ -32,10 +36,51 @@ class MoveGeneratorInternal {
     static MoveList
     generateLegalEvasionMoves(const internal::StateImpl& S) noexcept;
 
+    // Checks that capture nothing, drops included.
+    template <Color C, bool WilyPromote = true>
+    static MoveList
+    generateLegalQuietCheckMoves(const internal::StateImpl& S) noexcept;
+
     template <Color C, bool WilyPromote = true>
     static MoveList
     generateLegalCaptureMoves(const internal::StateImpl& S) noexcept;
 
+    // Captures of the piece on `To`, if any.
+    template <Color C, bool WilyPromote = true>
+    static MoveList
+    generateLegalCaptureMovesOn(const internal::StateImpl& S,
+                                Square To) noexcept;
+
+    // Promotions that capture nothing. WilyPromote only drops
+    // non-promotions, so it does not apply here.
+    template <Color C>
+    static MoveList
+    generateLegalQuietPromotionMoves(const internal::StateImpl& S) noexcept;
+
+    // The generators below write into `Moves` and return the new end, so
+    // that MovePicker can generate its stages lazily into one buffer. All
+    // but the evasion generator require the side to move not to be in check.
+
+    template <Color C, bool WilyPromote = true>
+    static Move32*
+    generatePseudoLegalCaptureMoves(const internal::StateImpl& S,
+                                    Move32* Moves) noexcept;
+
+    // Board moves that capture nothing, promotions included.
+    template <Color C, bool WilyPromote = true>
+    static Move32*
+    generatePseudoLegalQuietBoardMoves(const internal::StateImpl& S,
+                                       Move32* Moves) noexcept;
+
+    // Drops are always legal.
+    template <Color C>
+    static Move32* generateDroppingMoves(const internal::StateImpl& S,
+                                         Move32* Moves) noexcept;
+
+    template <Color C, bool WilyPromote = true>
+    static Move32* generateLegalEvasionMoves(const internal::StateImpl& S,
+                                             Move32* Moves) noexcept;
+
     template <Color C>
     static Move32 generateLegalSmallestMove(const internal::StateImpl& S,
                                             Square To) noexcept;
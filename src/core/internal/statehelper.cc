@@ -19,25 +19,35 @@ namespace core {
 namespace internal {
 
 StateHelper::StateHelper(const Position& Pos)
-    : InitialPosition(Pos)
-    , Ply(0) {
+    : Ply(0)
+    , RestoredPly(0)
+    , InitialPosition(Pos) {
     SHelper.reserve(DefaultReserveSize);
     SHelper.emplace_back();
     assert(SHelper.size() == 1);
+    std::memset(BoardHashCounts, 0, sizeof(BoardHashCounts));
 }
 
 StateHelper::StateHelper(const Position& Pos, uint16_t PlyOffset)
-    : InitialPosition(Pos, PlyOffset)
-    , Ply(0) {
-    SHelper.reserve(DefaultReserveSize);
+    : StateHelper(Pos, PlyOffset, DefaultReserveSize) {
+}
+
+StateHelper::StateHelper(const Position& Pos, uint16_t PlyOffset,
+                         std::size_t ReserveSize)
+    : Ply(0)
+    , RestoredPly(0)
+    , InitialPosition(Pos, PlyOffset) {
+    SHelper.reserve(ReserveSize);
     SHelper.emplace_back();
     assert(SHelper.size() == 1);
+    std::memset(BoardHashCounts, 0, sizeof(BoardHashCounts));
 }
 
 StateHelper::StateHelper(StateHelper&& Helper) noexcept
-    : InitialPosition(Helper.InitialPosition)
-    , Ply(Helper.Ply)
-    , SHelper(std::move(Helper.SHelper)) {
+    : Ply(Helper.Ply)
+    , RestoredPly(Helper.RestoredPly)
+    , SHelper(std::move(Helper.SHelper))
+    , InitialPosition(Helper.InitialPosition) {
 
     std::memcpy(static_cast<void*>(ColorBB),
                 static_cast<const void*>(Helper.ColorBB),
@@ -50,14 +60,15 @@ StateHelper::StateHelper(StateHelper&& Helper) noexcept
     std::memcpy(static_cast<void*>(KingSquare),
                 static_cast<const void*>(Helper.KingSquare),
                 NumColors * sizeof(Square));
+
+    std::memcpy(BoardHashCounts, Helper.BoardHashCounts,
+                sizeof(BoardHashCounts));
 }
 
 StateHelper::~StateHelper() {
 }
 
-void StateHelper::proceedOneStep(Move32 Move, uint64_t BoardHash,
-                                 Stands BlackStand,
-                                 Stands WhiteStand) noexcept {
+void StateHelper::proceedOneStep(Move32 Move, uint64_t BoardHash) noexcept {
     SHelper.emplace_back();
 
     assert(Ply < SHelper.size());
@@ -65,23 +76,35 @@ void StateHelper::proceedOneStep(Move32 Move, uint64_t BoardHash,
     // Record the move and increment Ply.
     SHelper[Ply].Move = Move;
     SHelper[Ply].BoardHash = BoardHash;
-    SHelper[Ply].EachStand[Black] = BlackStand;
-    SHelper[Ply].EachStand[White] = WhiteStand;
+
+    incrementBoardHashCount(getBoardHashBucket(BoardHash, Ply));
 
     Ply++;
 }
 
 Move32 StateHelper::goBackOneStep() {
-    assert(Ply > 0);
+    assert(Ply > RestoredPly);
 
     SHelper.pop_back();
 
     --Ply;
     const Move32 PrevMove = SHelper[Ply].Move;
 
+    const std::size_t Bucket = getBoardHashBucket(SHelper[Ply].BoardHash, Ply);
+    assert(getBoardHashCount(Bucket) > 0);
+    decrementBoardHashCount(Bucket);
+
     return PrevMove;
 }
 
+void StateHelper::clearHistory() noexcept {
+    std::memset(BoardHashCounts, 0, sizeof(BoardHashCounts));
+
+    Ply = 0;
+    RestoredPly = 0;
+    SHelper.resize(1);
+}
+
 } // namespace internal
 } // namespace core
 } // namespace nshogi
@@ -24,27 +24,33 @@ namespace nshogi {
 namespace core {
 namespace internal {
 
-struct StepHelper {
+// One record per ply, written on every doMove(). It is kept to one cache
+// line: the pinners are recomputed by the SEE, their only user, and the
+// stands of a past ply are recovered by taking back the moves when the
+// repetition detection needs them.
+struct alignas(64) StepHelper {
     StepHelper()
         : Move(Move32::MoveNone())
         , IsLastMoveDroppingAPawn(false) {
     }
 
     bitboard::Bitboard DefendingOpponentSliderBB[NumColors];
-    bitboard::Bitboard Pinners[NumColors];
     bitboard::Bitboard CheckerBB;
 
     uint64_t BoardHash;
     Move32 Move;
-    Stands EachStand[NumColors];
     uint8_t ContinuousCheckCounts[NumColors];
     bool IsLastMoveDroppingAPawn;
 };
 
+static_assert(sizeof(StepHelper) == 64);
+
 struct StateHelper {
  public:
     StateHelper(const Position& Pos);
     StateHelper(const Position& Pos, uint16_t PlyOffset);
+    StateHelper(const Position& Pos, uint16_t PlyOffset,
+                std::size_t ReserveSize);
 
     StateHelper(const StateHelper&) = delete;
     StateHelper& operator=(const StateHelper&) = delete;
@@ -54,10 +60,18 @@ struct StateHelper {
 
     ~StateHelper();
 
-    void proceedOneStep(Move32 Move, uint64_t BoardHash, Stands BlackStand,
-                        Stands WhiteStand) noexcept;
+    void proceedOneStep(Move32 Move, uint64_t BoardHash) noexcept;
     Move32 goBackOneStep();
 
+    // Drop the history, keeping the current step helper and the capacity.
+    void clearHistory() noexcept;
+
+    // False if no position in the history with the current side to move
+    // has `BoardHash`. True means the history has to be scanned.
+    inline bool mayRepeat(uint64_t BoardHash) const noexcept {
+        return getBoardHashCount(getBoardHashBucket(BoardHash, Ply)) != 0;
+    }
+
     inline const StepHelper& getCurrentStepHelper() const noexcept {
         return getStepHelper(Ply);
     }
@@ -80,10 +94,16 @@ struct StateHelper {
 
  private:
     constexpr static std::size_t DefaultReserveSize = 1024;
+    constexpr static std::size_t SnapshotReserveSize = 64;
 
-    const Position InitialPosition;
+    // The members up to `SHelper` are the ones read on every move
+    // generation, and StateImpl::prefetch() fetches only them.
     uint16_t Ply;
 
+    // The steps before it come from a snapshot and hold only their move
+    // and board hash, so they cannot be gone back to.
+    uint16_t RestoredPly;
+
     // Incrementally updatable variables.
     bitboard::Bitboard ColorBB[NumColors];
     bitboard::Bitboard TypeBB[NumPieceType];
@@ -92,6 +112,42 @@ struct StateHelper {
     // Store them since they are computationally heavy.
     std::vector<StepHelper> SHelper;
 
+    // Not const only because StateImpl::restore() replaces it.
+    Position InitialPosition;
+
+    // How many positions in the history have a board hash in each bucket,
+    // so that the repetition detection skips the scan on a miss. A count
+    // that reaches its maximum sticks there, which only costs a scan.
+    // Every construction and clone copies the counts, so they are packed
+    // two bits each, and a position only ever repeats one an even number
+    // of plies back, so the buckets are split by the parity of the ply.
+    constexpr static std::size_t BoardHashCountSize = 1024;
+    constexpr static uint64_t BoardHashCountMask = BoardHashCountSize - 1;
+    constexpr static uint8_t BoardHashCountMax = 3;
+    uint8_t BoardHashCounts[BoardHashCountSize / 4];
+
+    static inline std::size_t getBoardHashBucket(uint64_t BoardHash,
+                                                 uint16_t AtPly) noexcept {
+        return (std::size_t)(((BoardHash << 1) | (AtPly & 1)) &
+                             BoardHashCountMask);
+    }
+
+    inline uint8_t getBoardHashCount(std::size_t Bucket) const noexcept {
+        return (BoardHashCounts[Bucket >> 2] >> ((Bucket & 3) * 2)) & 3;
+    }
+
+    inline void incrementBoardHashCount(std::size_t Bucket) noexcept {
+        if (getBoardHashCount(Bucket) != BoardHashCountMax) {
+            BoardHashCounts[Bucket >> 2] += (uint8_t)(1 << ((Bucket & 3) * 2));
+        }
+    }
+
+    inline void decrementBoardHashCount(std::size_t Bucket) noexcept {
+        if (getBoardHashCount(Bucket) != BoardHashCountMax) {
+            BoardHashCounts[Bucket >> 2] -= (uint8_t)(1 << ((Bucket & 3) * 2));
+        }
+    }
+
     friend class StateImpl;
 };
 
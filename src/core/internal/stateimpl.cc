@@ -13,6 +13,7 @@
 #include "statehelper.h"
 #include "utils.h"
 
+#include <algorithm>
 #include <cassert>
 #include <cstring>
 #include <utility>
@@ -50,6 +51,25 @@ bool canDeclareImpl(const StateImpl& S) noexcept {
     return false;
 }
 
+// The layout of `StateSnapshot::Data`. The history is kept oldest first.
+struct SnapshotLayout {
+    StepHelper CurrentStepHelper;
+    bitboard::Bitboard ColorBB[NumColors];
+    bitboard::Bitboard TypeBB[NumPieceType];
+    uint64_t HashValue;
+    uint64_t HistoryBoardHashes[StateSnapshot::MaxHistoryLength];
+    Move32 HistoryMoves[StateSnapshot::MaxHistoryLength];
+    Stands EachStands[NumColors];
+    Square KingSquare[NumColors];
+    uint16_t Ply;
+    uint16_t HistoryLength;
+    Color SideToMove;
+    PieceKind OnBoard[NumSquares];
+};
+
+static_assert(sizeof(SnapshotLayout) <= StateSnapshot::Size);
+static_assert(alignof(SnapshotLayout) <= alignof(StateSnapshot));
+
 } // namespace
 
 StateImpl::StateImpl(const Position& P)
@@ -67,6 +87,12 @@ StateImpl::StateImpl(const Position& CurrentP, const Position& InitP)
     , Helper(InitP) {
 }
 
+StateImpl::StateImpl(const StateSnapshot& Snapshot)
+    : Pos()
+    , Helper(Pos, 0, StateHelper::SnapshotReserveSize) {
+    restore(Snapshot);
+}
+
 StateImpl::StateImpl(StateImpl&& S) noexcept
     : Pos(S.Pos)
     , Helper(std::move(S.Helper))
@@ -80,6 +106,7 @@ StateImpl StateImpl::clone() const {
 
     // Clone helper.
     S.Helper.Ply = Helper.Ply;
+    S.Helper.RestoredPly = Helper.RestoredPly;
 
     std::memcpy(reinterpret_cast<char*>(S.Helper.ColorBB),
                 reinterpret_cast<const char*>(Helper.ColorBB),
@@ -98,14 +125,117 @@ StateImpl StateImpl::clone() const {
                 reinterpret_cast<const char*>(Helper.SHelper.data()),
                 Helper.SHelper.size() * sizeof(StepHelper));
 
+    std::memcpy(S.Helper.BoardHashCounts, Helper.BoardHashCounts,
+                sizeof(Helper.BoardHashCounts));
+
     return S;
 }
 
+void StateImpl::reset(const Position& P, uint16_t Ply) noexcept {
+    std::memcpy(static_cast<void*>(&Pos), static_cast<const void*>(&P),
+                sizeof(Position));
+    Pos.PlyOffset = Ply;
+    std::memcpy(static_cast<void*>(&Helper.InitialPosition),
+                static_cast<const void*>(&Pos), sizeof(Position));
+    Helper.clearHistory();
+}
+
+void StateImpl::snapshot(StateSnapshot* Snapshot,
+                         uint16_t HistoryLength) const noexcept {
+    SnapshotLayout* Layout = reinterpret_cast<SnapshotLayout*>(Snapshot->Data);
+
+    Layout->HistoryLength = std::min(
+        {HistoryLength, StateSnapshot::MaxHistoryLength, Helper.Ply});
+    for (uint16_t I = 0; I < Layout->HistoryLength; ++I) {
+        const StepHelper& Step = Helper.getStepHelper(
+            (uint16_t)(Helper.Ply - Layout->HistoryLength + I));
+        Layout->HistoryBoardHashes[I] = Step.BoardHash;
+        Layout->HistoryMoves[I] = Step.Move;
+    }
+
+    std::memcpy(static_cast<void*>(Layout->ColorBB),
+                static_cast<const void*>(Helper.ColorBB),
+                NumColors * sizeof(bitboard::Bitboard));
+    std::memcpy(static_cast<void*>(Layout->TypeBB),
+                static_cast<const void*>(Helper.TypeBB),
+                NumPieceType * sizeof(bitboard::Bitboard));
+    std::memcpy(static_cast<void*>(&Layout->CurrentStepHelper),
+                static_cast<const void*>(&Helper.getCurrentStepHelper()),
+                sizeof(StepHelper));
+
+    Layout->HashValue = HashValue.getValue();
+    Layout->EachStands[Black] = Pos.EachStands[Black];
+    Layout->EachStands[White] = Pos.EachStands[White];
+    Layout->KingSquare[Black] = Helper.KingSquare[Black];
+    Layout->KingSquare[White] = Helper.KingSquare[White];
+    Layout->Ply = Helper.getPly();
+    Layout->SideToMove = Pos.SideToMove;
+    std::memcpy(Layout->OnBoard, Pos.OnBoard, sizeof(Pos.OnBoard));
+}
+
+void StateImpl::restore(const StateSnapshot& Snapshot) noexcept {
+    const SnapshotLayout* Layout =
+        reinterpret_cast<const SnapshotLayout*>(Snapshot.Data);
+
+    Pos.SideToMove = Layout->SideToMove;
+    Pos.PlyOffset = (uint16_t)(Layout->Ply - Layout->HistoryLength);
+    Pos.EachStands[Black] = Layout->EachStands[Black];
+    Pos.EachStands[White] = Layout->EachStands[White];
+    std::memcpy(Pos.OnBoard, Layout->OnBoard, sizeof(Pos.OnBoard));
+
+    // The position before the kept moves becomes the start of a new
+    // history, so the moves are taken back on a copy.
+    std::memcpy(static_cast<void*>(&Helper.InitialPosition),
+                static_cast<const void*>(&Pos), sizeof(Position));
+    for (uint16_t I = Layout->HistoryLength; I > 0; --I) {
+        Position& Initial = Helper.InitialPosition;
+        const Move32 Move = Layout->HistoryMoves[I - 1];
+        Initial.changeSideToMove();
+        if (Move.isNull()) {
+            continue;
+        }
+
+        const Color Mover = Initial.sideToMove();
+        const PieceTypeKind Type = Move.pieceType();
+        Initial.removePiece(Move.to());
+        if (Move.drop()) {
+            Initial.incrementStand(Mover, Type);
+            continue;
+        }
+
+        const PieceTypeKind CaptureType = Move.capturePieceType();
+        if (CaptureType != PTK_Empty) {
+            Initial.decrementStand(Mover, demotePieceType(CaptureType));
+            Initial.putPiece(Move.to(), makePiece(~Mover, CaptureType));
+        }
+        Initial.putPiece(Move.from(), makePiece(Mover, Type));
+    }
+
+    Helper.clearHistory();
+    for (uint16_t I = 0; I < Layout->HistoryLength; ++I) {
+        Helper.proceedOneStep(Layout->HistoryMoves[I],
+                              Layout->HistoryBoardHashes[I]);
+    }
+    Helper.RestoredPly = Helper.Ply;
+
+    std::memcpy(static_cast<void*>(Helper.ColorBB),
+                static_cast<const void*>(Layout->ColorBB),
+                NumColors * sizeof(bitboard::Bitboard));
+    std::memcpy(static_cast<void*>(Helper.TypeBB),
+                static_cast<const void*>(Layout->TypeBB),
+                NumPieceType * sizeof(bitboard::Bitboard));
+    std::memcpy(static_cast<void*>(&Helper.SHelper[Helper.Ply]),
+                static_cast<const void*>(&Layout->CurrentStepHelper),
+                sizeof(StepHelper));
+    Helper.KingSquare[Black] = Layout->KingSquare[Black];
+    Helper.KingSquare[White] = Layout->KingSquare[White];
+
+    HashValue.setValue(Layout->HashValue);
+}
+
 template <Color C>
 inline void StateImpl::doMove(Move32 Move) noexcept {
-    Helper.proceedOneStep(Move, HashValue.getValue(),
-                          getPosition().getStand<Black>(),
-                          getPosition().getStand<White>());
+    Helper.proceedOneStep(Move, HashValue.getValue());
 
     const StepHelper* PrevStepHelper = &Helper.getStepHelper(Helper.Ply - 1);
     StepHelper* CurrentStepHelper = &Helper.SHelper[Helper.Ply];
@@ -290,6 +420,7 @@ void StateImpl::undoMove() {
 
 void StateImpl::refresh() noexcept {
     Helper.Ply = 0;
+    Helper.RestoredPly = 0;
     std::memset(static_cast<void*>(Helper.ColorBB), 0,
                 NumColors * sizeof(bitboard::Bitboard));
     std::memset(static_cast<void*>(Helper.TypeBB), 0,
@@ -341,8 +472,6 @@ void StateImpl::refresh() noexcept {
 
     CurrentStepHelper->ContinuousCheckCounts[Black] = 0;
     CurrentStepHelper->ContinuousCheckCounts[White] = 0;
-    CurrentStepHelper->EachStand[Black] = getPosition().getStand<Black>();
-    CurrentStepHelper->EachStand[White] = getPosition().getStand<White>();
 
     if (!CurrentStepHelper->CheckerBB.isZero()) {
         CurrentStepHelper->ContinuousCheckCounts[getPosition().sideToMove()] =
@@ -595,13 +724,30 @@ bool StateImpl::isLegal(Move32 Move) const noexcept {
     return isLegal<C>(core::Move16(Move));
 }
 
+template <Color C>
+bool StateImpl::isPseudoLegalMoveLegal(Move32 Move) const noexcept {
+    // Only the last two checks of isLegal(Move16) are left; the generator
+    // has done the rest.
+    if (Move.drop()) {
+        return true;
+    }
+
+    if (Move.pieceType() == PTK_King) {
+        return !isAttacked<C>(Move.to(), Move.from());
+    }
+
+    if (getDefendingOpponentSliderBB<C>().isSet(Move.from())) {
+        return utils::isSameLine(getKingSquare<C>(), Move.from(), Move.to());
+    }
+
+    return true;
+}
+
 void StateImpl::doNullMove() noexcept {
     // This function must not be called when the king is in check.
     assert(getCheckerBB().isZero());
 
-    Helper.proceedOneStep(Move32::MoveNull(), HashValue.getValue(),
-                          getPosition().getStand<Black>(),
-                          getPosition().getStand<White>());
+    Helper.proceedOneStep(Move32::MoveNull(), HashValue.getValue());
 
     // Reset continuous check counts as the null move is not a checking move.
     const StepHelper* PrevStepHelper = &Helper.getStepHelper(Helper.Ply - 1);
@@ -628,6 +774,31 @@ void StateImpl::undoNullMove() {
     HashValue.updateColor();
 }
 
+template <Color C>
+bitboard::Bitboard StateImpl::computePinnersBB() const noexcept {
+    const Square KingSq = getKingSquare<~C>();
+    const bitboard::Bitboard OccupiedBB =
+        getBitboard<Black>() | getBitboard<White>();
+
+    const bitboard::Bitboard Candidates =
+        ((getBitboard<PTK_Lance>() & bitboard::getForwardBB<~C>(KingSq)) |
+         ((getBitboard<PTK_Bishop>() | getBitboard<PTK_ProBishop>()) &
+          bitboard::getDiagBB(KingSq)) |
+         ((getBitboard<PTK_Rook>() | getBitboard<PTK_ProRook>()) &
+          bitboard::getCrossBB(KingSq))) &
+        getBitboard<C>();
+
+    bitboard::Bitboard PinnersBB = bitboard::Bitboard::ZeroBB();
+    Candidates.forEach([&](Square Sq) {
+        if ((bitboard::getBetweenBB(Sq, KingSq) & OccupiedBB).popCount() ==
+            1) {
+            PinnersBB.toggleBit(Sq);
+        }
+    });
+
+    return PinnersBB;
+}
+
 namespace {
 
 // The order in which computeSEE() picks the attackers. It must be kept
@@ -682,8 +853,6 @@ int32_t StateImpl::computeSEEImpl(const Move32 Move,
     const bool IsDrop = Move.drop();
     const bool IsCapture = Move.capturePieceType() != PTK_Empty;
 
-    const StepHelper* CurrentStepHelper = &Helper.getCurrentStepHelper();
-
     const Square To = Move.to();
     Color C = getSideToMove();
 
@@ -725,6 +894,17 @@ int32_t StateImpl::computeSEEImpl(const Move32 Move,
 
     bitboard::Bitboard BBs[2] = {getBitboard(Black), getBitboard(White)};
 
+    // The sliders pinning a piece at the root position, which are not kept
+    // in the step helper. Without any pinned piece, there is none.
+    bitboard::Bitboard PinnersBB[NumColors] = {bitboard::Bitboard::ZeroBB(),
+                                               bitboard::Bitboard::ZeroBB()};
+    if (!getDefendingOpponentSliderBB<White>().isZero()) {
+        PinnersBB[Black] = computePinnersBB<Black>();
+    }
+    if (!getDefendingOpponentSliderBB<Black>().isZero()) {
+        PinnersBB[White] = computePinnersBB<White>();
+    }
+
     // Move my piece. Only From squares get vacated during the exchange:
     // To remains occupied all the time (a non-capture occupies it with
     // this very move), so its ownership is not tracked.
@@ -762,7 +942,7 @@ int32_t StateImpl::computeSEEImpl(const Move32 Move,
     // A drop vacates no square and cannot deliver a discovered check.
     bool OnlyKingCanCapture =
         !IsDrop &&
-        seeGivesDiscoveredCheck(C, Move.from(), BBs[C], CurrentStepHelper);
+        seeGivesDiscoveredCheck(C, Move.from(), BBs[C] & PinnersBB[C]);
 
     C = ~C;
 
@@ -786,7 +966,7 @@ int32_t StateImpl::computeSEEImpl(const Move32 Move,
 
         // The pinners that still remain on their original squares.
         const bitboard::Bitboard AlivePinnersBB =
-            OppBB & CurrentStepHelper->Pinners[~C];
+            OppBB & PinnersBB[~C];
 
         Square FromSq = SqInvalid;
         PieceTypeKind AttackerType = PTK_Empty;
@@ -939,7 +1119,7 @@ int32_t StateImpl::computeSEEImpl(const Move32 Move,
             updateSEEAttackersBB(&AttackersBB, To, FromSq, OccupiedBB);
 
             OnlyKingCanCapture =
-                seeGivesDiscoveredCheck(C, FromSq, MyBB, CurrentStepHelper);
+                seeGivesDiscoveredCheck(C, FromSq, MyBB & PinnersBB[C]);
         }
 
         C = ~C;
@@ -1070,8 +1250,8 @@ void StateImpl::updateSEEAttackersBB(
 }
 
 bool StateImpl::seeGivesDiscoveredCheck(
-    const Color C, const Square FromSq, const bitboard::Bitboard& MyBB,
-    const StepHelper* SHelper) const noexcept {
+    const Color C, const Square FromSq,
+    const bitboard::Bitboard& MyPinnersBB) const noexcept {
     // Was the piece on FromSq shielding the opponent's king from one of
     // my sliders at the root position?
     if (!getDefendingOpponentSliderBB(~C).isSet(FromSq)) {
@@ -1084,7 +1264,7 @@ bool StateImpl::seeGivesDiscoveredCheck(
     const Square OpKingSq = getKingSquare(~C);
 
     bool Discovered = false;
-    (MyBB & SHelper->Pinners[C] & bitboard::LineBB[FromSq][OpKingSq])
+    (MyPinnersBB & bitboard::LineBB[FromSq][OpKingSq])
         .forEach([&](Square SliderSq) {
             if (bitboard::getBetweenBB(SliderSq, OpKingSq).isSet(FromSq)) {
                 Discovered = true;
@@ -1098,7 +1278,6 @@ template <Color C, bool UpdateCheckerBySliders>
 inline void StateImpl::setDefendingOpponentSliderBBAndSliderCheckerBB(
     StepHelper* SHelper, const bitboard::Bitboard& OccupiedBB) noexcept {
     SHelper->DefendingOpponentSliderBB[C].clear();
-    SHelper->Pinners[~C].clear();
 
     const bitboard::Bitboard Candidates =
         ((getBitboard<PTK_Lance>() &
@@ -1120,7 +1299,6 @@ inline void StateImpl::setDefendingOpponentSliderBBAndSliderCheckerBB(
             }
         } else if (PopCount == 1) {
             SHelper->DefendingOpponentSliderBB[C] |= BetweenOccupiedBB;
-            SHelper->Pinners[~C].toggleBit(Sq);
         }
     });
 }
@@ -1166,6 +1344,10 @@ template bool StateImpl::isLegal<Black>(Move16 Move) const noexcept;
 template bool StateImpl::isLegal<White>(Move16 Move) const noexcept;
 template bool StateImpl::isLegal<Black>(Move32 Move) const noexcept;
 template bool StateImpl::isLegal<White>(Move32 Move) const noexcept;
+template bool
+StateImpl::isPseudoLegalMoveLegal<Black>(Move32 Move) const noexcept;
+template bool
+StateImpl::isPseudoLegalMoveLegal<White>(Move32 Move) const noexcept;
 
 } // namespace internal
 } // namespace core
@@ -11,6 +11,7 @@
 #define NSHOGI_CORE_INTERNAL_STATEIMPL_H
 
 #include "../position.h"
+#include "../state.h"
 #include "bitboard.h"
 #include "hash.h"
 #include "statehelper.h"
@@ -181,6 +182,7 @@ class StateImpl {
     StateImpl(const Position& P);
     StateImpl(const Position& P, uint16_t Ply);
     StateImpl(const Position& CurrentP, const Position& InitP);
+    StateImpl(const StateSnapshot& Snapshot);
 
     StateImpl& operator=(const StateImpl&) = delete;
     StateImpl& operator=(StateImpl&&) = delete;
@@ -189,6 +191,14 @@ class StateImpl {
 
     StateImpl clone() const;
 
+    // Reinitialize to `P` with an empty history, keeping its capacity.
+    // `refresh()` must be called afterwards.
+    void reset(const Position& P, uint16_t Ply) noexcept;
+
+    void snapshot(StateSnapshot* Snapshot,
+                  uint16_t HistoryLength) const noexcept;
+    void restore(const StateSnapshot& Snapshot) noexcept;
+
     // Getters.
     inline constexpr const Position& getPosition() const noexcept {
         return Pos;
@@ -236,10 +246,40 @@ class StateImpl {
         return Helper.getCurrentStepHelper().CheckerBB;
     }
 
+    // Prefetches the position, the bitboards and the pointer of the steps,
+    // leaving out the cold rest of the helper. The current step is reached
+    // through that pointer, so prefetch it with `prefetchCurrentStep()`
+    // once this part has arrived.
+    inline void prefetch() const noexcept {
+        const char* const Begin = reinterpret_cast<const char*>(&Pos);
+        const char* const End =
+            reinterpret_cast<const char*>(&Helper.SHelper + 1);
+        for (const char* Line = Begin; Line < End; Line += 64) {
+            __builtin_prefetch(Line);
+        }
+        // The state need not start on a cache line.
+        __builtin_prefetch(End - 1);
+    }
+
+    inline void prefetchCurrentStep() const noexcept {
+        const char* const Begin =
+            reinterpret_cast<const char*>(&Helper.getCurrentStepHelper());
+        for (std::size_t Offset = 0; Offset < sizeof(StepHelper);
+             Offset += 64) {
+            __builtin_prefetch(Begin + Offset);
+        }
+    }
+
     inline uint64_t getBoardHash() const noexcept {
         return HashValue.getValue();
     }
 
+    // The board hash after `Move` by `C`, without playing it.
+    template <Color C>
+    inline uint64_t getBoardHashAfter(Move32 Move) const noexcept {
+        return HashValue.afterMove<C>(Move);
+    }
+
     inline uint64_t getHash() const noexcept {
         return HashValue.getValue() ^
                ((uint64_t)(getPosition().getStand<Black>()) << 33) ^
@@ -259,7 +299,10 @@ class StateImpl {
     }
 
     Move32 getLastMove() const {
-        return getHistoryMove(getPly(false) - 1);
+        if (Helper.Ply == 0) {
+            return Move32::MoveNone();
+        }
+        return getHistoryMove(Helper.Ply - 1);
     }
 
     // Manipulations.
@@ -278,21 +321,55 @@ class StateImpl {
 
     // Helper functions.
 
+    // If `RepeatedPly` is given and a repetition is found, it receives the
+    // ply of the oldest position the repetition goes back to.
     template <bool Strict = false>
-    inline RepetitionStatus getRepetitionStatus() const noexcept {
+    inline RepetitionStatus
+    getRepetitionStatus(uint16_t* RepeatedPly = nullptr) const noexcept {
+        if (!Helper.mayRepeat(HashValue.getValue())) {
+            return RepetitionStatus::NoRepetition;
+        }
+
         const Color SideToMove = getPosition().sideToMove();
         const StepHelper& CurrentStepHelper = Helper.getCurrentStepHelper();
 
         const Stands MyStand = getPosition().getStand(SideToMove);
         const Stands OpStand = getPosition().getStand(~SideToMove);
 
+        // The stands at `StandPly`, taken back move by move from the
+        // current ones only when a board hash matches.
+        Stands StepStands[NumColors] = {getPosition().getStand<Black>(),
+                                        getPosition().getStand<White>()};
+        int StandPly = Helper.Ply;
+
         uint16_t RepetitionCount = 0;
         for (int Ply = Helper.Ply - 4; Ply >= 0; Ply -= 2) {
             const StepHelper& SHelper = Helper.getStepHelper((uint16_t)Ply);
-            const Stands MyStepStand = SHelper.EachStand[SideToMove];
-            const Stands OpStepStand = SHelper.EachStand[~SideToMove];
 
             if (HashValue.getValue() == SHelper.BoardHash) {
+                for (; StandPly > Ply; --StandPly) {
+                    const Move32 Move =
+                        Helper.getStepHelper((uint16_t)(StandPly - 1)).Move;
+                    const Color Mover = ((Helper.Ply - StandPly) & 1) == 0
+                                            ? ~SideToMove
+                                            : SideToMove;
+                    if (Move.drop()) {
+                        StepStands[Mover] =
+                            incrementStand(StepStands[Mover], Move.pieceType());
+                    } else if (Move.capturePieceType() != PTK_Empty) {
+                        StepStands[Mover] = decrementStand(
+                            StepStands[Mover],
+                            demotePieceType(Move.capturePieceType()));
+                    }
+                }
+
+                const Stands MyStepStand = StepStands[SideToMove];
+                const Stands OpStepStand = StepStands[~SideToMove];
+
+                if (RepeatedPly != nullptr) {
+                    *RepeatedPly = (uint16_t)Ply;
+                }
+
                 if (MyStand == MyStepStand && OpStand == OpStepStand) {
                     if constexpr (Strict) {
                         if (CurrentStepHelper
@@ -906,8 +983,9 @@ class StateImpl {
         return isAttackedBySlider<C>(Sq, OccupiedBB, ExcludeSq, VirtualSq);
     }
 
+    // The current step holds the flag, so that it survives a restore.
     bool isLastMoveDroppingAPawn() const noexcept {
-        return Helper.Ply > 0 && Helper.SHelper.back().IsLastMoveDroppingAPawn;
+        return Helper.getCurrentStepHelper().IsLastMoveDroppingAPawn;
     }
 
     template <core::Color C>
@@ -916,6 +994,9 @@ class StateImpl {
     template <core::Color C>
     bool isLegal(Move32 Move) const noexcept;
 
+    template <core::Color C>
+    bool isPseudoLegalMoveLegal(Move32 Move) const noexcept;
+
     //  The functions below are for `ExtendedState` class,
     //  which means that they are not necessary for the game representation but
     //  are possibly useful.
@@ -956,9 +1037,13 @@ class StateImpl {
                          Square FromSq,
                          const bitboard::Bitboard& OccupiedBB) const noexcept;
 
+    // The sliders of C pinning a piece of ~C to its king.
+    template <Color C>
+    bitboard::Bitboard computePinnersBB() const noexcept;
+
     bool seeGivesDiscoveredCheck(Color C, Square FromSq,
-                                 const bitboard::Bitboard& MyBB,
-                                 const StepHelper* SHelper) const noexcept;
+                                 const bitboard::Bitboard& MyPinnersBB) const
+        noexcept;
 };
 
 } // namespace internal
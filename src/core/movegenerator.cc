@@ -33,6 +33,21 @@ MoveList MoveGenerator::generateLegalMoves(const State& S) noexcept {
     }
 }
 
+template <Color C, bool WilyPromote>
+MoveList MoveGenerator::generatePseudoLegalMoves(const State& S) noexcept {
+    return MoveGeneratorInternal::generatePseudoLegalMoves<C, WilyPromote>(
+        *ImmutableStateAdapter(S).get());
+}
+
+template <bool WilyPromote>
+MoveList MoveGenerator::generatePseudoLegalMoves(const State& S) noexcept {
+    if (S.getSideToMove() == Black) {
+        return generatePseudoLegalMoves<Black, WilyPromote>(S);
+    } else {
+        return generatePseudoLegalMoves<White, WilyPromote>(S);
+    }
+}
+
 template <Color C, bool WilyPromote>
 MoveList MoveGenerator::generateLegalCheckMoves(const State& S) noexcept {
     return MoveGeneratorInternal::generateLegalCheckMoves<C, WilyPromote>(
@@ -74,6 +89,54 @@ MoveList MoveGenerator::generateLegalCaptureMoves(const State& S) noexcept {
     }
 }
 
+template <Color C, bool WilyPromote>
+MoveList MoveGenerator::generateLegalQuietCheckMoves(const State& S) noexcept {
+    return MoveGeneratorInternal::generateLegalQuietCheckMoves<C, WilyPromote>(
+        *ImmutableStateAdapter(S).get());
+}
+
+template <bool WilyPromote>
+MoveList MoveGenerator::generateLegalQuietCheckMoves(const State& S) noexcept {
+    if (S.getSideToMove() == Black) {
+        return generateLegalQuietCheckMoves<Black, WilyPromote>(S);
+    } else {
+        return generateLegalQuietCheckMoves<White, WilyPromote>(S);
+    }
+}
+
+template <Color C, bool WilyPromote>
+MoveList MoveGenerator::generateLegalCaptureMovesOn(const State& S,
+                                                    Square To) noexcept {
+    return MoveGeneratorInternal::generateLegalCaptureMovesOn<C, WilyPromote>(
+        *ImmutableStateAdapter(S).get(), To);
+}
+
+template <bool WilyPromote>
+MoveList MoveGenerator::generateLegalCaptureMovesOn(const State& S,
+                                                    Square To) noexcept {
+    if (S.getSideToMove() == Black) {
+        return generateLegalCaptureMovesOn<Black, WilyPromote>(S, To);
+    } else {
+        return generateLegalCaptureMovesOn<White, WilyPromote>(S, To);
+    }
+}
+
+template <Color C>
+MoveList
+MoveGenerator::generateLegalQuietPromotionMoves(const State& S) noexcept {
+    return MoveGeneratorInternal::generateLegalQuietPromotionMoves<C>(
+        *ImmutableStateAdapter(S).get());
+}
+
+MoveList
+MoveGenerator::generateLegalQuietPromotionMoves(const State& S) noexcept {
+    if (S.getSideToMove() == Black) {
+        return generateLegalQuietPromotionMoves<Black>(S);
+    } else {
+        return generateLegalQuietPromotionMoves<White>(S);
+    }
+}
+
 Move32 MoveGenerator::generateLegalSmallestMove(const State& S,
                                                 Square To) noexcept {
     if (S.getSideToMove() == Black) {
@@ -92,6 +155,15 @@ MoveGenerator::generateLegalMoves<White, false>(const State& S) noexcept;
 template MoveList
 MoveGenerator::generateLegalMoves<White, true>(const State& S) noexcept;
 
+template MoveList
+MoveGenerator::generatePseudoLegalMoves<Black, false>(const State& S) noexcept;
+template MoveList
+MoveGenerator::generatePseudoLegalMoves<Black, true>(const State& S) noexcept;
+template MoveList
+MoveGenerator::generatePseudoLegalMoves<White, false>(const State& S) noexcept;
+template MoveList
+MoveGenerator::generatePseudoLegalMoves<White, true>(const State& S) noexcept;
+
 template MoveList
 MoveGenerator::generateLegalCheckMoves<Black, false>(const State& S) noexcept;
 template MoveList
@@ -115,6 +187,11 @@ MoveGenerator::generateLegalMoves<false>(const State& S) noexcept;
 template MoveList
 MoveGenerator::generateLegalMoves<true>(const State& S) noexcept;
 
+template MoveList
+MoveGenerator::generatePseudoLegalMoves<false>(const State& S) noexcept;
+template MoveList
+MoveGenerator::generatePseudoLegalMoves<true>(const State& S) noexcept;
+
 template MoveList
 MoveGenerator::generateLegalCheckMoves<false>(const State& S) noexcept;
 template MoveList
@@ -125,6 +202,39 @@ MoveGenerator::generateLegalCaptureMoves<false>(const State& S) noexcept;
 template MoveList
 MoveGenerator::generateLegalCaptureMoves<true>(const State& S) noexcept;
 
+template MoveList MoveGenerator::generateLegalQuietCheckMoves<Black, false>(
+    const State& S) noexcept;
+template MoveList MoveGenerator::generateLegalQuietCheckMoves<Black, true>(
+    const State& S) noexcept;
+template MoveList MoveGenerator::generateLegalQuietCheckMoves<White, false>(
+    const State& S) noexcept;
+template MoveList MoveGenerator::generateLegalQuietCheckMoves<White, true>(
+    const State& S) noexcept;
+template MoveList
+MoveGenerator::generateLegalQuietCheckMoves<false>(const State& S) noexcept;
+template MoveList
+MoveGenerator::generateLegalQuietCheckMoves<true>(const State& S) noexcept;
+
+template MoveList MoveGenerator::generateLegalCaptureMovesOn<Black, false>(
+    const State& S, Square To) noexcept;
+template MoveList MoveGenerator::generateLegalCaptureMovesOn<Black, true>(
+    const State& S, Square To) noexcept;
+template MoveList MoveGenerator::generateLegalCaptureMovesOn<White, false>(
+    const State& S, Square To) noexcept;
+template MoveList MoveGenerator::generateLegalCaptureMovesOn<White, true>(
+    const State& S, Square To) noexcept;
+template MoveList
+MoveGenerator::generateLegalCaptureMovesOn<false>(const State& S,
+                                                  Square To) noexcept;
+template MoveList
+MoveGenerator::generateLegalCaptureMovesOn<true>(const State& S,
+                                                 Square To) noexcept;
+
+template MoveList
+MoveGenerator::generateLegalQuietPromotionMoves<Black>(const State& S) noexcept;
+template MoveList
+MoveGenerator::generateLegalQuietPromotionMoves<White>(const State& S) noexcept;
+
 template Move32
 MoveGenerator::generateLegalSmallestMove<Black>(const State& S,
                                                 Square To) noexcept;
@@ -38,6 +38,21 @@ class MoveGenerator {
     template <Color C, bool WilyPromote = true>
     static MoveList generateLegalMoves(const State& S) noexcept;
 
+    ///
+    /// @brief Generate all pseudo-legal moves for a given state.
+    ///
+    /// Unlike generateLegalMoves(), moves of pinned pieces off their line and
+    /// king moves onto attacked squares are not filtered out; use
+    /// State::isPseudoLegalMoveLegal() on the moves actually searched. In
+    /// check, only the legal evasions are generated. Drops are always legal.
+    /// @tparam C The color of the side for which moves are begin generated.
+    ///         It must match the side to move in the provided state.
+    /// @tparam WilyPromote If true, trivial non-promoting moves are ommited
+    ///         to reduce the move set.
+    ///
+    template <Color C, bool WilyPromote = true>
+    static MoveList generatePseudoLegalMoves(const State& S) noexcept;
+
     ///
     /// @brief Generate all legal check moves for a given state.
     /// @tparam C The color of the side for which moves are begin generated.
@@ -58,6 +73,44 @@ class MoveGenerator {
     template <Color C, bool WilyPromote = true>
     static MoveList generateLegalCaptureMoves(const State& S) noexcept;
 
+    ///
+    /// @brief Generate all legal check moves that capture nothing, drops
+    /// included.
+    /// @tparam C The color of the side for which moves are begin generated.
+    ///         It must match the side to move in the provided state.
+    /// @tparam WilyPromote If true, trivial non-promoting moves are ommited
+    ///         to reduce the move set.
+    ///
+    template <Color C, bool WilyPromote = true>
+    static MoveList generateLegalQuietCheckMoves(const State& S) noexcept;
+
+    ///
+    /// @brief Generate all legal moves that capture the piece on the given
+    /// square.
+    ///
+    /// Nothing is generated if the square is not occupied by an opponent's
+    /// piece. Passing the destination of the last move gives the
+    /// recaptures.
+    /// @tparam C The color of the side for which moves are begin generated.
+    ///         It must match the side to move in the provided state.
+    /// @tparam WilyPromote If true, trivial non-promoting moves are ommited
+    ///         to reduce the move set.
+    ///
+    template <Color C, bool WilyPromote = true>
+    static MoveList generateLegalCaptureMovesOn(const State& S,
+                                                Square To) noexcept;
+
+    ///
+    /// @brief Generate all legal promotions that capture nothing.
+    ///
+    /// There is no `WilyPromote` parameter since it only concerns
+    /// non-promoting moves.
+    /// @tparam C The color of the side for which moves are begin generated.
+    ///         It must match the side to move in the provided state.
+    ///
+    template <Color C>
+    static MoveList generateLegalQuietPromotionMoves(const State& S) noexcept;
+
     ///
     /// @brief Generate the smallest legal move that moves a piece of color C to
     /// the given square.
@@ -74,6 +127,14 @@ class MoveGenerator {
     template <bool WilyPromote = true>
     static MoveList generateLegalMoves(const State& S) noexcept;
 
+    ///
+    /// @brief Generate all pseudo-legal moves for a given state.
+    /// @tparam WilyPromote If true, trivial non-promoting moves are ommited
+    ///         to reduce the move set.
+    ///
+    template <bool WilyPromote = true>
+    static MoveList generatePseudoLegalMoves(const State& S) noexcept;
+
     ///
     /// @brief Generate all legal check moves for a given state.
     /// @tparam WilyPromote If true, trivial non-promoting moves are ommited
@@ -90,6 +151,30 @@ class MoveGenerator {
     template <bool WilyPromote = true>
     static MoveList generateLegalCaptureMoves(const State& S) noexcept;
 
+    ///
+    /// @brief Generate all legal check moves that capture nothing, drops
+    /// included.
+    /// @tparam WilyPromote If true, trivial non-promoting moves are ommited
+    ///         to reduce the move set.
+    ///
+    template <bool WilyPromote = true>
+    static MoveList generateLegalQuietCheckMoves(const State& S) noexcept;
+
+    ///
+    /// @brief Generate all legal moves that capture the piece on the given
+    /// square.
+    /// @tparam WilyPromote If true, trivial non-promoting moves are ommited
+    ///         to reduce the move set.
+    ///
+    template <bool WilyPromote = true>
+    static MoveList generateLegalCaptureMovesOn(const State& S,
+                                                Square To) noexcept;
+
+    ///
+    /// @brief Generate all legal promotions that capture nothing.
+    ///
+    static MoveList generateLegalQuietPromotionMoves(const State& S) noexcept;
+
     ///
     /// @brief Generate the smallest legal move that moves a piece to the given
     /// square.
@@ -0,0 +1,225 @@
+//
+// Copyright (c) 2025-2026 @nyashiki
+//
+// This software is licensed under the MIT license.
+// For details, see the LICENSE file in the root of this repository.
+//
+// SPDX-License-Identifier: MIT
+//
+
+#include "movepicker.h"
+#include "internal/movegenerator.h"
+#include "internal/stateadapter.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace nshogi {
+namespace core {
+
+using namespace internal;
+
+namespace {
+
+// Rough piece values for MVV-LVA ordering only.
+constexpr int32_t CaptureOrderValues[NumPieceType] = {
+    0,  // PTK_Empty
+    1,  // PTK_Pawn
+    3,  // PTK_Lance
+    4,  // PTK_Knight
+    5,  // PTK_Silver
+    8,  // PTK_Bishop
+    10, // PTK_Rook
+    6,  // PTK_Gold
+    20, // PTK_King
+    6,  // PTK_ProPawn
+    6,  // PTK_ProLance
+    6,  // PTK_ProKnight
+    6,  // PTK_ProSilver
+    11, // PTK_ProBishop
+    13, // PTK_ProRook
+};
+
+} // namespace
+
+template <bool WilyPromote>
+MovePicker<WilyPromote>::MovePicker(const State& St, Move32 TTMove,
+                                    Move32 Killer1, Move32 Killer2) noexcept
+    : S(St)
+    , HashMove(TTMove)
+    , Killers{Killer1, Killer2}
+    , CurrentStage(S.isInCheck() ? Stage::EvasionHashMove : Stage::HashMove)
+    , Current(Moves)
+    , Tail(Moves) {
+}
+
+template <bool WilyPromote>
+Move32 MovePicker<WilyPromote>::next() noexcept {
+    if (S.getSideToMove() == Black) {
+        return nextImpl<Black>();
+    } else {
+        return nextImpl<White>();
+    }
+}
+
+template <bool WilyPromote>
+template <Color C>
+Move32 MovePicker<WilyPromote>::nextImpl() noexcept {
+    const StateImpl& Impl = *ImmutableStateAdapter(S).get();
+
+    switch (CurrentStage) {
+    case Stage::HashMove:
+        CurrentStage = Stage::GenerateCaptures;
+        if (!HashMove.isNone() && S.isLegal(HashMove)) {
+            return HashMove;
+        }
+        [[fallthrough]];
+
+    case Stage::GenerateCaptures:
+        Current = Moves;
+        Tail = MoveGeneratorInternal::generatePseudoLegalCaptureMoves<
+            C, WilyPromote>(Impl, Moves);
+        scoreCaptures();
+        CurrentStage = Stage::Captures;
+        [[fallthrough]];
+
+    case Stage::Captures:
+        while (Current != Tail) {
+            const Move32 Move = pickBestCapture();
+            if (Move != HashMove && S.isPseudoLegalMoveLegal(Move)) {
+                return Move;
+            }
+        }
+        CurrentStage = Stage::Killer1;
+        [[fallthrough]];
+
+    case Stage::Killer1:
+        CurrentStage = Stage::Killer2;
+        if (isPlayableKiller(Killers[0])) {
+            return Killers[0];
+        }
+        [[fallthrough]];
+
+    case Stage::Killer2:
+        CurrentStage = Stage::GenerateQuiets;
+        if (Killers[1] != Killers[0] && isPlayableKiller(Killers[1])) {
+            return Killers[1];
+        }
+        [[fallthrough]];
+
+    case Stage::GenerateQuiets:
+        Current = Moves;
+        Tail = MoveGeneratorInternal::generatePseudoLegalQuietBoardMoves<
+            C, WilyPromote>(Impl, Moves);
+        std::partition(Moves, Tail,
+                       [](Move32 Move) { return Move.promote(); });
+        CurrentStage = Stage::Quiets;
+        [[fallthrough]];
+
+    case Stage::Quiets:
+        while (Current != Tail) {
+            const Move32 Move = *Current++;
+            if (!isTriedEarly(Move) && S.isPseudoLegalMoveLegal(Move)) {
+                return Move;
+            }
+        }
+        CurrentStage = Stage::GenerateDrops;
+        [[fallthrough]];
+
+    case Stage::GenerateDrops:
+        Current = Moves;
+        Tail = MoveGeneratorInternal::generateDroppingMoves<C>(Impl, Moves);
+        CurrentStage = Stage::Drops;
+        [[fallthrough]];
+
+    case Stage::Drops:
+        while (Current != Tail) {
+            const Move32 Move = *Current++;
+            if (!isTriedEarly(Move)) {
+                return Move;
+            }
+        }
+        CurrentStage = Stage::End;
+        return Move32::MoveNone();
+
+    case Stage::EvasionHashMove:
+        CurrentStage = Stage::GenerateEvasions;
+        if (!HashMove.isNone() && S.isLegal(HashMove)) {
+            return HashMove;
+        }
+        [[fallthrough]];
+
+    case Stage::GenerateEvasions:
+        Current = Moves;
+        Tail = MoveGeneratorInternal::generateLegalEvasionMoves<C, WilyPromote>(
+            Impl, Moves);
+        std::partition(Moves, Tail, [](Move32 Move) {
+            return Move.capturePieceType() != PTK_Empty;
+        });
+        CurrentStage = Stage::Evasions;
+        [[fallthrough]];
+
+    case Stage::Evasions:
+        while (Current != Tail) {
+            const Move32 Move = *Current++;
+            if (Move != HashMove) {
+                return Move;
+            }
+        }
+        CurrentStage = Stage::End;
+        [[fallthrough]];
+
+    case Stage::End:
+        break;
+    }
+
+    return Move32::MoveNone();
+}
+
+template <bool WilyPromote>
+bool MovePicker<WilyPromote>::isPlayableKiller(Move32 Killer) const noexcept {
+    // The captures have been tried already, so a killer must move to an
+    // empty square.
+    return !Killer.isNone() && Killer != HashMove &&
+           Killer.capturePieceType() == PTK_Empty &&
+           S.getPosition().pieceOn(Killer.to()) == PK_Empty &&
+           S.isLegal(Killer);
+}
+
+template <bool WilyPromote>
+bool MovePicker<WilyPromote>::isTriedEarly(Move32 Move) const noexcept {
+    return Move == HashMove || Move == Killers[0] || Move == Killers[1];
+}
+
+template <bool WilyPromote>
+void MovePicker<WilyPromote>::scoreCaptures() noexcept {
+    for (Move32* Move = Moves; Move != Tail; ++Move) {
+        Scores[Move - Moves] =
+            CaptureOrderValues[Move->capturePieceType()] * 32 -
+            CaptureOrderValues[Move->pieceType()];
+    }
+}
+
+// Selection sort one step at a time: a node that cuts off after a few
+// captures does not pay for sorting all of them.
+template <bool WilyPromote>
+Move32 MovePicker<WilyPromote>::pickBestCapture() noexcept {
+    assert(Current != Tail);
+
+    Move32* Best = Current;
+    for (Move32* Move = Current + 1; Move != Tail; ++Move) {
+        if (Scores[Move - Moves] > Scores[Best - Moves]) {
+            Best = Move;
+        }
+    }
+
+    std::swap(*Best, *Current);
+    std::swap(Scores[Best - Moves], Scores[Current - Moves]);
+    return *Current++;
+}
+
+template class MovePicker<false>;
+template class MovePicker<true>;
+
+} // namespace core
+} // namespace nshogi
@@ -0,0 +1,113 @@
+//
+// Copyright (c) 2025-2026 @nyashiki
+//
+// This software is licensed under the MIT license.
+// For details, see the LICENSE file in the root of this repository.
+//
+// SPDX-License-Identifier: MIT
+//
+
+#ifndef NSHOGI_CORE_MOVEPICKER_H
+#define NSHOGI_CORE_MOVEPICKER_H
+
+#include "state.h"
+#include "types.h"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace nshogi {
+namespace core {
+
+///
+/// @class MovePicker
+/// @brief Yields the legal moves of a state in stages, generating each
+/// stage only when the previous one is exhausted.
+///
+/// Out of check, the stages are:
+///   1. the hash move,
+///   2. captures, the most valuable victim first and then the least
+///      valuable attacker first (MVV-LVA),
+///   3. the killer moves,
+///   4. the other board moves, promotions first,
+///   5. drops.
+///
+/// A search node that cuts off early thus never generates the later stages.
+/// In check, the hash move comes first and then all the evasions, captures
+/// first. Board moves are generated pseudo-legally and checked with
+/// `State::isPseudoLegalMoveLegal()` only when they are about to be
+/// returned. Every legal move (up to `WilyPromote`) is returned exactly
+/// once.
+///
+/// The state must not be modified while the picker is in use.
+///
+/// @tparam WilyPromote If true, trivial non-promoting moves are ommited
+///         to reduce the move set, except the hash move and the killers.
+///
+template <bool WilyPromote = true>
+class MovePicker {
+ public:
+    ///
+    /// @brief Construct a picker.
+    /// @param HashMove The move to try first, e.g. from a transposition
+    ///        table. It is skipped unless it is legal in `S`.
+    /// @param Killer1 A quiet move to try right after the captures. It is
+    ///        skipped unless it is a legal non-capture in `S`.
+    /// @param Killer2 Same as `Killer1`, tried after it.
+    ///
+    MovePicker(const State& S, Move32 HashMove = Move32::MoveNone(),
+               Move32 Killer1 = Move32::MoveNone(),
+               Move32 Killer2 = Move32::MoveNone()) noexcept;
+
+    MovePicker(const MovePicker&) = delete;
+    MovePicker& operator=(const MovePicker&) = delete;
+
+    ///
+    /// @brief Return the next move, or `Move32::MoveNone()` when all moves
+    /// have been returned.
+    ///
+    Move32 next() noexcept;
+
+ private:
+    enum class Stage : uint8_t {
+        HashMove,
+        GenerateCaptures,
+        Captures,
+        Killer1,
+        Killer2,
+        GenerateQuiets,
+        Quiets,
+        GenerateDrops,
+        Drops,
+        EvasionHashMove,
+        GenerateEvasions,
+        Evasions,
+        End,
+    };
+
+    // No stage generates more moves than a whole position has (593).
+    static constexpr std::size_t MoveCountMax = 600;
+
+    template <Color C>
+    Move32 nextImpl() noexcept;
+
+    bool isPlayableKiller(Move32 Killer) const noexcept;
+    bool isTriedEarly(Move32 Move) const noexcept;
+    Move32 pickBestCapture() noexcept;
+    void scoreCaptures() noexcept;
+
+    const State& S;
+    const Move32 HashMove;
+    const Move32 Killers[2];
+    Stage CurrentStage;
+
+    Move32* Current;
+    Move32* Tail;
+    alignas(32) Move32 Moves[MoveCountMax];
+    int32_t Scores[MoveCountMax];
+};
+
+} // namespace core
+} // namespace nshogi
+
+#endif // #ifndef NSHOGI_CORE_MOVEPICKER_H
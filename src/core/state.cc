@@ -9,6 +9,7 @@
 
 #include "state.h"
 #include "internal/stateimpl.h"
+#include "statearena.h"
 #include "position.h"
 #include "types.h"
 
@@ -19,29 +20,49 @@ namespace nshogi {
 namespace core {
 
 State::State(State&& S) noexcept
-    : Impl(S.Impl) {
+    : Impl(S.Impl)
+    , Arena(S.Arena) {
     S.Impl = nullptr;
+    S.Arena = nullptr;
 }
 
 State::State(const Position& P)
-    : Impl(new internal::StateImpl(P)) {
+    : Impl(new internal::StateImpl(P))
+    , Arena(nullptr) {
 }
 
 State::State(const Position& P, uint16_t Ply)
-    : Impl(new internal::StateImpl(P, Ply)) {
+    : Impl(new internal::StateImpl(P, Ply))
+    , Arena(nullptr) {
 }
 
 State::State(const Position& CurrentP, const Position& InitP)
-    : Impl(new internal::StateImpl(CurrentP, InitP)) {
+    : Impl(new internal::StateImpl(CurrentP, InitP))
+    , Arena(nullptr) {
+}
+
+State::State(const StateSnapshot& Snapshot)
+    : Impl(new internal::StateImpl(Snapshot))
+    , Arena(nullptr) {
+}
+
+State::State(const Position& P, uint16_t Ply, StateArena& SA)
+    : Impl(SA.acquire(P, Ply))
+    , Arena(&SA) {
 }
 
 State::State(internal::StateImpl* SI)
-    : Impl(SI) {
+    : Impl(SI)
+    , Arena(nullptr) {
 }
 
 State::~State() {
     if (Impl != nullptr) {
-        delete Impl;
+        if (Arena != nullptr) {
+            Arena->release(Impl);
+        } else {
+            delete Impl;
+        }
     }
 }
 
@@ -49,6 +70,16 @@ State State::clone() const {
     return State(new internal::StateImpl(Impl->clone()));
 }
 
+StateSnapshot State::snapshot(uint16_t HistoryLength) const noexcept {
+    StateSnapshot Snapshot;
+    Impl->snapshot(&Snapshot, HistoryLength);
+    return Snapshot;
+}
+
+void State::restore(const StateSnapshot& Snapshot) noexcept {
+    Impl->restore(Snapshot);
+}
+
 Color State::getSideToMove() const noexcept {
     return Impl->getSideToMove();
 }
@@ -142,5 +173,13 @@ bool State::isLegal(Move32 Move) const noexcept {
     }
 }
 
+bool State::isPseudoLegalMoveLegal(Move32 Move) const noexcept {
+    if (getSideToMove() == Black) {
+        return Impl->isPseudoLegalMoveLegal<Black>(Move);
+    } else {
+        return Impl->isPseudoLegalMoveLegal<White>(Move);
+    }
+}
+
 } // namespace core
 } // namespace nshogi
@@ -13,6 +13,7 @@
 #include <memory>
 
 #include <cassert>
+#include <cstddef>
 #include <cstdint>
 
 #include "position.h"
@@ -30,6 +31,32 @@ class MutableStateAdapter;
 
 } // namespace internal
 
+class StateArena;
+
+///
+/// @struct StateSnapshot
+/// @brief A fixed-size copy of the current position of a state.
+///
+/// A snapshot holds the bitboards, the stands, the hash value, the side to
+/// move, the ply, and the checker and pinner information of a state, and
+/// optionally the last few moves of its history with their board hashes.
+/// It is trivially copyable, so that a search can copy it around freely,
+/// and a state is made from it with `State::restore()` or
+/// `StateBuilder::newState()` without recomputing anything.
+///
+struct StateSnapshot {
+ public:
+    static constexpr std::size_t Size = 576;
+
+    /// The longest history a snapshot can hold.
+    static constexpr uint16_t MaxHistoryLength = 8;
+
+ private:
+    alignas(64) unsigned char Data[Size];
+
+    friend class internal::StateImpl;
+};
+
 ///
 /// @class State
 /// @brief Manages game states in Shogi.
@@ -55,6 +82,25 @@ class State {
     ///
     State clone() const;
 
+    ///
+    /// @brief Take a snapshot of the current position.
+    /// @param HistoryLength How many of the last moves to keep, up to
+    /// `StateSnapshot::MaxHistoryLength` and the moves in the history.
+    ///
+    StateSnapshot snapshot(uint16_t HistoryLength = 0) const noexcept;
+
+    ///
+    /// @brief Reset the state to a snapshot.
+    ///
+    /// The history is replaced by the one kept in the snapshot: the
+    /// position before its moves becomes the initial position, so that
+    /// `getPly(false)` is the number of the kept moves and the repetition
+    /// detection sees them and the moves applied after this call. The
+    /// kept moves themselves cannot be undone. The memory held for the
+    /// history is reused.
+    ///
+    void restore(const StateSnapshot& Snapshot) noexcept;
+
     ///
     /// @brief Get the current color to play.
     ///
@@ -83,6 +129,7 @@ class State {
 
     ///
     /// @brief Get the last history move.
+    /// @return `Move32::MoveNone()` if the history is empty.
     ///
     Move32 getLastMove() const;
 
@@ -168,14 +215,32 @@ class State {
     ///
     bool isLegal(Move32 Move) const noexcept;
 
+    ///
+    /// @brief Check if a move from
+    /// `MoveGenerator::generatePseudoLegalMoves()` is legal.
+    ///
+    /// Only the checks skipped by the generator are done, namely whether the
+    /// king is left in check by a king move or by moving a pinned piece, so
+    /// it costs much less than `isLegal(Move32)`. The result is meaningless
+    /// for other moves.
+    ///
+    /// @param Move A pseudo-legal move in the current state.
+    ///
+    bool isPseudoLegalMoveLegal(Move32 Move) const noexcept;
+
  protected:
     internal::StateImpl* Impl;
 
+    // The arena `Impl` is given back to, or nullptr if it is heap-owned.
+    StateArena* Arena;
+
  private:
     State() = delete;
     State(const Position& P);
     State(const Position& P, uint16_t Ply);
     State(const Position& CurrentP, const Position& InitP);
+    State(const StateSnapshot& Snapshot);
+    State(const Position& P, uint16_t Ply, StateArena& SA);
 
     State(internal::StateImpl* SI);
 
@@ -0,0 +1,55 @@
+//
+// Copyright (c) 2025-2026 @nyashiki
+//
+// This software is licensed under the MIT license.
+// For details, see the LICENSE file in the root of this repository.
+//
+// SPDX-License-Identifier: MIT
+//
+
+#include "statearena.h"
+#include "internal/stateimpl.h"
+
+namespace nshogi {
+namespace core {
+
+StateArena::StateArena() {
+}
+
+StateArena::~StateArena() {
+    clear();
+}
+
+std::size_t StateArena::size() const noexcept {
+    return Pool.size();
+}
+
+void StateArena::clear() noexcept {
+    for (internal::StateImpl* SI : Pool) {
+        delete SI;
+    }
+    Pool.clear();
+}
+
+internal::StateImpl* StateArena::acquire(const Position& Pos, uint16_t Ply) {
+    if (Pool.empty()) {
+        return new internal::StateImpl(Pos, Ply);
+    }
+
+    internal::StateImpl* SI = Pool.back();
+    Pool.pop_back();
+    SI->reset(Pos, Ply);
+    return SI;
+}
+
+void StateArena::release(internal::StateImpl* SI) noexcept {
+    // Growing the pool can throw, in which case the memory is just freed.
+    try {
+        Pool.push_back(SI);
+    } catch (...) {
+        delete SI;
+    }
+}
+
+} // namespace core
+} // namespace nshogi
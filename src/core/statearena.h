@@ -0,0 +1,75 @@
+//
+// Copyright (c) 2025-2026 @nyashiki
+//
+// This software is licensed under the MIT license.
+// For details, see the LICENSE file in the root of this repository.
+//
+// SPDX-License-Identifier: MIT
+//
+
+#ifndef NSHOGI_CORE_STATEARENA_H
+#define NSHOGI_CORE_STATEARENA_H
+
+#include "position.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace nshogi {
+namespace core {
+
+namespace internal {
+
+class StateImpl;
+
+} // namespace internal
+
+class State;
+
+///
+/// @class StateArena
+/// @brief Recycles the memory of the states built with it.
+///
+/// Building a `State` allocates its implementation and reserves room for
+/// its move history on the heap. A state built with an arena (see
+/// `StateBuilder::newState()`) takes both from the arena instead and gives
+/// them back on destruction, with their capacity, so that once the arena
+/// has warmed up, building and destroying states allocates nothing.
+///
+/// An arena is not thread-safe: use one per thread, and destroy the states
+/// built with it on that thread and before the arena itself.
+///
+class StateArena {
+ public:
+    StateArena();
+    ~StateArena();
+
+    StateArena(const StateArena&) = delete;
+    StateArena(StateArena&&) = delete;
+    StateArena& operator=(const StateArena&) = delete;
+    StateArena& operator=(StateArena&&) = delete;
+
+    ///
+    /// @brief Get the number of released states held for reuse.
+    ///
+    std::size_t size() const noexcept;
+
+    ///
+    /// @brief Free the memory of the released states.
+    ///
+    void clear() noexcept;
+
+ private:
+    internal::StateImpl* acquire(const Position& Pos, uint16_t Ply);
+    void release(internal::StateImpl* SI) noexcept;
+
+    std::vector<internal::StateImpl*> Pool;
+
+    friend class State;
+};
+
+} // namespace core
+} // namespace nshogi
+
+#endif // #ifndef NSHOGI_CORE_STATEARENA_H
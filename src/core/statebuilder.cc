@@ -26,6 +26,12 @@ StateBuilder::StateBuilder(const Position& Pos, uint16_t Ply)
     Adapter->refresh();
 }
 
+StateBuilder::StateBuilder(const Position& Pos, uint16_t Ply, StateArena& SA)
+    : Instance(Pos, Ply, SA) {
+    internal::MutableStateAdapter Adapter(Instance);
+    Adapter->refresh();
+}
+
 State StateBuilder::build() {
     return std::move(Instance);
 }
@@ -46,5 +52,15 @@ State StateBuilder::newState(const Position& Pos, uint16_t Ply) {
     return Builder.build();
 }
 
+State StateBuilder::newState(const Position& Pos, uint16_t Ply,
+                             StateArena& SA) {
+    StateBuilder Builder(Pos, Ply, SA);
+    return Builder.build();
+}
+
+State StateBuilder::newState(const StateSnapshot& Snapshot) {
+    return State(Snapshot);
+}
+
 } // namespace core
 } // namespace nshogi
@@ -11,6 +11,7 @@
 #define NSHOGI_CORE_STATEBUILDER_H
 
 #include "state.h"
+#include "statearena.h"
 #include "types.h"
 #include <memory>
 #include <utility>
@@ -27,9 +28,17 @@ class StateBuilder {
     static core::State newState(const Position&);
     static core::State newState(const Position&, uint16_t Ply);
 
+    // The state starts from the snapshot with an empty history and only
+    // reserves room for a short one, which suits playouts.
+    static core::State newState(const StateSnapshot&);
+
+    // The state takes its memory from the arena; see `StateArena`.
+    static core::State newState(const Position&, uint16_t Ply, StateArena&);
+
  protected:
     StateBuilder(const Position&);
     StateBuilder(const Position&, uint16_t Ply);
+    StateBuilder(const Position&, uint16_t Ply, StateArena&);
     State Instance;
 };
 
@@ -74,6 +74,11 @@ core::State SimpleTeacher::getState() const {
                                         Ply);
 }
 
+core::State SimpleTeacher::getState(core::StateArena& Arena) const {
+    return core::StateBuilder::newState(core::HuffmanCode::decode(HuffmanCode),
+                                        Ply, Arena);
+}
+
 core::StateConfig SimpleTeacher::getConfig() const {
     core::StateConfig Config;
     Config.Rule = core::EndingRule::ER_Declare27;
@@ -13,6 +13,7 @@
 #include "../core/huffman.h"
 #include "../core/position.h"
 #include "../core/state.h"
+#include "../core/statearena.h"
 #include "../core/stateconfig.h"
 #include "../core/types.h"
 
@@ -39,6 +40,7 @@ struct SimpleTeacher {
     const core::HuffmanCode& getHuffmanCode() const;
     core::Position getPosition() const;
     core::State getState() const;
+    core::State getState(core::StateArena& Arena) const;
     core::StateConfig getConfig() const;
     core::Move16 getNextMove() const;
     core::Color getWinner() const;
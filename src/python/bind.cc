@@ -38,7 +38,9 @@
 #include "../ml/utils.h"
 
 #include <cstring>
+#include <optional>
 #include <string>
+#include <utility>
 #include <vector>
 
 namespace {
@@ -76,6 +78,33 @@ class PyFeatureStack {
     nshogi::ml::FeatureStackRuntime FeatureStack;
 };
 
+pybind11::dict
+dfpnStatisticsToDict(const nshogi::solver::dfpn::Statistics& Stats) {
+    const auto TableToDict =
+        [](const nshogi::solver::dfpn::Statistics::Table& Table) {
+            pybind11::dict Dict;
+            Dict["hits"] = Table.Hits;
+            Dict["misses"] = Table.Misses;
+            Dict["replacements"] = Table.Replacements;
+            return Dict;
+        };
+
+    pybind11::dict Dict;
+    Dict["enabled"] = Stats.Enabled;
+    Dict["node_tt"] = TableToDict(Stats.NodeTT);
+    Dict["edge_tt"] = TableToDict(Stats.EdgeTT);
+    Dict["domination_hits"] = Stats.DominationHits;
+    Dict["repetition_cutoffs"] = Stats.RepetitionCutoffs;
+    Dict["attacker_nodes"] = Stats.AttackerNodes;
+    Dict["defender_nodes"] = Stats.DefenderNodes;
+    Dict["attacker_branching_factor"] = Stats.attackerBranchingFactor();
+    Dict["defender_branching_factor"] = Stats.defenderBranchingFactor();
+    Dict["max_depth_reached"] = Stats.MaxDepthReached;
+    Dict["move_generation_ns"] = Stats.MoveGenerationNanoseconds;
+    Dict["tt_ns"] = Stats.TTNanoseconds;
+    return Dict;
+}
+
 template <typename ExtractorType>
 pybind11::tuple extractorIdsToNumpy(const ExtractorType& Extractor,
                                     const nshogi::core::State& State) {
@@ -347,24 +376,204 @@ PYBIND11_MODULE(nshogi, Module) {
     auto SolverModule = Module.def_submodule("solver");
     SolverModule.def("dfs", &nshogi::solver::dfs::solve);
 
+    pybind11::class_<nshogi::solver::dfs::Solver>(SolverModule, "Dfs")
+        .def(pybind11::init<std::size_t>(), pybind11::arg("memory_kb") = 1024)
+        .def("solve", &nshogi::solver::dfs::Solver::solve,
+             pybind11::arg("state"), pybind11::arg("limit"))
+        .def("searched_node_count",
+             &nshogi::solver::dfs::Solver::searchedNodeCount);
+
     pybind11::class_<nshogi::solver::dfpn::Solver>(SolverModule, "DfPn")
-        .def(pybind11::init<std::size_t>(), pybind11::arg("memory_mb"))
+        .def(pybind11::init([](std::size_t MemoryMB, std::size_t NumThreads,
+                               bool HugePages, bool NumaInterleave) {
+                 nshogi::solver::dfpn::MemoryOptions Options;
+                 Options.HugePages = HugePages;
+                 if (NumaInterleave) {
+                     Options.Numa =
+                         nshogi::solver::dfpn::NumaPolicy::Interleave;
+                 }
+                 return std::make_unique<nshogi::solver::dfpn::Solver>(
+                     MemoryMB, NumThreads, Options);
+             }),
+             pybind11::arg("memory_mb"), pybind11::arg("num_threads") = 1,
+             pybind11::arg("huge_pages") = false,
+             pybind11::arg("numa_interleave") = false)
+        .def("memory_report",
+             [](const nshogi::solver::dfpn::Solver& Solver) {
+                 const auto Report = Solver.memoryReport();
+                 pybind11::dict Dict;
+                 Dict["explicit_huge_page_bytes"] =
+                     Report.ExplicitHugePageBytes;
+                 Dict["transparent_huge_page_bytes"] =
+                     Report.TransparentHugePageBytes;
+                 Dict["standard_page_bytes"] = Report.StandardPageBytes;
+                 Dict["numa_policy_applied_count"] =
+                     Report.NumaPolicyAppliedCount;
+                 return Dict;
+             })
+        .def("node_tt_hits",
+             [](const nshogi::solver::dfpn::Solver& Solver) {
+                 const auto Hits = Solver.nodeTTHits();
+                 pybind11::dict Dict;
+                 Dict["exact"] = Hits.Exact;
+                 Dict["dominated"] = Hits.Dominated;
+                 return Dict;
+             })
+        .def("statistics",
+             [](const nshogi::solver::dfpn::Solver& Solver) {
+                 return dfpnStatisticsToDict(Solver.statistics());
+             })
+        .def("thread_statistics",
+             [](const nshogi::solver::dfpn::Solver& Solver) {
+                 pybind11::list List;
+                 for (const auto& Stats : Solver.threadStatistics()) {
+                     List.append(dfpnStatisticsToDict(Stats));
+                 }
+                 return List;
+             })
+        .def("save_tt", &nshogi::solver::dfpn::Solver::saveTT,
+             pybind11::arg("path"))
+        .def("load_tt", &nshogi::solver::dfpn::Solver::loadTT,
+             pybind11::arg("path"))
+        .def("set_proof_tree_retention",
+             &nshogi::solver::dfpn::Solver::setProofTreeRetention,
+             pybind11::arg("memory_mb"))
+        .def(
+            "set_heuristics",
+            [](nshogi::solver::dfpn::Solver& Solver, bool InitialNumbers,
+               double ThresholdEpsilon) {
+                nshogi::solver::dfpn::Heuristics H;
+                H.InitialNumbers = InitialNumbers;
+                H.ThresholdEpsilon = ThresholdEpsilon;
+                Solver.setHeuristics(H);
+            },
+            pybind11::arg("initial_numbers") = false,
+            pybind11::arg("threshold_epsilon") = 0.0)
+        .def(
+            "set_garbage_collection",
+            [](nshogi::solver::dfpn::Solver& Solver, double FillRateThreshold,
+               double Ratio) {
+                nshogi::solver::dfpn::GarbageCollection GC;
+                GC.FillRateThreshold = FillRateThreshold;
+                GC.Ratio = Ratio;
+                Solver.setGarbageCollection(GC);
+            },
+            pybind11::arg("fill_rate_threshold") = 0.7,
+            pybind11::arg("ratio") = 0.5)
+        .def("set_time_limit", &nshogi::solver::dfpn::Solver::setTimeLimit,
+             pybind11::arg("milliseconds"))
+        .def("stop", &nshogi::solver::dfpn::Solver::stop)
+        .def(
+            "set_progress_callback",
+            [](nshogi::solver::dfpn::Solver& Solver,
+               std::optional<pybind11::function> Callback,
+               uint64_t IntervalMilliseconds) {
+                if (!Callback.has_value()) {
+                    Solver.setProgressCallback(nullptr);
+                    return;
+                }
+                Solver.setProgressCallback(
+                    [Callback = std::move(*Callback)](
+                        const nshogi::solver::dfpn::Progress& P) {
+                        // `solve()` runs without the GIL.
+                        pybind11::gil_scoped_acquire Acquire;
+                        pybind11::dict Dict;
+                        Dict["node_count"] = P.NodeCount;
+                        Dict["elapsed_ms"] = P.ElapsedMilliseconds;
+                        Dict["nodes_per_second"] = P.NodesPerSecond;
+                        Dict["root_proof_number"] = P.RootProofNumber;
+                        Dict["root_disproof_number"] = P.RootDisproofNumber;
+                        Dict["tt_fill_rate"] = P.TTFillRate;
+                        Callback(Dict);
+                    },
+                    IntervalMilliseconds);
+            },
+            pybind11::arg("callback"), pybind11::arg("interval_ms") = 1000)
         .def(
             "solve",
             [](nshogi::solver::dfpn::Solver& Solver, nshogi::core::State& State,
                bool WithPV, uint64_t MaxNodeCount, uint64_t MaxDepth) {
+                // Release the GIL so that `stop()` can be called from
+                // another Python thread.
                 if (WithPV) {
-                    return pybind11::cast(
-                        Solver.solveWithPV(&State, MaxNodeCount, MaxDepth));
+                    std::vector<nshogi::core::Move32> PV;
+                    {
+                        pybind11::gil_scoped_release Release;
+                        PV = Solver.solveWithPV(&State, MaxNodeCount,
+                                                MaxDepth);
+                    }
+                    return pybind11::cast(PV);
                 } else {
-                    return pybind11::cast(
-                        Solver.solve(&State, MaxNodeCount, MaxDepth));
+                    nshogi::core::Move32 Move =
+                        nshogi::core::Move32::MoveNone();
+                    {
+                        pybind11::gil_scoped_release Release;
+                        Move = Solver.solve(&State, MaxNodeCount, MaxDepth);
+                    }
+                    return pybind11::cast(Move);
                 }
             },
             pybind11::arg("state"), pybind11::arg("with_pv") = true,
             pybind11::arg("max_node_count") = 0,
             pybind11::arg("max_depth") = 0);
 
+    pybind11::class_<nshogi::solver::dfpn::BatchedSolver>(SolverModule,
+                                                          "BatchedDfPn")
+        .def(pybind11::init<std::size_t, std::size_t>(),
+             pybind11::arg("memory_mb"), pybind11::arg("num_workers"))
+        .def_property_readonly("num_workers",
+                               &nshogi::solver::dfpn::BatchedSolver::numWorkers)
+        .def(
+            "solve",
+            [](nshogi::solver::dfpn::BatchedSolver& Solver,
+               const std::vector<nshogi::core::State*>& States,
+               const std::vector<uint64_t>& MaxNodeCounts, bool WithPV,
+               uint64_t MaxDepth) {
+                if (WithPV) {
+                    std::vector<std::vector<nshogi::core::Move32>> PVs;
+                    {
+                        pybind11::gil_scoped_release Release;
+                        PVs = Solver.solveWithPV(States, MaxNodeCounts,
+                                                 MaxDepth);
+                    }
+                    return pybind11::cast(PVs);
+                } else {
+                    std::vector<nshogi::core::Move32> Moves;
+                    {
+                        pybind11::gil_scoped_release Release;
+                        Moves = Solver.solve(States, MaxNodeCounts, MaxDepth);
+                    }
+                    return pybind11::cast(Moves);
+                }
+            },
+            pybind11::arg("states"), pybind11::arg("max_node_counts"),
+            pybind11::arg("with_pv") = false, pybind11::arg("max_depth") = 0)
+        .def(
+            "solve_sfens",
+            [](nshogi::solver::dfpn::BatchedSolver& Solver,
+               const std::vector<std::string>& Sfens,
+               const std::vector<uint64_t>& MaxNodeCounts, bool WithPV,
+               uint64_t MaxDepth) {
+                if (WithPV) {
+                    std::vector<std::vector<nshogi::core::Move32>> PVs;
+                    {
+                        pybind11::gil_scoped_release Release;
+                        PVs = Solver.solveWithPV(Sfens, MaxNodeCounts,
+                                                 MaxDepth);
+                    }
+                    return pybind11::cast(PVs);
+                } else {
+                    std::vector<nshogi::core::Move32> Moves;
+                    {
+                        pybind11::gil_scoped_release Release;
+                        Moves = Solver.solve(Sfens, MaxNodeCounts, MaxDepth);
+                    }
+                    return pybind11::cast(Moves);
+                }
+            },
+            pybind11::arg("sfens"), pybind11::arg("max_node_counts"),
+            pybind11::arg("with_pv") = false, pybind11::arg("max_depth") = 0);
+
     auto IOModule = Module.def_submodule("io");
     auto SfenModule = IOModule.def_submodule("sfen");
 
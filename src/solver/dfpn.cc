@@ -8,14 +8,21 @@
 //
 
 #include "dfpn.h"
+#include "../io/sfen.h"
+#include "internal/batcheddfpn.h"
 #include "internal/dfpn.h"
 
+#include <stdexcept>
+#include <utility>
+
 namespace nshogi {
 namespace solver {
 namespace dfpn {
 
-Solver::Solver(std::size_t MemoryMB)
-    : Impl(std::make_unique<internal::dfpn::SolverImpl>(MemoryMB)) {
+Solver::Solver(std::size_t MemoryMB, std::size_t NumThreads,
+               const MemoryOptions& Options)
+    : Impl(std::make_unique<internal::dfpn::SolverImpl>(MemoryMB, NumThreads,
+                                                        Options)) {
 }
 
 Solver::~Solver() {
@@ -36,6 +43,150 @@ uint64_t Solver::searchedNodeCount() const {
     return Impl->searchedNodeCount();
 }
 
+solver::dfpn::NodeTTHits Solver::nodeTTHits() const {
+    return Impl->nodeTTHits();
+}
+
+Statistics Solver::statistics() const {
+    return Impl->statistics();
+}
+
+std::vector<Statistics> Solver::threadStatistics() const {
+    return Impl->threadStatistics();
+}
+
+std::size_t Solver::numThreads() const {
+    return Impl->numThreads();
+}
+
+MemoryReport Solver::memoryReport() const {
+    return Impl->memoryReport();
+}
+
+std::size_t Solver::saveTT(const std::string& Path) const {
+    return Impl->saveTT(Path);
+}
+
+std::size_t Solver::loadTT(const std::string& Path) {
+    return Impl->loadTT(Path);
+}
+
+void Solver::setProofTreeRetention(std::size_t MemoryMB) {
+    Impl->setProofTreeRetention(MemoryMB);
+}
+
+void Solver::setHeuristics(const Heuristics& H) {
+    Impl->setHeuristics(H);
+}
+
+void Solver::setGarbageCollection(const GarbageCollection& GC) {
+    Impl->setGarbageCollection(GC);
+}
+
+void Solver::setTimeLimit(uint64_t Milliseconds) {
+    Impl->setTimeLimit(Milliseconds);
+}
+
+void Solver::stop() {
+    Impl->stop();
+}
+
+void Solver::setProgressCallback(ProgressCallback Callback,
+                                 uint64_t IntervalMilliseconds) {
+    Impl->setProgressCallback(std::move(Callback), IntervalMilliseconds);
+}
+
+namespace {
+
+void checkBatchSize(std::size_t NumProblems, std::size_t NumMaxNodeCounts) {
+    if (NumProblems != NumMaxNodeCounts) {
+        throw std::invalid_argument(
+            "MaxNodeCounts must have the same size as the problems.");
+    }
+}
+
+} // namespace
+
+BatchedSolver::BatchedSolver(std::size_t MemoryMB, std::size_t NumWorkers,
+                             const MemoryOptions& Options)
+    : Impl(std::make_unique<internal::dfpn::BatchedSolverImpl>(
+          MemoryMB, NumWorkers, Options)) {
+}
+
+BatchedSolver::~BatchedSolver() {
+}
+
+std::vector<core::Move32>
+BatchedSolver::solve(std::span<core::State* const> States,
+                     std::span<const uint64_t> MaxNodeCounts, uint64_t MaxDepth,
+                     bool Strict) {
+    checkBatchSize(States.size(), MaxNodeCounts.size());
+
+    std::vector<core::Move32> Results(States.size(),
+                                      core::Move32::MoveNone());
+    Impl->run(States.size(),
+              [&](internal::dfpn::SolverImpl* Solver, std::size_t I) {
+                  Results[I] = Solver->solve(States[I], MaxNodeCounts[I],
+                                             MaxDepth, Strict);
+              });
+    return Results;
+}
+
+std::vector<core::Move32>
+BatchedSolver::solve(std::span<const std::string> Sfens,
+                     std::span<const uint64_t> MaxNodeCounts, uint64_t MaxDepth,
+                     bool Strict) {
+    checkBatchSize(Sfens.size(), MaxNodeCounts.size());
+
+    std::vector<core::Move32> Results(Sfens.size(), core::Move32::MoveNone());
+    Impl->run(Sfens.size(),
+              [&](internal::dfpn::SolverImpl* Solver, std::size_t I) {
+                  auto State = io::sfen::StateBuilder::newState(Sfens[I]);
+                  Results[I] = Solver->solve(&State, MaxNodeCounts[I],
+                                             MaxDepth, Strict);
+              });
+    return Results;
+}
+
+std::vector<std::vector<core::Move32>>
+BatchedSolver::solveWithPV(std::span<core::State* const> States,
+                           std::span<const uint64_t> MaxNodeCounts,
+                           uint64_t MaxDepth, bool Strict) {
+    checkBatchSize(States.size(), MaxNodeCounts.size());
+
+    std::vector<std::vector<core::Move32>> Results(States.size());
+    Impl->run(States.size(),
+              [&](internal::dfpn::SolverImpl* Solver, std::size_t I) {
+                  Results[I] = Solver->solveWithPV(States[I], MaxNodeCounts[I],
+                                                   MaxDepth, Strict);
+              });
+    return Results;
+}
+
+std::vector<std::vector<core::Move32>>
+BatchedSolver::solveWithPV(std::span<const std::string> Sfens,
+                           std::span<const uint64_t> MaxNodeCounts,
+                           uint64_t MaxDepth, bool Strict) {
+    checkBatchSize(Sfens.size(), MaxNodeCounts.size());
+
+    std::vector<std::vector<core::Move32>> Results(Sfens.size());
+    Impl->run(Sfens.size(),
+              [&](internal::dfpn::SolverImpl* Solver, std::size_t I) {
+                  auto State = io::sfen::StateBuilder::newState(Sfens[I]);
+                  Results[I] = Solver->solveWithPV(&State, MaxNodeCounts[I],
+                                                   MaxDepth, Strict);
+              });
+    return Results;
+}
+
+std::size_t BatchedSolver::numWorkers() const {
+    return Impl->numWorkers();
+}
+
+MemoryReport BatchedSolver::memoryReport() const {
+    return Impl->memoryReport();
+}
+
 } // namespace dfpn
 } // namespace solver
 } // namespace nshogi
@@ -7,7 +7,10 @@
 // SPDX-License-Identifier: MIT
 //
 
+#include <functional>
 #include <memory>
+#include <span>
+#include <string>
 #include <vector>
 
 #ifndef NSHOGI_SOLVER_DFPN_H
@@ -23,15 +26,182 @@ namespace internal {
 namespace dfpn {
 
 class SolverImpl;
+class BatchedSolverImpl;
 
 } // namespace dfpn
 } // namespace internal
 
 namespace dfpn {
 
+enum class NumaPolicy {
+    Default,    ///< Leave the placement to the kernel (first touch).
+    Interleave, ///< Interleave the pages across all online NUMA nodes.
+    Bind,       ///< Bind the pages to `MemoryOptions::NumaNode`.
+};
+
+///
+/// @brief How the transposition tables are allocated.
+///
+/// Every request falls back gracefully: if huge pages or the NUMA policy
+/// are not available, the tables are backed by ordinary pages.
+///
+struct MemoryOptions {
+    /// Back the tables with huge pages. Explicit huge pages (MAP_HUGETLB)
+    /// are tried first, then transparent huge pages (MADV_HUGEPAGE).
+    bool HugePages = false;
+
+    NumaPolicy Numa = NumaPolicy::Default;
+
+    /// The node used by `NumaPolicy::Bind`.
+    int NumaNode = 0;
+};
+
+///
+/// @brief How the transposition tables were actually allocated.
+///
+struct MemoryReport {
+    std::size_t ExplicitHugePageBytes = 0;
+    std::size_t TransparentHugePageBytes = 0;
+    std::size_t StandardPageBytes = 0;
+
+    /// The number of tables to which the requested NUMA policy was applied.
+    std::size_t NumaPolicyAppliedCount = 0;
+};
+
+///
+/// @brief A snapshot of a running search, passed to the progress callback.
+///
+struct Progress {
+    uint64_t NodeCount = 0;
+    uint64_t ElapsedMilliseconds = 0;
+    double NodesPerSecond = 0.0;
+
+    uint32_t RootProofNumber = 0;
+    uint32_t RootDisproofNumber = 0;
+
+    /// The fraction of the sampled transposition table entries that were
+    /// written by the current search.
+    double TTFillRate = 0.0;
+};
+
+using ProgressCallback = std::function<void(const Progress&)>;
+
+///
+/// @brief Solved positions found in the transposition table by the last
+///        solve.
+///
+struct NodeTTHits {
+    /// Hits on an entry with exactly the same pieces in hand.
+    uint64_t Exact = 0;
+
+    /// Hits on an entry whose pieces in hand dominate the position's: a
+    /// proof with fewer pieces, or a disproof with more pieces.
+    uint64_t Dominated = 0;
+};
+
+///
+/// @brief Where a solve spent its work, for tuning and profiling.
+///
+/// The counters are collected only by a library built with
+/// `SOLVER_STATS=1`, which defines `NSHOGI_SOLVER_STATS`. In other builds
+/// the search does not touch them, `Enabled` is false and every counter is
+/// zero.
+///
+struct Statistics {
+    struct Table {
+        uint64_t Hits = 0;
+        uint64_t Misses = 0;
+
+        /// Stores that evicted a live entry of another position or edge.
+        uint64_t Replacements = 0;
+    };
+
+    bool Enabled = false;
+
+    Table NodeTT;
+    Table EdgeTT;
+
+    /// Node table hits on an entry with dominating pieces in hand.
+    uint64_t DominationHits = 0;
+
+    /// Nodes and edges cut off because they repeat a position.
+    uint64_t RepetitionCutoffs = 0;
+
+    /// Expanded nodes and the moves generated at them, by side.
+    uint64_t AttackerNodes = 0;
+    uint64_t AttackerMoves = 0;
+    uint64_t DefenderNodes = 0;
+    uint64_t DefenderMoves = 0;
+
+    /// The largest distance from the root of a searched node.
+    uint64_t MaxDepthReached = 0;
+
+    /// The time spent in move generation and in the transposition tables.
+    uint64_t MoveGenerationNanoseconds = 0;
+    uint64_t TTNanoseconds = 0;
+
+    double attackerBranchingFactor() const {
+        return AttackerNodes == 0
+                   ? 0.0
+                   : (double)AttackerMoves / (double)AttackerNodes;
+    }
+
+    double defenderBranchingFactor() const {
+        return DefenderNodes == 0
+                   ? 0.0
+                   : (double)DefenderMoves / (double)DefenderNodes;
+    }
+};
+
+///
+/// @brief Search heuristics that trade work per node for fewer nodes.
+///
+/// Both are off by default. They pay off on long mates, where the plain
+/// search spends most of its nodes on hopeless branches.
+///
+struct Heuristics {
+    /// Seed the children of defender nodes with df-pn+ style proof and
+    /// disproof numbers from mate-in-1 probes and check counts, instead of
+    /// the kind of the evasion only.
+    bool InitialNumbers = false;
+
+    /// Let a child be searched until it is `1 + ThresholdEpsilon` times as
+    /// hard as the second best sibling (the 1+epsilon trick). Zero keeps
+    /// the plain df-pn threshold; 0.25 works well on the bundled suites.
+    double ThresholdEpsilon = 0.0;
+};
+
+///
+/// @brief When a solve frees transposition table entries by itself.
+///
+/// Once the sampled fill rate of the edge table exceeds
+/// `FillRateThreshold`, the main thread frees about `Ratio` of the live edge
+/// entries, the least valuable ones: unsolved entries before solved ones,
+/// and within each, those with the fewest nodes searched below them. A
+/// freed entry costs a re-search at worst, while a table that stays full
+/// keeps evicting entries one at a time from every bundle it touches.
+///
+struct GarbageCollection {
+    /// A threshold of 1 or more disables the collection. Long searches
+    /// level off at a fill rate of about 0.8, so a higher threshold rarely
+    /// triggers.
+    double FillRateThreshold = 0.7;
+
+    /// The fraction of the live entries to free, in (0, 1].
+    double Ratio = 0.5;
+};
+
 class Solver {
  public:
-    Solver(std::size_t MemoryMB);
+    ///
+    /// @brief Create a df-pn solver.
+    /// @param MemoryMB The size of the transposition tables in megabytes.
+    /// @param NumThreads The number of threads searching the same root in
+    ///        parallel. All threads share the transposition tables.
+    /// @param Options How the transposition tables are allocated.
+    ///
+    Solver(std::size_t MemoryMB, std::size_t NumThreads = 1,
+           const MemoryOptions& Options = MemoryOptions());
     ~Solver();
 
     core::Move32 solve(core::State* S, uint64_t MaxNodeCount = 1000000,
@@ -42,11 +212,170 @@ class Solver {
                                           bool Strict = false);
 
     uint64_t searchedNodeCount() const;
+    std::size_t numThreads() const;
+    MemoryReport memoryReport() const;
+    NodeTTHits nodeTTHits() const;
+
+    ///
+    /// @brief The statistics of the last solve, summed over the threads.
+    ///
+    /// `MaxDepthReached` is the maximum over the threads. See `Statistics`
+    /// for the build flag that enables them.
+    ///
+    Statistics statistics() const;
+
+    /// The statistics of the last solve of each thread, the main one first.
+    std::vector<Statistics> threadStatistics() const;
+
+    ///
+    /// @brief Save the proven and disproven positions to a file.
+    /// @return The number of saved entries.
+    ///
+    /// The file is a fixed-layout binary snapshot (a versioned header and
+    /// 24-byte records), so it can be read in place by mapping it. The
+    /// disproofs of a solve that reached its `MaxDepth` are left out, since
+    /// they may not hold with another limit. A snapshot therefore holds for
+    /// searches with any depth limit.
+    ///
+    std::size_t saveTT(const std::string& Path) const;
+
+    ///
+    /// @brief Load a snapshot written by `saveTT()` to warm-start searches.
+    /// @return The number of loaded entries.
+    ///
+    /// The loaded entries survive every subsequent `solve()`. The solver
+    /// must have been created with the same `MemoryMB` as the one that
+    /// saved the snapshot; otherwise `std::runtime_error` is thrown.
+    ///
+    std::size_t loadTT(const std::string& Path);
+
+    ///
+    /// @brief Retain the proof tree of each solve in a side table.
+    /// @param MemoryMB The size of the side table in megabytes. Zero
+    ///        disables the retention and frees the table.
+    ///
+    /// With the retention enabled, `solveWithPV()` follows the retained
+    /// moves. While the proof is retained, each ply costs one move
+    /// generation and at most one side-table probe per move. At the
+    /// attacker's turn the walk takes the retained check with the fewest
+    /// plies to mate. A subtree whose proof is not retained (e.g. evicted
+    /// from the side table) is walked through the transposition table as
+    /// without the retention. That walk has no cost bound and may cost as
+    /// much as the solve.
+    ///
+    /// The PV is a mate, but not necessarily the shortest one. The search
+    /// stops at the first proof of each node and never looks for a shorter
+    /// one, so only the proofs it happened to find are compared.
+    ///
+    void setProofTreeRetention(std::size_t MemoryMB);
+
+    ///
+    /// @brief Select the search heuristics of each subsequent solve.
+    ///
+    void setHeuristics(const Heuristics& H);
+
+    ///
+    /// @brief Select the garbage collection of each subsequent solve.
+    ///
+    /// Throws `std::invalid_argument` if `Ratio` is not in (0, 1] or the
+    /// threshold is negative.
+    ///
+    void setGarbageCollection(const GarbageCollection& GC);
+
+    ///
+    /// @brief Limit the wall-clock time of each subsequent solve.
+    /// @param Milliseconds The time limit. Zero means no limit.
+    ///
+    /// A solve that runs out of time returns as if it had reached
+    /// `MaxNodeCount`, i.e., without a checkmate move.
+    ///
+    void setTimeLimit(uint64_t Milliseconds);
+
+    ///
+    /// @brief Stop the solve running on another thread.
+    ///
+    /// This is safe to call from any thread. The solve returns as soon as
+    /// possible without a checkmate move unless it has already proven one.
+    /// If no solve is running, the request stays pending and the next solve
+    /// returns immediately. It has no effect on the solves after that one.
+    ///
+    void stop();
+
+    ///
+    /// @brief Report the progress of each subsequent solve.
+    /// @param Callback Called on the solving thread every
+    ///        `IntervalMilliseconds` and once more when the solve finishes.
+    ///        An empty callback disables the reports.
+    /// @param IntervalMilliseconds The interval between two reports.
+    ///
+    void setProgressCallback(ProgressCallback Callback,
+                             uint64_t IntervalMilliseconds = 1000);
 
  private:
     std::unique_ptr<internal::dfpn::SolverImpl> Impl;
 };
 
+///
+/// @brief Solves many independent problems on a fixed pool of workers.
+///
+/// Each worker owns a single-threaded solver whose transposition tables are
+/// allocated once and reused for every problem, so the per-problem setup
+/// cost is negligible. Results are returned in the input order.
+///
+class BatchedSolver {
+ public:
+    ///
+    /// @brief Create a batched df-pn solver.
+    /// @param MemoryMB The size of the transposition tables of each worker
+    ///        in megabytes.
+    /// @param NumWorkers The number of worker threads.
+    /// @param Options How the transposition tables are allocated.
+    ///
+    BatchedSolver(std::size_t MemoryMB, std::size_t NumWorkers,
+                  const MemoryOptions& Options = MemoryOptions());
+    ~BatchedSolver();
+
+    ///
+    /// @brief Solve the given states.
+    /// @param States The states to solve. Each state is modified during the
+    ///        search and restored before returning, so a state must not
+    ///        appear twice in a batch.
+    /// @param MaxNodeCounts The node limit of each problem. Must have the
+    ///        same size as `States`.
+    /// @return The checkmate move of each state, or `Move32::MoveNone()`.
+    ///
+    std::vector<core::Move32> solve(std::span<core::State* const> States,
+                                    std::span<const uint64_t> MaxNodeCounts,
+                                    uint64_t MaxDepth = 64,
+                                    bool Strict = false);
+
+    ///
+    /// @brief Solve the positions given by SFEN strings.
+    ///
+    std::vector<core::Move32> solve(std::span<const std::string> Sfens,
+                                    std::span<const uint64_t> MaxNodeCounts,
+                                    uint64_t MaxDepth = 64,
+                                    bool Strict = false);
+
+    std::vector<std::vector<core::Move32>>
+    solveWithPV(std::span<core::State* const> States,
+                std::span<const uint64_t> MaxNodeCounts, uint64_t MaxDepth = 64,
+                bool Strict = false);
+
+    std::vector<std::vector<core::Move32>>
+    solveWithPV(std::span<const std::string> Sfens,
+                std::span<const uint64_t> MaxNodeCounts, uint64_t MaxDepth = 64,
+                bool Strict = false);
+
+    std::size_t numWorkers() const;
+
+    /// The sum over all workers.
+    MemoryReport memoryReport() const;
+
+ private:
+    std::unique_ptr<internal::dfpn::BatchedSolverImpl> Impl;
+};
+
 } // namespace dfpn
 } // namespace solver
 } // namespace nshogi
@@ -8,10 +8,7 @@
 //
 
 #include "dfs.h"
-#include "../core/internal/movegenerator.h"
-#include "../core/internal/stateadapter.h"
-#include "../core/internal/stateimpl.h"
-#include "internal/mate1ply.h"
+#include "internal/dfs.h"
 
 namespace nshogi {
 namespace solver {
@@ -19,93 +16,30 @@ namespace dfs {
 
 namespace {
 
-template <core::Color C>
-core::Move32 defence(core::internal::StateImpl* S, int Limit);
+// Short mates touch few positions, and a one-off table must be cheap to
+// allocate.
+constexpr std::size_t OneOffMemoryKB = 64;
 
-template <core::Color C>
-core::Move32 attack(core::internal::StateImpl* S, int Limit) {
-    if (Limit <= 0) {
-        return core::Move32::MoveNone();
-    }
-
-    const auto Move1Ply = internal::mate1ply::solve<C>(*S);
-
-    if (!Move1Ply.isNone()) {
-        return Move1Ply;
-    }
-
-    const auto CheckMoves = [&]() {
-        if (Limit > 3 && S->getStandCount<C, core::PTK_Pawn>() > 0) {
-            // Generate non-promoting moves to avoid utifu-dume rule.
-            return core::internal::MoveGeneratorInternal::
-                generateLegalCheckMoves<C, false>(*S);
-        } else {
-            return core::internal::MoveGeneratorInternal::
-                generateLegalCheckMoves<C, true>(*S);
-        }
-    }();
-
-    for (const core::Move32 Move : CheckMoves) {
-        S->doMove<C>(Move);
-
-        const auto CounterMove = defence<~C>(S, Limit - 1);
-
-        S->undoMove<~C>();
-
-        if (CounterMove.isNone()) {
-            return Move;
-        }
-    }
+} // namespace
 
-    return core::Move32::MoveNone();
+Solver::Solver(std::size_t MemoryKB)
+    : Impl(std::make_unique<internal::dfs::SolverImpl>(MemoryKB)) {
 }
 
-template <core::Color C>
-core::Move32 defence(core::internal::StateImpl* S, int Limit) {
-    assert(!S->getCheckerBB().isZero());
-
-    const auto DefenceMoves =
-        core::internal::MoveGeneratorInternal::generateLegalEvasionMoves<C,
-                                                                         true>(
-            *S);
-
-    if (Limit <= 1 && DefenceMoves.size() > 0) {
-        return DefenceMoves[0];
-    }
-
-    bool IsCheckmatedBy1Ply = true;
-    for (const core::Move32 Move : DefenceMoves) {
-        S->doMove<C>(Move);
-
-        const auto CheckMove = attack<~C>(S, Limit - 1);
-
-        S->undoMove<~C>();
-
-        if (CheckMove.isNone()) {
-            return Move;
-        }
-        IsCheckmatedBy1Ply = false;
-    }
-
-    const core::Move32 LastMove = S->getLastMove();
-    if (IsCheckmatedBy1Ply && LastMove.drop() &&
-        LastMove.pieceType() == core::PTK_Pawn) {
-        // Rule: utchifu-dume.
-        return core::Move32::MoveWin();
-    }
+Solver::~Solver() {
+}
 
-    return core::Move32::MoveNone();
+core::Move32 Solver::solve(core::State* S, int Limit) {
+    return Impl->solve(S, Limit);
 }
 
-} // namespace
+uint64_t Solver::searchedNodeCount() const {
+    return Impl->searchedNodeCount();
+}
 
 core::Move32 solve(core::State* S, int Limit) {
-    core::internal::MutableStateAdapter Adapter(*S);
-    if (S->getSideToMove() == core::Black) {
-        return attack<core::Black>(Adapter.get(), Limit);
-    } else {
-        return attack<core::White>(Adapter.get(), Limit);
-    }
+    internal::dfs::SolverImpl Impl(OneOffMemoryKB);
+    return Impl.solve(S, Limit);
 }
 
 } // namespace dfs
@@ -13,11 +13,54 @@
 #include "../core/state.h"
 #include "../core/types.h"
 
+#include <memory>
+
 namespace nshogi {
 namespace solver {
+
+namespace internal {
 namespace dfs {
 
-core::Move32 solve(core::State* S, int limit);
+class SolverImpl;
+
+} // namespace dfs
+} // namespace internal
+
+namespace dfs {
+
+///
+/// @brief An iterative-deepening search for short mates.
+///
+/// The transposition table is kept across solves, so a solver can be reused
+/// as a cheap first-pass filter over many positions before escalating the
+/// unsolved ones to df-pn.
+///
+class Solver {
+ public:
+    ///
+    /// @brief Create a solver.
+    /// @param MemoryKB The size of the transposition table in kilobytes.
+    ///
+    explicit Solver(std::size_t MemoryKB = 1024);
+    ~Solver();
+
+    ///
+    /// @brief Find a mate within `Limit` plies.
+    /// @return The first move of a shortest mate, or `Move32::MoveNone()`.
+    ///
+    core::Move32 solve(core::State* S, int Limit);
+
+    /// The number of nodes searched by the last solve.
+    uint64_t searchedNodeCount() const;
+
+ private:
+    std::unique_ptr<internal::dfs::SolverImpl> Impl;
+};
+
+///
+/// @brief Find a mate within `Limit` plies with a one-off solver.
+///
+core::Move32 solve(core::State* S, int Limit);
 
 } // namespace dfs
 } // namespace solver
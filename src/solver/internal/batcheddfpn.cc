@@ -0,0 +1,154 @@
+//
+// Copyright (c) 2025-2026 @nyashiki
+//
+// This software is licensed under the MIT license.
+// For details, see the LICENSE file in the root of this repository.
+//
+// SPDX-License-Identifier: MIT
+//
+
+#include "batcheddfpn.h"
+
+#include <stdexcept>
+
+namespace nshogi {
+namespace solver {
+namespace internal {
+namespace dfpn {
+
+BatchedSolverImpl::BatchedSolverImpl(
+    std::size_t MemoryMB, std::size_t NumWorkers,
+    const solver::dfpn::MemoryOptions& Options)
+    : Finished(false)
+    , BatchId(0)
+    , NumRunningWorkers(0)
+    , CurrentTask(nullptr)
+    , CurrentNumProblems(0)
+    , NextProblemIndex(0) {
+    if (NumWorkers == 0) {
+        throw std::invalid_argument("NumWorkers must be greater than 0.");
+    }
+
+    Solvers.reserve(NumWorkers);
+    for (std::size_t I = 0; I < NumWorkers; ++I) {
+        Solvers.emplace_back(
+            std::make_unique<SolverImpl>(MemoryMB, 1, Options));
+    }
+
+    Workers.reserve(NumWorkers);
+    for (std::size_t I = 0; I < NumWorkers; ++I) {
+        Workers.emplace_back(&BatchedSolverImpl::doTask, this, I);
+    }
+}
+
+BatchedSolverImpl::~BatchedSolverImpl() {
+    {
+        std::lock_guard<std::mutex> Lock(Mutex);
+        Finished = true;
+    }
+    WorkerCV.notify_all();
+
+    for (auto& Worker : Workers) {
+        if (Worker.joinable()) {
+            Worker.join();
+        }
+    }
+}
+
+solver::dfpn::MemoryReport BatchedSolverImpl::memoryReport() const {
+    solver::dfpn::MemoryReport Report;
+    for (const auto& Solver : Solvers) {
+        const auto R = Solver->memoryReport();
+        Report.ExplicitHugePageBytes += R.ExplicitHugePageBytes;
+        Report.TransparentHugePageBytes += R.TransparentHugePageBytes;
+        Report.StandardPageBytes += R.StandardPageBytes;
+        Report.NumaPolicyAppliedCount += R.NumaPolicyAppliedCount;
+    }
+    return Report;
+}
+
+void BatchedSolverImpl::run(std::size_t NumProblems, const TaskType& Task) {
+    if (NumProblems == 0) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> RunLock(RunMutex);
+
+    std::unique_lock<std::mutex> Lock(Mutex);
+    CurrentTask = &Task;
+    CurrentNumProblems = NumProblems;
+    NextProblemIndex.store(0);
+    Error = nullptr;
+    NumRunningWorkers = Workers.size();
+    ++BatchId;
+    Lock.unlock();
+
+    WorkerCV.notify_all();
+
+    Lock.lock();
+    CallerCV.wait(Lock, [this] { return NumRunningWorkers == 0; });
+    CurrentTask = nullptr;
+
+    if (Error != nullptr) {
+        std::exception_ptr E = Error;
+        Error = nullptr;
+        std::rethrow_exception(E);
+    }
+}
+
+void BatchedSolverImpl::doTask(std::size_t WorkerId) {
+    SolverImpl* Solver = Solvers[WorkerId].get();
+    uint64_t SeenBatchId = 0;
+
+    while (true) {
+        const TaskType* Task = nullptr;
+        std::size_t NumProblems = 0;
+
+        {
+            std::unique_lock<std::mutex> Lock(Mutex);
+            WorkerCV.wait(
+                Lock, [&] { return Finished || BatchId != SeenBatchId; });
+
+            if (Finished) {
+                break;
+            }
+
+            SeenBatchId = BatchId;
+            Task = CurrentTask;
+            NumProblems = CurrentNumProblems;
+        }
+
+        while (true) {
+            const std::size_t Index = NextProblemIndex.fetch_add(1);
+            if (Index >= NumProblems) {
+                break;
+            }
+
+            try {
+                (*Task)(Solver, Index);
+            } catch (...) {
+                std::lock_guard<std::mutex> Lock(Mutex);
+                if (Error == nullptr) {
+                    Error = std::current_exception();
+                }
+                // Skip the remaining problems of this batch.
+                NextProblemIndex.store(NumProblems);
+            }
+        }
+
+        {
+            // Take the lock so that the notification cannot fire between the
+            // caller's predicate check and its sleep (lost wakeup).
+            std::lock_guard<std::mutex> Lock(Mutex);
+            --NumRunningWorkers;
+            if (NumRunningWorkers == 0) {
+                CallerCV.notify_one();
+            }
+        }
+    }
+}
+
+} // namespace dfpn
+} // namespace internal
+} // namespace solver
+} // namespace nshogi
@@ -0,0 +1,85 @@
+//
+// Copyright (c) 2025-2026 @nyashiki
+//
+// This software is licensed under the MIT license.
+// For details, see the LICENSE file in the root of this repository.
+//
+// SPDX-License-Identifier: MIT
+//
+
+#include "dfpn.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#ifndef NSHOGI_SOLVER_INTERNAL_BATCHEDDFPN_H
+#define NSHOGI_SOLVER_INTERNAL_BATCHEDDFPN_H
+
+namespace nshogi {
+namespace solver {
+namespace internal {
+namespace dfpn {
+
+// A fixed pool of worker threads, each of which owns a single-threaded
+// df-pn solver. The transposition tables are allocated once and reused
+// across problems and batches; every problem only bumps the generation.
+class BatchedSolverImpl {
+ public:
+    using TaskType = std::function<void(SolverImpl*, std::size_t)>;
+
+    BatchedSolverImpl(std::size_t MemoryMB, std::size_t NumWorkers,
+                      const solver::dfpn::MemoryOptions& Options);
+    ~BatchedSolverImpl();
+
+    BatchedSolverImpl(const BatchedSolverImpl&) = delete;
+    BatchedSolverImpl& operator=(const BatchedSolverImpl&) = delete;
+    BatchedSolverImpl(BatchedSolverImpl&&) = delete;
+    BatchedSolverImpl& operator=(BatchedSolverImpl&&) = delete;
+
+    std::size_t numWorkers() const noexcept {
+        return Solvers.size();
+    }
+
+    solver::dfpn::MemoryReport memoryReport() const;
+
+    // Calls `Task(Solver, I)` for every I in [0, NumProblems) on the worker
+    // pool and blocks until all of them are done. The first exception
+    // thrown by a task is rethrown here.
+    void run(std::size_t NumProblems, const TaskType& Task);
+
+ private:
+    void doTask(std::size_t WorkerId);
+
+    std::vector<std::unique_ptr<SolverImpl>> Solvers;
+    std::vector<std::thread> Workers;
+
+    // Serializes concurrent calls of `run()`.
+    std::mutex RunMutex;
+
+    std::mutex Mutex;
+    std::condition_variable WorkerCV;
+    std::condition_variable CallerCV;
+    bool Finished;
+    uint64_t BatchId;
+    std::size_t NumRunningWorkers;
+
+    const TaskType* CurrentTask;
+    std::size_t CurrentNumProblems;
+    std::atomic<std::size_t> NextProblemIndex;
+    std::exception_ptr Error;
+};
+
+} // namespace dfpn
+} // namespace internal
+} // namespace solver
+} // namespace nshogi
+
+#endif // #ifndef NSHOGI_SOLVER_INTERNAL_BATCHEDDFPN_H
@@ -10,8 +10,16 @@
 #include "dfpn.h"
 #include "../../core/internal/movegenerator.h"
 #include "../../core/internal/stateadapter.h"
+#include "mate1ply.h"
 
 #include <algorithm>
+#include <bit>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
 
 namespace nshogi {
 namespace solver {
@@ -34,13 +42,94 @@ uint32_t initialDisproofNumber(core::Move32 Evasion) {
     return 3;
 }
 
+uint32_t inflate(uint32_t Number, uint32_t VirtualNumber) {
+    // Solved values stay solved, and unsolved ones never look solved so that
+    // a helper thread never abandons the root only because of its peers.
+    if (Number == 0 || Number >= DfPnValue::Infinity) {
+        return Number;
+    }
+    return std::min(DfPnValue::Infinity - 1, Number + VirtualNumber);
+}
+
+// A value relying only on repetitions within the subtree of a node is found
+// from every path to the node, so it is path-independent there.
+int32_t resolveRepetitionDepth(int32_t RepetitionDepth, uint64_t Depth) {
+    return (RepetitionDepth >= (int32_t)Depth) ? DfPnValue::NoRepetitionDepth
+                                               : RepetitionDepth;
+}
+
+// The key of the path extended by `Move` played at `Depth`. Each term mixes
+// the move with its depth, so the key identifies the sequence of moves.
+uint64_t childPathKey(uint64_t PathKey, core::Move32 Move, uint64_t Depth) {
+    uint64_t Key = ((uint64_t)core::Move16(Move).value() << 32 | Depth) +
+                   0x9e3779b97f4a7c15ULL;
+    Key = (Key ^ (Key >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    Key = (Key ^ (Key >> 27)) * 0x94d049bb133111ebULL;
+    return PathKey ^ Key ^ (Key >> 31);
+}
+
+// On-disk snapshot of the solved node entries. Every field has a fixed
+// width and the records are 8-byte aligned, so that a file can also be
+// mapped into memory and read in place.
+struct TTFileHeader {
+    char Magic[8];
+    uint32_t Version;
+    uint32_t RecordSize;
+    uint64_t NodeTTSize;
+    uint64_t NumRecords;
+};
+
+struct TTFileRecord {
+    uint64_t BundleIndex;
+    DfPnNodeTTEntry Entry;
+};
+
+constexpr char TTFileMagic[8] = {'N', 'S', 'D', 'F', 'P', 'N', 'T', 'T'};
+constexpr uint32_t TTFileVersion = 2;
+
+static_assert(sizeof(TTFileHeader) == 32);
+static_assert(sizeof(TTFileRecord) == 24);
+
 } // namespace
 
-SolverImpl::SolverImpl(std::size_t MemoryMB) {
+SolverImpl::SolverImpl(std::size_t MemoryMB, std::size_t NThreads,
+                       const solver::dfpn::MemoryOptions& Options)
+    : ProofTableSize(0)
+    , TableOptions(Options)
+    , NumThreads(std::max<std::size_t>(1, NThreads))
+    , NodeTTLockCount(0)
+    , EdgeTTLockCount(0)
+    , SearchingCountSize(0)
+    , IsDepthLimited(false)
+    , DepthLimitedGenerations(1 << 16, false)
+    , SearchedNodeCount(0)
+    , RootPly(0)
+    , ExactNodeHitCount(0)
+    , DominatedNodeHitCount(0)
+    , ThreadStatistics(NumThreads)
+    , StopRequested(false)
+    , IsRootSolved(false)
+    , RootBestMove(core::Move32::MoveNone())
+    , UseHeuristicNumbers(false)
+    , ThresholdEpsilonScaled(0)
+    , CollectionFillRateThreshold(
+          solver::dfpn::GarbageCollection().FillRateThreshold)
+    , CollectionRatio(solver::dfpn::GarbageCollection().Ratio)
+    , TimeLimitMilliseconds(0)
+    , ProgressIntervalMilliseconds(0)
+    , IsClockUsed(false)
+    , RootProofNumber(1)
+    , RootDisproofNumber(1) {
     static_assert(sizeof(DfPnNodeTTEntry) == 16);
     static_assert(sizeof(DfPnNodeTTBundle) == 256);
     static_assert(sizeof(DfPnEdgeTTEntry) == 16);
     static_assert(sizeof(DfPnEdgeTTBundle) == 256);
+    static_assert(sizeof(DfPnProofEntry) == 16);
+    static_assert(sizeof(DfPnProofBundle) == 64);
+
+    for (auto& Stats : ThreadStatistics) {
+        Stats.Enabled = StatisticsEnabled;
+    }
 
     const std::size_t TotalMemoryBytes = MemoryMB * 1024ULL * 1024ULL;
     const std::size_t NodeMemoryBytes = TotalMemoryBytes / 8;
@@ -48,16 +137,35 @@ SolverImpl::SolverImpl(std::size_t MemoryMB) {
 
     NodeTTSize =
         std::max<std::size_t>(1, NodeMemoryBytes / sizeof(DfPnNodeTTBundle));
-    NodeTT = std::make_unique<DfPnNodeTTBundle[]>(NodeTTSize);
+    NodeTT.allocate(NodeTTSize, Options);
 
     EdgeTTSize =
         std::max<std::size_t>(1, EdgeMemoryBytes / sizeof(DfPnEdgeTTBundle));
-    EdgeTT = std::make_unique<DfPnEdgeTTBundle[]>(EdgeTTSize);
+    EdgeTT.allocate(EdgeTTSize, Options);
+
+    if (NumThreads > 1) {
+        // Striped locks: enough stripes that two threads rarely wait on each
+        // other, but far fewer than bundles.
+        constexpr std::size_t MaxLockCount = 1ULL << 16;
+        NodeTTLockCount = std::min(std::bit_ceil(NodeTTSize), MaxLockCount);
+        NodeTTLocks = std::make_unique<SpinLock[]>(NodeTTLockCount);
+        EdgeTTLockCount = std::min(std::bit_ceil(EdgeTTSize), MaxLockCount);
+        EdgeTTLocks = std::make_unique<SpinLock[]>(EdgeTTLockCount);
+
+        SearchingCountSize = 1ULL << 16;
+        SearchingCounts =
+            std::make_unique<std::atomic<uint16_t>[]>(SearchingCountSize);
+        for (std::size_t I = 0; I < SearchingCountSize; ++I) {
+            SearchingCounts[I].store(0, std::memory_order_relaxed);
+        }
+    }
 
-    clearTT();
+    RepetitionTables = std::make_unique<DfPnRepetitionEntry[]>(
+        NumThreads * RepetitionTableSize);
 
+    // The tables are zero-initialized, so every entry already carries
+    // generation 0, which `solve()` never uses. No extra pass is needed.
     Generation = 0;
-    SearchedNodeCount = 0;
 }
 
 SolverImpl::~SolverImpl() {
@@ -65,7 +173,15 @@ SolverImpl::~SolverImpl() {
 
 void SolverImpl::clearTT() {
     for (std::size_t I = 0; I < NodeTTSize; ++I) {
+        // Keep loaded entries, packed at the front of the bundle since a
+        // probe stops at the first dead entry.
+        std::size_t Kept = 0;
         for (std::size_t J = 0; J < DfPnNodeTTBundle::BundleSize; ++J) {
+            if (NodeTT[I].Entries[J].generation() == PersistentGeneration) {
+                NodeTT[I].Entries[Kept++] = NodeTT[I].Entries[J];
+            }
+        }
+        for (std::size_t J = Kept; J < DfPnNodeTTBundle::BundleSize; ++J) {
             NodeTT[I].Entries[J].reset();
         }
     }
@@ -75,97 +191,578 @@ void SolverImpl::clearTT() {
             EdgeTT[I].Entries[J].setGeneration(0);
         }
     }
+
+    for (std::size_t I = 0; I < ProofTableSize; ++I) {
+        for (std::size_t J = 0; J < DfPnProofBundle::BundleSize; ++J) {
+            ProofTable[I].Entries[J].setGeneration(0);
+        }
+    }
+
+    for (std::size_t I = 0; I < NumThreads * RepetitionTableSize; ++I) {
+        RepetitionTables[I].Generation = 0;
+    }
+
+    std::fill(DepthLimitedGenerations.begin(), DepthLimitedGenerations.end(),
+              false);
+}
+
+void SolverImpl::setTimeLimit(uint64_t Milliseconds) {
+    TimeLimitMilliseconds = Milliseconds;
+}
+
+void SolverImpl::stop() {
+    StopRequested.store(true, std::memory_order_relaxed);
+}
+
+void SolverImpl::setProgressCallback(
+    solver::dfpn::ProgressCallback NewCallback, uint64_t IntervalMilliseconds) {
+    Callback = std::move(NewCallback);
+    ProgressIntervalMilliseconds = IntervalMilliseconds;
+}
+
+void SolverImpl::setHeuristics(const solver::dfpn::Heuristics& H) {
+    if (H.ThresholdEpsilon < 0) {
+        throw std::invalid_argument("ThresholdEpsilon must not be negative.");
+    }
+    UseHeuristicNumbers = H.InitialNumbers;
+    ThresholdEpsilonScaled = (uint32_t)std::min(
+        H.ThresholdEpsilon * ThresholdEpsilonScale, (double)UINT16_MAX);
+}
+
+void SolverImpl::setGarbageCollection(
+    const solver::dfpn::GarbageCollection& GC) {
+    if (!(GC.Ratio > 0 && GC.Ratio <= 1)) {
+        throw std::invalid_argument("Ratio must be in (0, 1].");
+    }
+    if (!(GC.FillRateThreshold >= 0)) {
+        throw std::invalid_argument("FillRateThreshold must not be negative.");
+    }
+    CollectionFillRateThreshold = GC.FillRateThreshold;
+    CollectionRatio = GC.Ratio;
+}
+
+uint32_t SolverImpl::secondBestThreshold(uint32_t SecondBest) const {
+    // Plain df-pn leaves the best child as soon as it gets worse than the
+    // second best one. Staying a little longer (the 1+epsilon trick) avoids
+    // thrashing between siblings of almost the same value.
+    const uint64_t Extra =
+        (uint64_t)SecondBest * ThresholdEpsilonScaled / ThresholdEpsilonScale;
+    return (uint32_t)std::min<uint64_t>(SecondBest + 1 + Extra,
+                                        DfPnValue::Infinity);
+}
+
+template <core::Color C, bool WilyPromote>
+DfPnValue SolverImpl::estimateEvasionEdge(core::internal::StateImpl* S,
+                                          core::Move32 Evasion) {
+    // df-pn+ style estimate of the attacker node after `Evasion`, probed
+    // before the node is ever searched: a mate in one will not be refuted,
+    // and an attacker without any check is already disproven.
+    DfPnValue Value(1, initialDisproofNumber(Evasion));
+
+    S->doMove<C>(Evasion);
+    if (S->getRepetitionStatus() == core::RepetitionStatus::NoRepetition) {
+        if (!internal::mate1ply::solve<~C>(*S).isNone()) {
+            Value.DisproofNumber =
+                std::max(Value.DisproofNumber, MateIn1DisproofNumber);
+        } else if (core::internal::MoveGeneratorInternal::
+                       generateLegalCheckMoves<~C, WilyPromote>(*S)
+                           .size() == 0) {
+            Value = DfPnValue(DfPnValue::Infinity, 0);
+        }
+    }
+    S->undoMove<~C>();
+
+    return Value;
+}
+
+template DfPnValue
+SolverImpl::estimateEvasionEdge<core::Black, false>(core::internal::StateImpl*,
+                                                    core::Move32);
+template DfPnValue
+SolverImpl::estimateEvasionEdge<core::Black, true>(core::internal::StateImpl*,
+                                                   core::Move32);
+template DfPnValue
+SolverImpl::estimateEvasionEdge<core::White, false>(core::internal::StateImpl*,
+                                                    core::Move32);
+template DfPnValue
+SolverImpl::estimateEvasionEdge<core::White, true>(core::internal::StateImpl*,
+                                                   core::Move32);
+
+void SolverImpl::setProofTreeRetention(std::size_t MemoryMB) {
+    if (MemoryMB == 0) {
+        ProofTable.release();
+        ProofTableSize = 0;
+        return;
+    }
+
+    ProofTableSize = std::max<std::size_t>(
+        1, MemoryMB * 1024ULL * 1024ULL / sizeof(DfPnProofBundle));
+    // Zero-filled, i.e., every entry is of generation 0 and dead.
+    ProofTable.allocate(ProofTableSize, TableOptions);
+}
+
+bool SolverImpl::findProof(uint64_t Hash, DfPnProofEntry* Entry) const {
+    if (ProofTableSize == 0) {
+        return false;
+    }
+
+    const std::size_t Index = Hash % ProofTableSize;
+    TTLockGuard Guard(getNodeTTLock(Index));
+    for (std::size_t I = 0; I < DfPnProofBundle::BundleSize; ++I) {
+        const DfPnProofEntry& Candidate = ProofTable[Index].Entries[I];
+        if (Candidate.generation() == Generation && Candidate.hash() == Hash) {
+            *Entry = Candidate;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void SolverImpl::storeProof(uint64_t Hash, core::Move32 Move,
+                            uint16_t MateLength) {
+    const std::size_t Index = Hash % ProofTableSize;
+    TTLockGuard Guard(getNodeTTLock(Index));
+
+    // Replace the same position, then a dead entry, and otherwise the
+    // shortest proof, which is the cheapest one to lose.
+    std::size_t ReplaceIndex = 0;
+    uint16_t MinLength = UINT16_MAX;
+    for (std::size_t I = 0; I < DfPnProofBundle::BundleSize; ++I) {
+        const DfPnProofEntry& Entry = ProofTable[Index].Entries[I];
+        if (Entry.generation() != Generation || Entry.hash() == Hash) {
+            ReplaceIndex = I;
+            break;
+        }
+        if (Entry.mateLength() < MinLength) {
+            MinLength = Entry.mateLength();
+            ReplaceIndex = I;
+        }
+    }
+
+    ProofTable[Index].Entries[ReplaceIndex].set(Hash, Move, MateLength,
+                                                Generation);
+}
+
+template <core::Color C, bool Attacking>
+void SolverImpl::retainProof(core::internal::StateImpl* S,
+                             const core::MoveList& Moves, uint64_t Depth) {
+    if (ProofTableSize == 0) {
+        return;
+    }
+
+    core::Move32 BestMove = core::Move32::MoveNone();
+    uint16_t BestLength = Attacking ? UINT16_MAX : 0;
+    bool IsFound = false;
+
+    for (const core::Move32 Move : Moves) {
+        if constexpr (Attacking) {
+            bool IsEdgeFound;
+            const DfPnValue EdgeValue =
+                loadEdgeFromTT<Attacking>(S, Move, Depth, &IsEdgeFound);
+            if (!IsEdgeFound || EdgeValue.ProofNumber != 0) {
+                continue;
+            }
+        }
+
+        S->doMove<C>(Move);
+        DfPnProofEntry Child;
+        const bool IsChildFound = findProof(S->getHash(), &Child);
+        S->undoMove<~C>();
+
+        if (!IsChildFound) {
+            if constexpr (Attacking) {
+                continue;
+            } else {
+                // The longest resistance is unknown.
+                return;
+            }
+        }
+
+        if (Attacking ? Child.mateLength() < BestLength
+                      : Child.mateLength() >= BestLength) {
+            BestLength = Child.mateLength();
+            BestMove = Move;
+            IsFound = true;
+        }
+    }
+
+    if (Attacking && !IsFound) {
+        return;
+    }
+
+    // A defender without any evasion is mated right here.
+    const uint16_t MateLength =
+        IsFound ? (uint16_t)std::min<uint32_t>(BestLength + 1U, UINT16_MAX - 1)
+                : 0;
+    storeProof(S->getHash(), BestMove, MateLength);
+}
+
+SpinLock* SolverImpl::getNodeTTLock(std::size_t Index) const {
+    if (NodeTTLocks == nullptr) {
+        return nullptr;
+    }
+    return &NodeTTLocks[Index & (NodeTTLockCount - 1)];
+}
+
+SpinLock* SolverImpl::getEdgeTTLock(std::size_t Index) const {
+    if (EdgeTTLocks == nullptr) {
+        return nullptr;
+    }
+    return &EdgeTTLocks[Index & (EdgeTTLockCount - 1)];
+}
+
+std::atomic<uint16_t>*
+SolverImpl::getSearchingCount(core::internal::StateImpl* S,
+                              core::Move32 Move) const {
+    if (SearchingCounts == nullptr) {
+        return nullptr;
+    }
+    const uint64_t EdgeHash =
+        S->getHash() ^ static_cast<uint64_t>(core::Move16(Move).value());
+    return &SearchingCounts[(EdgeHash >> 17) & (SearchingCountSize - 1)];
+}
+
+uint32_t SolverImpl::virtualNumber(const SearchThread* Thread,
+                                   core::internal::StateImpl* S,
+                                   core::Move32 Move) const {
+    // The main thread follows the plain df-pn order so that adding helpers
+    // never slows down the principal search; only helpers avoid busy edges.
+    if (Thread->isMainThread() || SearchingCounts == nullptr) {
+        return 0;
+    }
+    const uint16_t Count =
+        getSearchingCount(S, Move)->load(std::memory_order_relaxed);
+    return VirtualProofNumber * static_cast<uint32_t>(Count);
+}
+
+void SolverImpl::countNode(SearchThread* Thread) {
+    ++Thread->NodeCount;
+    ++Thread->PendingNodeCount;
+    if (NumThreads > 1 && Thread->PendingNodeCount >= NodeCountFlushInterval) {
+        flushNodeCount(Thread);
+    }
+
+    if (CollectionFillRateThreshold < 1.0 && Thread->isMainThread() &&
+        --Thread->CollectionCountdown == 0) {
+        Thread->CollectionCountdown = CollectionCheckInterval;
+        if (ttFillRate() > CollectionFillRateThreshold) {
+            collectGarbage();
+        }
+    }
+
+    if (IsClockUsed && Thread->isMainThread() &&
+        --Thread->ClockCountdown == 0) {
+        Thread->ClockCountdown = ClockCheckInterval;
+        checkClock(Thread);
+    }
+}
+
+void SolverImpl::checkClock(SearchThread* Thread) {
+    const Clock::time_point Now = Clock::now();
+
+    if (TimeLimitMilliseconds > 0 && Now >= Deadline) {
+        StopRequested.store(true, std::memory_order_relaxed);
+    }
+
+    if (Callback && Now >= NextProgressTime) {
+        reportProgress(Thread, Now);
+        NextProgressTime =
+            Now + std::chrono::milliseconds(ProgressIntervalMilliseconds);
+    }
+}
+
+void SolverImpl::reportProgress(const SearchThread* Thread,
+                                Clock::time_point Now) {
+    solver::dfpn::Progress P;
+    P.NodeCount = SearchedNodeCount.load(std::memory_order_relaxed) +
+                  Thread->PendingNodeCount;
+    P.ElapsedMilliseconds =
+        (uint64_t)std::chrono::duration_cast<std::chrono::milliseconds>(
+            Now - StartTime)
+            .count();
+    const double Seconds =
+        std::chrono::duration<double>(Now - StartTime).count();
+    P.NodesPerSecond = (Seconds > 0) ? (double)P.NodeCount / Seconds : 0.0;
+    P.RootProofNumber = RootProofNumber.load(std::memory_order_relaxed);
+    P.RootDisproofNumber = RootDisproofNumber.load(std::memory_order_relaxed);
+    P.TTFillRate = ttFillRate();
+
+    Callback(P);
+}
+
+void SolverImpl::updateRootValue(const DfPnValue& Value) {
+    RootProofNumber.store(Value.ProofNumber, std::memory_order_relaxed);
+    RootDisproofNumber.store(Value.DisproofNumber, std::memory_order_relaxed);
+}
+
+double SolverImpl::ttFillRate() const {
+    // Edge entries carry the search progress, so they tell how much of the
+    // table the current search occupies. Sampling the leading bundles is
+    // enough since the table is indexed by hash.
+    const std::size_t NumBundles = std::min(EdgeTTSize, FillRateSampleSize);
+    std::size_t NumLiveEntries = 0;
+    for (std::size_t I = 0; I < NumBundles; ++I) {
+        TTLockGuard Guard(getEdgeTTLock(I));
+        for (std::size_t J = 0; J < DfPnEdgeTTBundle::BundleSize; ++J) {
+            if (EdgeTT[I].Entries[J].generation() == Generation) {
+                ++NumLiveEntries;
+            }
+        }
+    }
+    return (double)NumLiveEntries /
+           (double)(NumBundles * DfPnEdgeTTBundle::BundleSize);
+}
+
+void SolverImpl::collectGarbage() {
+    // Find the value at the `CollectionRatio` quantile of the live entries in
+    // evenly spaced sample bundles.
+    const std::size_t NumSamples = std::min(EdgeTTSize, CollectionSampleSize);
+    const std::size_t Stride = EdgeTTSize / NumSamples;
+    std::vector<uint32_t> Values;
+    Values.reserve(NumSamples * DfPnEdgeTTBundle::BundleSize);
+    for (std::size_t I = 0; I < NumSamples; ++I) {
+        const std::size_t Index = I * Stride;
+        TTLockGuard Guard(getEdgeTTLock(Index));
+        for (std::size_t J = 0; J < DfPnEdgeTTBundle::BundleSize; ++J) {
+            const DfPnEdgeTTEntry& Entry = EdgeTT[Index].Entries[J];
+            if (Entry.generation() != Generation) {
+                break;
+            }
+            Values.push_back(retentionValue(Entry));
+        }
+    }
+
+    const std::size_t NumToFree =
+        (std::size_t)(CollectionRatio * (double)Values.size());
+    if (NumToFree == 0) {
+        return;
+    }
+    std::nth_element(Values.begin(), Values.begin() + (NumToFree - 1),
+                     Values.end());
+    uint32_t Threshold = Values[NumToFree - 1];
+
+    // Many entries share the smallest values, so freeing every entry of the
+    // quantile value may free far more than asked. Keep them if that is
+    // closer to the ratio.
+    const std::size_t NumBelow = (std::size_t)std::count_if(
+        Values.begin(), Values.end(),
+        [Threshold](uint32_t V) { return V < Threshold; });
+    const std::size_t NumAtOrBelow = (std::size_t)std::count_if(
+        Values.begin(), Values.end(),
+        [Threshold](uint32_t V) { return V <= Threshold; });
+    if (NumBelow > 0 && NumToFree - NumBelow < NumAtOrBelow - NumToFree) {
+        --Threshold;
+    }
+
+    // Keep the live entries packed at the front of each bundle, since a
+    // probe stops at the first dead entry.
+    for (std::size_t I = 0; I < EdgeTTSize; ++I) {
+        TTLockGuard Guard(getEdgeTTLock(I));
+        DfPnEdgeTTBundle& Bundle = EdgeTT[I];
+        std::size_t Kept = 0;
+        std::size_t J = 0;
+        for (; J < DfPnEdgeTTBundle::BundleSize; ++J) {
+            if (Bundle.Entries[J].generation() != Generation) {
+                break;
+            }
+            if (retentionValue(Bundle.Entries[J]) > Threshold) {
+                Bundle.Entries[Kept++] = Bundle.Entries[J];
+            }
+        }
+        for (std::size_t K = Kept; K < J; ++K) {
+            Bundle.Entries[K].setGeneration(0);
+        }
+    }
+}
+
+void SolverImpl::flushNodeCount(SearchThread* Thread) {
+    SearchedNodeCount.fetch_add(Thread->PendingNodeCount,
+                                std::memory_order_relaxed);
+    Thread->PendingNodeCount = 0;
+}
+
+bool SolverImpl::isSearchable(const SearchThread* Thread,
+                              uint64_t MaxNodeCount) const {
+    if (StopRequested.load(std::memory_order_relaxed)) {
+        return false;
+    }
+    return MaxNodeCount == 0 ||
+           SearchedNodeCount.load(std::memory_order_relaxed) +
+                   Thread->PendingNodeCount <
+               MaxNodeCount;
+}
+
+template <bool Attacking>
+std::size_t SolverImpl::nodeTTIndex(uint64_t PositionHash,
+                                    uint64_t Depth) const {
+    return (((PositionHash + 2 * Depth) << 1) |
+            static_cast<uint64_t>(Attacking)) %
+           NodeTTSize;
+}
+
+template <bool Attacking>
+std::size_t SolverImpl::edgeTTIndex(uint64_t EdgeHash, uint64_t Depth) const {
+    return (((EdgeHash + 2 * Depth) << 1) | static_cast<uint64_t>(Attacking)) %
+           EdgeTTSize;
+}
+
+template <core::Color C, bool Attacking>
+void SolverImpl::prefetchChildren(const core::internal::StateImpl* S,
+                                  const core::MoveList& Moves,
+                                  uint64_t Depth) const {
+    // The selection loop below probes the edge bundle of every child and
+    // then the node bundle of the child it descends into. Both indices are
+    // derived from hashes that are cheap to compute without `doMove()`, so
+    // issue all the cache misses up front and let them overlap.
+    const uint64_t SourceHash = S->getHash();
+    for (const core::Move32 Move : Moves) {
+        const uint64_t EdgeHash =
+            SourceHash ^ static_cast<uint64_t>(core::Move16(Move).value());
+        __builtin_prefetch(&EdgeTT[edgeTTIndex<Attacking>(EdgeHash, Depth)]);
+
+        const uint64_t ChildHash = S->getBoardHashAfter<C>(Move);
+        __builtin_prefetch(
+            &NodeTT[nodeTTIndex<!Attacking>(ChildHash, Depth + 1)]);
+    }
 }
 
 template <core::Color C, bool Attacking>
-void SolverImpl::storeNodeToTT(core::internal::StateImpl* S, uint64_t Depth,
-                               const DfPnValue& Value) {
+void SolverImpl::storeNodeToTT(core::internal::StateImpl* S,
+                               SearchThread* Thread, uint64_t Depth,
+                               const DfPnValue& Value, uint64_t Work) {
     // Finite progress remains authoritative on edges. Persist only solved
     // derived summaries, which are stable and support stand superiority.
-    if (!Value.NodeCacheable ||
+    if (Value.isPathDependent() ||
         (Value.ProofNumber != 0 && Value.DisproofNumber != 0)) {
         return;
     }
 
+    StatisticsTimer Timer(&Thread->Stats.TTNanoseconds);
+
     const core::Stands StandsAttacking = (Attacking)
                                              ? S->getPosition().getStand<C>()
                                              : S->getPosition().getStand<~C>();
     const uint64_t PositionHash = S->getBoardHash();
-    const std::size_t Index =
-        (((PositionHash + 2 * Depth) << 1) | static_cast<uint64_t>(Attacking)) %
-        NodeTTSize;
+    const std::size_t Index = nodeTTIndex<Attacking>(PositionHash, Depth);
+    const bool IsProof = Value.ProofNumber == 0;
 
-    const std::size_t DeleteIndex =
-        (PositionHash >> 32) % DfPnNodeTTBundle::BundleSize;
+    TTLockGuard Guard(getNodeTTLock(Index));
+    DfPnNodeTTBundle* Bundle = &NodeTT[Index];
 
-    for (std::size_t I = 0; I < DfPnNodeTTBundle::BundleSize; ++I) {
-        DfPnNodeTTEntry* Entry = &NodeTT[Index].Entries[I];
+    // Live entries are packed at the front of the bundle.
+    std::size_t NumLive = 0;
+    while (NumLive < DfPnNodeTTBundle::BundleSize &&
+           isLiveNodeEntry(Bundle->Entries[NumLive])) {
+        ++NumLive;
+    }
 
-        if (Entry->generation() != Generation) {
-            Entry->setPositionHash(PositionHash);
-            Entry->setStandsAttacking(StandsAttacking);
-            Entry->setProofNumber(static_cast<uint16_t>(Value.ProofNumber));
-            Entry->setDisproofNumber(
-                static_cast<uint16_t>(Value.DisproofNumber));
-            Entry->setGeneration(Generation);
-            return;
-        }
+    // A proof with fewer pieces in hand implies the proofs with more, and a
+    // disproof with more pieces in hand implies the disproofs with fewer.
+    // Drop the new value if an entry implies it, and otherwise let it take
+    // over the entries it implies.
+    DfPnNodeTTEntry* Target = nullptr;
+    for (std::size_t I = 0; I < NumLive;) {
+        DfPnNodeTTEntry* Entry = &Bundle->Entries[I];
 
         if (!Entry->isSamePosition(PositionHash)) {
+            ++I;
             continue;
         }
 
-        if (Entry->standsAttacking() == StandsAttacking) {
-            Entry->setProofNumber(static_cast<uint16_t>(Value.ProofNumber));
-            Entry->setDisproofNumber(
-                static_cast<uint16_t>(Value.DisproofNumber));
+        const bool IsEntryProof = Entry->proofNumber() == 0;
+        const bool IsSameStands = Entry->standsAttacking() == StandsAttacking;
+
+        if (IsEntryProof == IsProof && !IsSameStands &&
+            (IsProof ? core::isSuperiorOrEqual(StandsAttacking,
+                                               Entry->standsAttacking())
+                     : core::isSuperiorOrEqual(Entry->standsAttacking(),
+                                               StandsAttacking))) {
             return;
         }
 
-        if (Value.ProofNumber == 0 &&
-            core::isSuperiorOrEqual(Entry->standsAttacking(),
-                                    StandsAttacking)) {
-            Entry->setStandsAttacking(StandsAttacking);
-            Entry->setProofNumber(static_cast<uint16_t>(Value.ProofNumber));
-            Entry->setDisproofNumber(
-                static_cast<uint16_t>(Value.DisproofNumber));
-            return;
+        const bool IsImplied =
+            IsSameStands ||
+            (IsEntryProof == IsProof &&
+             (IsProof ? core::isSuperiorOrEqual(Entry->standsAttacking(),
+                                                StandsAttacking)
+                      : core::isSuperiorOrEqual(StandsAttacking,
+                                                Entry->standsAttacking())));
+        if (!IsImplied) {
+            ++I;
+            continue;
         }
 
-        if (Value.DisproofNumber == 0 &&
-            core::isSuperiorOrEqual(StandsAttacking,
-                                    Entry->standsAttacking())) {
-            Entry->setStandsAttacking(StandsAttacking);
-            Entry->setProofNumber(static_cast<uint16_t>(Value.ProofNumber));
-            Entry->setDisproofNumber(
-                static_cast<uint16_t>(Value.DisproofNumber));
-            return;
+        if (Target == nullptr) {
+            Target = Entry;
+            ++I;
+            continue;
+        }
+
+        // Another implied entry: fill the hole with the last live entry.
+        --NumLive;
+        *Entry = Bundle->Entries[NumLive];
+        Bundle->Entries[NumLive].setGeneration(0);
+    }
+
+    uint16_t TargetWork = saturateWork(Work);
+    if (Target == nullptr) {
+        if (NumLive < DfPnNodeTTBundle::BundleSize) {
+            Target = &Bundle->Entries[NumLive++];
+        } else {
+            if constexpr (StatisticsEnabled) {
+                ++Thread->Stats.NodeTT.Replacements;
+            }
+            // Evict the value that was the cheapest to obtain.
+            Target = &Bundle->Entries[0];
+            for (std::size_t I = 1; I < DfPnNodeTTBundle::BundleSize; ++I) {
+                if (Bundle->Entries[I].work() < Target->work()) {
+                    Target = &Bundle->Entries[I];
+                }
+            }
         }
+        Target->setPositionHash(PositionHash);
+        Target->setGeneration(Generation);
+    } else {
+        // The value is new to this search even if the entry was loaded, so
+        // that the collection can evict it like the others.
+        TargetWork = std::max(TargetWork, Target->work());
+        Target->setGeneration(Generation);
     }
 
-    DfPnNodeTTEntry* Entry = &NodeTT[Index].Entries[DeleteIndex];
-    Entry->setPositionHash(PositionHash);
-    Entry->setStandsAttacking(StandsAttacking);
-    Entry->setProofNumber(static_cast<uint16_t>(Value.ProofNumber));
-    Entry->setDisproofNumber(static_cast<uint16_t>(Value.DisproofNumber));
-    Entry->setGeneration(Generation);
+    Target->setStandsAttacking(StandsAttacking);
+    Target->setValue(static_cast<uint16_t>(Value.ProofNumber),
+                     static_cast<uint16_t>(Value.DisproofNumber));
+    Target->setWork(TargetWork);
+
+    // Keep the loaded entries in front of the others. They are the only ones
+    // that stay live when the generation changes, so they then remain packed
+    // at the front without a pass over the table.
+    std::partition(Bundle->Entries, Bundle->Entries + NumLive,
+                   [](const DfPnNodeTTEntry& Entry) {
+                       return Entry.generation() == PersistentGeneration;
+                   });
 }
 
 template <core::Color C, bool Attacking>
 DfPnValue SolverImpl::loadNodeFromTT(core::internal::StateImpl* S,
-                                     uint64_t Depth, bool* IsFound) const {
+                                     uint64_t Depth, bool* IsFound,
+                                     SearchThread* Thread) const {
+    solver::dfpn::Statistics* const Stats =
+        (Thread != nullptr) ? &Thread->Stats : nullptr;
+    StatisticsTimer Timer(Stats != nullptr ? &Stats->TTNanoseconds : nullptr);
+
     const core::Stands StandsAttacking = (Attacking)
                                              ? S->getPosition().getStand<C>()
                                              : S->getPosition().getStand<~C>();
     const uint64_t PositionHash = S->getBoardHash();
-    const std::size_t Index =
-        (((PositionHash + 2 * Depth) << 1) | static_cast<uint64_t>(Attacking)) %
-        NodeTTSize;
+    const std::size_t Index = nodeTTIndex<Attacking>(PositionHash, Depth);
 
+    TTLockGuard Guard(getNodeTTLock(Index));
     for (std::size_t I = 0; I < DfPnNodeTTBundle::BundleSize; ++I) {
         const DfPnNodeTTEntry* Entry = &NodeTT[Index].Entries[I];
 
-        if (Entry->generation() != Generation) {
+        if (!isLiveNodeEntry(*Entry)) {
             break;
         }
 
@@ -173,78 +770,99 @@ DfPnValue SolverImpl::loadNodeFromTT(core::internal::StateImpl* S,
             continue;
         }
 
-        if (Entry->standsAttacking() == StandsAttacking ||
-            (Entry->proofNumber() == 0 &&
-             core::isSuperiorOrEqual(StandsAttacking,
-                                     Entry->standsAttacking())) ||
-            (Entry->disproofNumber() == 0 &&
-             core::isSuperiorOrEqual(Entry->standsAttacking(),
-                                     StandsAttacking))) {
-            *IsFound = true;
-            return DfPnValue(static_cast<uint32_t>(Entry->proofNumber()),
-                             static_cast<uint32_t>(Entry->disproofNumber()));
+        if (Entry->standsAttacking() == StandsAttacking) {
+            ExactNodeHitCount.fetch_add(1, std::memory_order_relaxed);
+        } else if ((Entry->proofNumber() == 0 &&
+                    core::isSuperiorOrEqual(StandsAttacking,
+                                            Entry->standsAttacking())) ||
+                   (Entry->disproofNumber() == 0 &&
+                    core::isSuperiorOrEqual(Entry->standsAttacking(),
+                                            StandsAttacking))) {
+            DominatedNodeHitCount.fetch_add(1, std::memory_order_relaxed);
+            if constexpr (StatisticsEnabled) {
+                if (Stats != nullptr) {
+                    ++Stats->DominationHits;
+                }
+            }
+        } else {
+            continue;
         }
+
+        if constexpr (StatisticsEnabled) {
+            if (Stats != nullptr) {
+                ++Stats->NodeTT.Hits;
+            }
+        }
+        *IsFound = true;
+        return DfPnValue(static_cast<uint32_t>(Entry->proofNumber()),
+                         static_cast<uint32_t>(Entry->disproofNumber()));
     }
 
+    if constexpr (StatisticsEnabled) {
+        if (Stats != nullptr) {
+            ++Stats->NodeTT.Misses;
+        }
+    }
     *IsFound = false;
     return DfPnValue(1, 1);
 }
 
 template <bool Attacking>
-void SolverImpl::storeEdgeToTT(core::internal::StateImpl* S, core::Move32 Move,
-                               uint64_t Depth, const DfPnValue& Value) {
+void SolverImpl::storeEdgeToTT(core::internal::StateImpl* S,
+                               SearchThread* Thread, core::Move32 Move,
+                               uint64_t Depth, const DfPnValue& Value,
+                               uint64_t Work) {
+    StatisticsTimer Timer(&Thread->Stats.TTNanoseconds);
+
     const uint64_t SourceHash = S->getHash();
     const uint64_t EdgeHash =
         SourceHash ^ static_cast<uint64_t>(core::Move16(Move).value());
-    const std::size_t Index =
-        (((EdgeHash + 2 * Depth) << 1) | static_cast<uint64_t>(Attacking)) %
-        EdgeTTSize;
+    const std::size_t Index = edgeTTIndex<Attacking>(EdgeHash, Depth);
 
-    std::size_t DeleteIndex = 0;
-    uint16_t PnPlusDnMax = 0;
-    uint16_t PnMaxDnMax = 0;
+    TTLockGuard Guard(getEdgeTTLock(Index));
 
+    // Fill the first dead entry, and otherwise replace the least valuable
+    // one, so that a full bundle gives up cheap unsolved edges before the
+    // proofs and the large subtrees.
+    DfPnEdgeTTEntry* Victim = nullptr;
     for (std::size_t I = 0; I < DfPnEdgeTTBundle::BundleSize; ++I) {
         DfPnEdgeTTEntry* Entry = &EdgeTT[Index].Entries[I];
 
         if (Entry->generation() != Generation) {
-            Entry->setSourceHash(SourceHash);
-            Entry->setMove(Move);
-            Entry->setProofNumberAndNodeCacheable((uint16_t)Value.ProofNumber,
-                                                  Value.NodeCacheable);
-            Entry->setDisproofNumber((uint16_t)Value.DisproofNumber);
-            Entry->setGeneration(Generation);
-            return;
-        }
-
-        const uint16_t PnPlusDn =
-            Entry->proofNumber() + Entry->disproofNumber();
-
-        const uint16_t PnMaxDn =
-            std::max(Entry->proofNumber(), Entry->disproofNumber());
-        if (PnPlusDn < DfPnValue::Infinity &&
-            (PnPlusDn > PnPlusDnMax ||
-             (PnPlusDn == PnPlusDnMax && PnMaxDn > PnMaxDnMax))) {
-            PnPlusDnMax = PnPlusDn;
-            PnMaxDnMax = PnMaxDn;
-            DeleteIndex = I;
+            Victim = Entry;
+            break;
         }
 
         if (Entry->isSameEdge(SourceHash, Move)) {
-            Entry->setProofNumberAndNodeCacheable((uint16_t)Value.ProofNumber,
-                                                  Value.NodeCacheable);
+            Entry->setWork(saturateWork(Entry->work() + Work));
+            // Another thread may have solved this edge while the caller was
+            // still searching below it with an older value.
+            if (Entry->isSolved() && Value.ProofNumber != 0 &&
+                Value.DisproofNumber != 0) {
+                return;
+            }
+            Entry->setProofNumber((uint16_t)Value.ProofNumber);
             Entry->setDisproofNumber((uint16_t)Value.DisproofNumber);
             return;
         }
+
+        if (Victim == nullptr ||
+            retentionValue(*Entry) < retentionValue(*Victim)) {
+            Victim = Entry;
+        }
     }
 
-    DfPnEdgeTTEntry* Entry = &EdgeTT[Index].Entries[DeleteIndex];
-    Entry->setSourceHash(SourceHash);
-    Entry->setMove(Move);
-    Entry->setProofNumberAndNodeCacheable((uint16_t)Value.ProofNumber,
-                                          Value.NodeCacheable);
-    Entry->setDisproofNumber((uint16_t)Value.DisproofNumber);
-    Entry->setGeneration(Generation);
+    if constexpr (StatisticsEnabled) {
+        if (Victim->generation() == Generation) {
+            ++Thread->Stats.EdgeTT.Replacements;
+        }
+    }
+    Victim->setSourceHash(SourceHash);
+    Victim->setMove(Move);
+    Victim->setProofNumber((uint16_t)Value.ProofNumber);
+    Victim->setDisproofNumber((uint16_t)Value.DisproofNumber);
+    Victim->setWork(saturateWork(Work));
+    Victim->setGeneration(Generation);
 }
 
 template <bool Attacking>
@@ -254,9 +872,9 @@ DfPnValue SolverImpl::loadEdgeFromTT(core::internal::StateImpl* S,
     const uint64_t SourceHash = S->getHash();
     const uint64_t EdgeHash =
         SourceHash ^ static_cast<uint64_t>(core::Move16(Move).value());
-    const std::size_t Index =
-        (((EdgeHash + 2 * Depth) << 1) | static_cast<uint64_t>(Attacking)) %
-        EdgeTTSize;
+    const std::size_t Index = edgeTTIndex<Attacking>(EdgeHash, Depth);
+
+    TTLockGuard Guard(getEdgeTTLock(Index));
     for (std::size_t I = 0; I < DfPnEdgeTTBundle::BundleSize; ++I) {
         const DfPnEdgeTTEntry* Entry = &EdgeTT[Index].Entries[I];
 
@@ -267,8 +885,7 @@ DfPnValue SolverImpl::loadEdgeFromTT(core::internal::StateImpl* S,
         if (Entry->isSameEdge(SourceHash, Move)) {
             *IsFound = true;
             return DfPnValue((uint32_t)Entry->proofNumber(),
-                             (uint32_t)Entry->disproofNumber(),
-                             Entry->isNodeCacheable());
+                             (uint32_t)Entry->disproofNumber());
         }
     }
 
@@ -277,19 +894,81 @@ DfPnValue SolverImpl::loadEdgeFromTT(core::internal::StateImpl* S,
     return DfPnValue(1, 1);
 }
 
+template <bool Attacking>
+DfPnValue SolverImpl::loadEdge(core::internal::StateImpl* S,
+                               SearchThread* Thread, core::Move32 Move,
+                               uint64_t Depth, bool* IsFound) const {
+    const uint64_t ChildPathKey = childPathKey(Thread->PathKey, Move, Depth);
+    const DfPnRepetitionEntry& Repetition =
+        Thread->RepetitionTable[ChildPathKey & (RepetitionTableSize - 1)];
+    if (Repetition.Generation == Generation &&
+        Repetition.PathKey == ChildPathKey) {
+        *IsFound = true;
+        return Repetition.Value;
+    }
+
+    StatisticsTimer Timer(&Thread->Stats.TTNanoseconds);
+    const DfPnValue Value =
+        loadEdgeFromTT<Attacking>(S, Move, Depth, IsFound);
+    if constexpr (StatisticsEnabled) {
+        ++(*IsFound ? Thread->Stats.EdgeTT.Hits : Thread->Stats.EdgeTT.Misses);
+    }
+    return Value;
+}
+
+template <bool Attacking>
+void SolverImpl::storeEdge(core::internal::StateImpl* S, SearchThread* Thread,
+                           core::Move32 Move, uint64_t Depth,
+                           const DfPnValue& Value, uint64_t Work) {
+    if (Value.DisproofNumber == 0 && Value.isPathDependent()) {
+        // The edge table keeps whatever other paths have found for the edge.
+        const uint64_t ChildPathKey =
+            childPathKey(Thread->PathKey, Move, Depth);
+        DfPnRepetitionEntry& Repetition =
+            Thread->RepetitionTable[ChildPathKey & (RepetitionTableSize - 1)];
+        Repetition.PathKey = ChildPathKey;
+        Repetition.Value = Value;
+        Repetition.Generation = Generation;
+    } else {
+        storeEdgeToTT<Attacking>(S, Thread, Move, Depth, Value, Work);
+    }
+}
+
+int32_t SolverImpl::repetitionDepth(const core::internal::StateImpl* S) const {
+    uint16_t RepeatedPly = 0;
+    [[maybe_unused]] const auto Status = S->getRepetitionStatus(&RepeatedPly);
+    assert(Status != core::RepetitionStatus::NoRepetition);
+    return (int32_t)RepeatedPly - (int32_t)RootPly;
+}
+
 template <core::Color C, bool Attacking, bool WilyPromote>
-core::Move32 SolverImpl::search(core::internal::StateImpl* S, uint64_t Depth,
+core::Move32 SolverImpl::search(core::internal::StateImpl* S,
+                                SearchThread* Thread, uint64_t Depth,
                                 DfPnValue* IncomingEdgeValue,
                                 DfPnValue* Threshold, uint64_t MaxNodeCount,
                                 uint64_t MaxDepth) {
-    ++SearchedNodeCount;
-
-    // Step 1: check terminal.
-    const auto RepetitionStatus = S->getRepetitionStatus();
-    if (RepetitionStatus != core::RepetitionStatus::NoRepetition) {
-        // Repetition depends on the path to this node. Keep it as edge state,
-        // but prevent it from being promoted into the shared node cache.
-        *IncomingEdgeValue = DfPnValue(DfPnValue::Infinity, 0, false);
+    // The nodes searched below this node so far, including itself.
+    const uint64_t NodeCountBefore = Thread->NodeCount;
+    const auto Work = [&]() { return Thread->NodeCount - NodeCountBefore; };
+    countNode(Thread);
+    if constexpr (StatisticsEnabled) {
+        Thread->Stats.MaxDepthReached =
+            std::max(Thread->Stats.MaxDepthReached, Depth);
+    }
+
+    // Step 1: check terminal. The root is the given problem even if it
+    // repeats a position before it.
+    uint16_t RepeatedPly = 0;
+    if (Depth > 0 && S->getRepetitionStatus(&RepeatedPly) !=
+                         core::RepetitionStatus::NoRepetition) {
+        if constexpr (StatisticsEnabled) {
+            ++Thread->Stats.RepetitionCutoffs;
+        }
+        // Repetition depends on the path to this node. Tag the disproof with
+        // the repeated node so that it is cached only where it holds.
+        *IncomingEdgeValue =
+            DfPnValue(DfPnValue::Infinity, 0,
+                      (int32_t)RepeatedPly - (int32_t)RootPly);
         return core::Move32::MoveNone();
     }
 
@@ -306,7 +985,7 @@ core::Move32 SolverImpl::search(core::internal::StateImpl* S, uint64_t Depth,
 
     bool IsNodeFound;
     const DfPnValue CachedNodeValue =
-        loadNodeFromTT<C, Attacking>(S, Depth, &IsNodeFound);
+        loadNodeFromTT<C, Attacking>(S, Depth, &IsNodeFound, Thread);
     if (Depth > 0 && IsNodeFound &&
         (CachedNodeValue.ProofNumber == 0 ||
          CachedNodeValue.DisproofNumber == 0)) {
@@ -317,56 +996,96 @@ core::Move32 SolverImpl::search(core::internal::StateImpl* S, uint64_t Depth,
         return core::Move32::MoveNone();
     }
 
-    const auto Moves =
-        Attacking
-            ? core::internal::MoveGeneratorInternal::generateLegalCheckMoves<
-                  C, WilyPromote>(*S)
-            : core::internal::MoveGeneratorInternal::generateLegalEvasionMoves<
-                  C, WilyPromote>(*S);
+    const auto Moves = [&]() {
+        StatisticsTimer Timer(&Thread->Stats.MoveGenerationNanoseconds);
+        return Attacking ? core::internal::MoveGeneratorInternal::
+                               generateLegalCheckMoves<C, WilyPromote>(*S)
+                         : core::internal::MoveGeneratorInternal::
+                               generateLegalEvasionMoves<C, WilyPromote>(*S);
+    }();
+
+    if constexpr (StatisticsEnabled) {
+        if constexpr (Attacking) {
+            ++Thread->Stats.AttackerNodes;
+            Thread->Stats.AttackerMoves += Moves.size();
+        } else {
+            ++Thread->Stats.DefenderNodes;
+            Thread->Stats.DefenderMoves += Moves.size();
+        }
+    }
 
     if constexpr (Attacking) {
         if (Moves.size() == 0) {
             NodeValue = DfPnValue(DfPnValue::Infinity, 0);
-            storeNodeToTT<C, Attacking>(S, Depth, NodeValue);
+            storeNodeToTT<C, Attacking>(S, Thread, Depth, NodeValue, Work());
             *IncomingEdgeValue = NodeValue;
             return core::Move32::MoveNone();
         }
     }
 
     if (MaxDepth > 0 && Depth >= MaxDepth) {
+        IsDepthLimited.store(true, std::memory_order_relaxed);
         NodeValue = DfPnValue(DfPnValue::Infinity, 0);
-        storeNodeToTT<C, Attacking>(S, Depth, NodeValue);
+        storeNodeToTT<C, Attacking>(S, Thread, Depth, NodeValue, Work());
         *IncomingEdgeValue = NodeValue;
         return core::Move32::MoveNone();
     }
 
+    prefetchChildren<C, Attacking>(S, Moves, Depth);
+
     // Step 2: search.
     if constexpr (Attacking) { // OR node.
-        while (MaxNodeCount == 0 || SearchedNodeCount < MaxNodeCount) {
+        while (isSearchable(Thread, MaxNodeCount)) {
             uint32_t MinProof = DfPnValue::Infinity;
-            uint32_t MinProof2 = DfPnValue::Infinity;
             uint32_t SumDisproof = 0;
-            DfPnValue BestEdgeValue;
-            bool AllEdgesCacheable = true;
+            // A disproof holds only as long as the disproof of every edge.
+            int32_t MinRepetitionDepth = DfPnValue::NoRepetitionDepth;
 
             // TODO(nyashiki): [[indeterminate]] could be used in C++26.
             core::Move32 BestMove = core::Move32::MoveNone();
 
+            // The edge to descend into. It is the best edge except for helper
+            // threads, which see edges under search as virtually harder.
+            uint32_t SelectProof = DfPnValue::Infinity;
+            uint32_t SelectProof2 = DfPnValue::Infinity;
+            DfPnValue SelectEdgeValue;
+            core::Move32 SelectMove = core::Move32::MoveNone();
+
             for (const core::Move32 Move : Moves) {
                 bool IsFound;
                 DfPnValue EdgeValue =
-                    loadEdgeFromTT<Attacking>(S, Move, Depth, &IsFound);
+                    loadEdge<Attacking>(S, Thread, Move, Depth, &IsFound);
 
                 if (!IsFound) {
                     S->doMove<C>(Move);
                     const auto ChildRepetitionStatus = S->getRepetitionStatus();
+                    bool IsChildSolved = false;
+                    if (ChildRepetitionStatus ==
+                        core::RepetitionStatus::NoRepetition) {
+                        // A child solved elsewhere, possibly with other
+                        // pieces in hand, needs no expansion.
+                        const DfPnValue ChildValue =
+                            loadNodeFromTT<~C, !Attacking>(
+                                S, Depth + 1, &IsChildSolved, Thread);
+                        if (IsChildSolved) {
+                            EdgeValue = ChildValue;
+                        }
+                    }
+
                     if (ChildRepetitionStatus !=
                         core::RepetitionStatus::NoRepetition) {
-                        EdgeValue = DfPnValue(DfPnValue::Infinity, 0, false);
-                    } else {
-                        const auto NextMoves =
-                            core::internal::MoveGeneratorInternal::
+                        if constexpr (StatisticsEnabled) {
+                            ++Thread->Stats.RepetitionCutoffs;
+                        }
+                        EdgeValue = DfPnValue(DfPnValue::Infinity, 0,
+                                              repetitionDepth(S));
+                    } else if (!IsChildSolved) {
+                        const auto NextMoves = [&]() {
+                            StatisticsTimer Timer(
+                                &Thread->Stats.MoveGenerationNanoseconds);
+                            return core::internal::MoveGeneratorInternal::
                                 generateLegalEvasionMoves<~C, WilyPromote>(*S);
+                        }();
                         if (NextMoves.size() == 0) {
                             const core::Move32 LastMove = S->getLastMove();
                             if (LastMove.drop() &&
@@ -375,8 +1094,12 @@ core::Move32 SolverImpl::search(core::internal::StateImpl* S, uint64_t Depth,
                                 EdgeValue = DfPnValue(DfPnValue::Infinity, 0);
                             } else {
                                 EdgeValue = DfPnValue(0, DfPnValue::Infinity);
-                                storeNodeToTT<~C, !Attacking>(S, Depth + 1,
-                                                              EdgeValue);
+                                storeNodeToTT<~C, !Attacking>(
+                                    S, Thread, Depth + 1, EdgeValue, 0);
+                                if (ProofTableSize > 0) {
+                                    storeProof(S->getHash(),
+                                               core::Move32::MoveNone(), 0);
+                                }
                             }
                         } else {
                             uint32_t InitialProofNumber = 0;
@@ -394,132 +1117,175 @@ core::Move32 SolverImpl::search(core::internal::StateImpl* S, uint64_t Depth,
                         }
                     }
                     S->undoMove<~C>();
-                    storeEdgeToTT<Attacking>(S, Move, Depth, EdgeValue);
+                    storeEdge<Attacking>(S, Thread, Move, Depth, EdgeValue,
+                                         0);
                 }
 
-                AllEdgesCacheable &= EdgeValue.NodeCacheable;
+                MinRepetitionDepth =
+                    std::min(MinRepetitionDepth, EdgeValue.RepetitionDepth);
                 if (EdgeValue.ProofNumber < MinProof) {
-                    MinProof2 = MinProof;
                     MinProof = EdgeValue.ProofNumber;
-                    BestEdgeValue = EdgeValue;
                     BestMove = Move;
-                } else if (EdgeValue.ProofNumber < MinProof2) {
-                    MinProof2 = EdgeValue.ProofNumber;
                 }
                 SumDisproof += EdgeValue.DisproofNumber;
+
+                const uint32_t Proof = inflate(
+                    EdgeValue.ProofNumber, virtualNumber(Thread, S, Move));
+                if (Proof < SelectProof) {
+                    SelectProof2 = SelectProof;
+                    SelectProof = Proof;
+                    SelectEdgeValue = EdgeValue;
+                    SelectMove = Move;
+                } else if (Proof < SelectProof2) {
+                    SelectProof2 = Proof;
+                }
             }
             SumDisproof = std::min(DfPnValue::Infinity, SumDisproof);
-            const bool NodeCacheable = (MinProof == 0)
-                                           ? BestEdgeValue.NodeCacheable
-                                           : AllEdgesCacheable;
-            NodeValue = DfPnValue(MinProof, SumDisproof, NodeCacheable);
-            storeNodeToTT<C, Attacking>(S, Depth, NodeValue);
+            // A proof never relies on a repetition.
+            NodeValue = DfPnValue(
+                MinProof, SumDisproof,
+                (MinProof == 0)
+                    ? DfPnValue::NoRepetitionDepth
+                    : resolveRepetitionDepth(MinRepetitionDepth, Depth));
+            storeNodeToTT<C, Attacking>(S, Thread, Depth, NodeValue, Work());
+            if (Depth == 0) {
+                updateRootValue(NodeValue);
+            }
+            if (MinProof == 0) {
+                retainProof<C, Attacking>(S, Moves, Depth);
+            }
 
             if (NodeValue.ProofNumber >= Threshold->ProofNumber ||
-                NodeValue.DisproofNumber >= Threshold->DisproofNumber) {
+                NodeValue.DisproofNumber >= Threshold->DisproofNumber ||
+                SelectProof >= Threshold->ProofNumber) {
                 *IncomingEdgeValue = NodeValue;
                 return BestMove;
             }
 
-            assert(Threshold->DisproofNumber + BestEdgeValue.DisproofNumber >
+            assert(Threshold->DisproofNumber + SelectEdgeValue.DisproofNumber >
                    SumDisproof);
             DfPnValue EdgeThreshold(
-                std::min({Threshold->ProofNumber, MinProof2 + 1,
-                          DfPnValue::Infinity}),
+                std::min(Threshold->ProofNumber,
+                         secondBestThreshold(SelectProof2)),
                 (NodeValue.DisproofNumber >= DfPnValue::Infinity ||
                  Threshold->DisproofNumber >= DfPnValue::Infinity)
                     ? DfPnValue::Infinity
                     : std::min(Threshold->DisproofNumber +
-                                   BestEdgeValue.DisproofNumber - SumDisproof,
+                                   SelectEdgeValue.DisproofNumber - SumDisproof,
                                DfPnValue::Infinity));
 
-            S->doMove<C>(BestMove);
-            search<~C, !Attacking, WilyPromote>(S, Depth + 1, &BestEdgeValue,
-                                                &EdgeThreshold, MaxNodeCount,
-                                                MaxDepth);
-            S->undoMove<~C>();
-            storeEdgeToTT<Attacking>(S, BestMove, Depth, BestEdgeValue);
+            searchChild<C, Attacking, WilyPromote>(
+                S, Thread, SelectMove, Depth, &SelectEdgeValue, &EdgeThreshold,
+                MaxNodeCount, MaxDepth);
 
-            if (BestEdgeValue.ProofNumber == 0) {
-                NodeValue = DfPnValue(0, DfPnValue::Infinity,
-                                      BestEdgeValue.NodeCacheable);
-                storeNodeToTT<C, Attacking>(S, Depth, NodeValue);
+            if (SelectEdgeValue.ProofNumber == 0) {
+                NodeValue = DfPnValue(0, DfPnValue::Infinity);
+                storeNodeToTT<C, Attacking>(S, Thread, Depth, NodeValue,
+                                            Work());
+                retainProof<C, Attacking>(S, Moves, Depth);
                 *IncomingEdgeValue = NodeValue;
-                return BestMove;
+                return SelectMove;
             }
         }
         *IncomingEdgeValue = NodeValue;
         return core::Move32::MoveNone();
     } else { // AND node.
-        while (MaxNodeCount == 0 || SearchedNodeCount < MaxNodeCount) {
+        while (isSearchable(Thread, MaxNodeCount)) {
             uint32_t SumProof = 0;
             uint32_t MinDisproof = DfPnValue::Infinity;
-            uint32_t MinDisproof2 = DfPnValue::Infinity;
-            DfPnValue BestEdgeValue;
-            bool AllEdgesCacheable = true;
+            // Any disproven evasion disproves the node; the least
+            // path-dependent one makes the most reusable disproof.
+            int32_t MaxRepetitionDepth = std::numeric_limits<int32_t>::min();
 
             // TODO(nyashiki): [[indeterminate]] could be used in C++26.
             core::Move32 BestMove = core::Move32::MoveNone();
 
+            uint32_t SelectDisproof = DfPnValue::Infinity;
+            uint32_t SelectDisproof2 = DfPnValue::Infinity;
+            DfPnValue SelectEdgeValue;
+            core::Move32 SelectMove = core::Move32::MoveNone();
+
             for (const core::Move32 Move : Moves) {
                 bool IsFound;
                 DfPnValue EdgeValue =
-                    loadEdgeFromTT<Attacking>(S, Move, Depth, &IsFound);
+                    loadEdge<Attacking>(S, Thread, Move, Depth, &IsFound);
 
                 if (!IsFound) {
-                    EdgeValue.DisproofNumber = initialDisproofNumber(Move);
+                    if (UseHeuristicNumbers) {
+                        EdgeValue =
+                            estimateEvasionEdge<C, WilyPromote>(S, Move);
+                        storeEdgeToTT<Attacking>(S, Thread, Move, Depth,
+                                                 EdgeValue, 0);
+                    } else {
+                        EdgeValue.DisproofNumber = initialDisproofNumber(Move);
+                    }
                 }
 
-                AllEdgesCacheable &= EdgeValue.NodeCacheable;
                 SumProof += EdgeValue.ProofNumber;
 
                 if (EdgeValue.DisproofNumber < MinDisproof) {
-                    MinDisproof2 = MinDisproof;
                     MinDisproof = EdgeValue.DisproofNumber;
-                    BestEdgeValue = EdgeValue;
                     BestMove = Move;
-                } else if (EdgeValue.DisproofNumber < MinDisproof2) {
-                    MinDisproof2 = EdgeValue.DisproofNumber;
+                }
+                if (EdgeValue.DisproofNumber == 0) {
+                    MaxRepetitionDepth = std::max(MaxRepetitionDepth,
+                                                  EdgeValue.RepetitionDepth);
+                }
+
+                const uint32_t Disproof = inflate(
+                    EdgeValue.DisproofNumber, virtualNumber(Thread, S, Move));
+                if (Disproof < SelectDisproof) {
+                    SelectDisproof2 = SelectDisproof;
+                    SelectDisproof = Disproof;
+                    SelectEdgeValue = EdgeValue;
+                    SelectMove = Move;
+                } else if (Disproof < SelectDisproof2) {
+                    SelectDisproof2 = Disproof;
                 }
             }
             SumProof = std::min(DfPnValue::Infinity, SumProof);
-            const bool NodeCacheable = (MinDisproof == 0)
-                                           ? BestEdgeValue.NodeCacheable
-                                           : AllEdgesCacheable;
-            NodeValue = DfPnValue(SumProof, MinDisproof, NodeCacheable);
-            storeNodeToTT<C, Attacking>(S, Depth, NodeValue);
+            NodeValue = DfPnValue(
+                SumProof, MinDisproof,
+                (MinDisproof == 0)
+                    ? resolveRepetitionDepth(MaxRepetitionDepth, Depth)
+                    : DfPnValue::NoRepetitionDepth);
+            storeNodeToTT<C, Attacking>(S, Thread, Depth, NodeValue, Work());
+            if (SumProof == 0) {
+                retainProof<C, Attacking>(S, Moves, Depth);
+            }
 
             if (NodeValue.ProofNumber >= Threshold->ProofNumber ||
-                NodeValue.DisproofNumber >= Threshold->DisproofNumber) {
+                NodeValue.DisproofNumber >= Threshold->DisproofNumber ||
+                SelectDisproof >= Threshold->DisproofNumber) {
                 *IncomingEdgeValue = NodeValue;
                 return core::Move32::MoveNone();
             }
 
-            assert(Threshold->ProofNumber + BestEdgeValue.ProofNumber >
+            assert(Threshold->ProofNumber + SelectEdgeValue.ProofNumber >
                    SumProof);
             DfPnValue EdgeThreshold(
                 (NodeValue.ProofNumber >= DfPnValue::Infinity ||
                  Threshold->ProofNumber >= DfPnValue::Infinity)
                     ? DfPnValue::Infinity
                     : std::min(Threshold->ProofNumber +
-                                   BestEdgeValue.ProofNumber - SumProof,
+                                   SelectEdgeValue.ProofNumber - SumProof,
                                DfPnValue::Infinity),
-                std::min({Threshold->DisproofNumber, MinDisproof2 + 1,
-                          DfPnValue::Infinity}));
-
-            S->doMove<C>(BestMove);
-            search<~C, !Attacking, WilyPromote>(S, Depth + 1, &BestEdgeValue,
-                                                &EdgeThreshold, MaxNodeCount,
-                                                MaxDepth);
-            S->undoMove<~C>();
-            storeEdgeToTT<Attacking>(S, BestMove, Depth, BestEdgeValue);
-
-            if (BestEdgeValue.DisproofNumber == 0) {
-                NodeValue = DfPnValue(DfPnValue::Infinity, 0,
-                                      BestEdgeValue.NodeCacheable);
-                storeNodeToTT<C, Attacking>(S, Depth, NodeValue);
+                std::min(Threshold->DisproofNumber,
+                         secondBestThreshold(SelectDisproof2)));
+
+            searchChild<C, Attacking, WilyPromote>(
+                S, Thread, SelectMove, Depth, &SelectEdgeValue, &EdgeThreshold,
+                MaxNodeCount, MaxDepth);
+
+            if (SelectEdgeValue.DisproofNumber == 0) {
+                NodeValue = DfPnValue(
+                    DfPnValue::Infinity, 0,
+                    resolveRepetitionDepth(SelectEdgeValue.RepetitionDepth,
+                                           Depth));
+                storeNodeToTT<C, Attacking>(S, Thread, Depth, NodeValue,
+                                            Work());
                 *IncomingEdgeValue = NodeValue;
-                return BestMove;
+                return SelectMove;
             }
         }
         *IncomingEdgeValue = NodeValue;
@@ -527,6 +1293,34 @@ core::Move32 SolverImpl::search(core::internal::StateImpl* S, uint64_t Depth,
     }
 }
 
+template <core::Color C, bool Attacking, bool WilyPromote>
+void SolverImpl::searchChild(core::internal::StateImpl* S,
+                             SearchThread* Thread, core::Move32 Move,
+                             uint64_t Depth, DfPnValue* EdgeValue,
+                             DfPnValue* EdgeThreshold, uint64_t MaxNodeCount,
+                             uint64_t MaxDepth) {
+    // Mark the edge as being searched so that helper threads look elsewhere.
+    std::atomic<uint16_t>* SearchingCount = getSearchingCount(S, Move);
+    if (SearchingCount != nullptr) {
+        SearchingCount->fetch_add(1, std::memory_order_relaxed);
+    }
+
+    const uint64_t PathKey = Thread->PathKey;
+    const uint64_t NodeCountBefore = Thread->NodeCount;
+    Thread->PathKey = childPathKey(PathKey, Move, Depth);
+    S->doMove<C>(Move);
+    search<~C, !Attacking, WilyPromote>(S, Thread, Depth + 1, EdgeValue,
+                                        EdgeThreshold, MaxNodeCount, MaxDepth);
+    S->undoMove<~C>();
+    Thread->PathKey = PathKey;
+    storeEdge<Attacking>(S, Thread, Move, Depth, *EdgeValue,
+                         Thread->NodeCount - NodeCountBefore);
+
+    if (SearchingCount != nullptr) {
+        SearchingCount->fetch_sub(1, std::memory_order_relaxed);
+    }
+}
+
 template <core::Color C, bool Attacking, bool WilyPromote>
 std::vector<core::Move32> SolverImpl::findPV(core::internal::StateImpl* S,
                                              uint64_t Depth) const {
@@ -578,8 +1372,83 @@ std::vector<core::Move32> SolverImpl::findPV(core::internal::StateImpl* S,
     return BestPV;
 }
 
+template <core::Color C, bool Attacking, bool WilyPromote>
+void SolverImpl::walkProofTree(core::internal::StateImpl* S, uint64_t Depth,
+                               uint16_t MaxLength,
+                               std::vector<core::Move32>* PV) const {
+    // Each step must strictly shorten the remaining mate, which bounds the
+    // walk even if the table holds inconsistent entries.
+    DfPnProofEntry Entry;
+    if (findProof(S->getHash(), &Entry) && Entry.mateLength() <= MaxLength) {
+        if (Entry.mateLength() == 0) {
+            return;
+        }
+
+        const auto Moves =
+            Attacking ? core::internal::MoveGeneratorInternal::
+                            generateLegalCheckMoves<C, WilyPromote>(*S)
+                      : core::internal::MoveGeneratorInternal::
+                            generateLegalEvasionMoves<C, WilyPromote>(*S);
+
+        core::Move32 NextMove = core::Move32::MoveNone();
+        core::Move32 ShorterMove = core::Move32::MoveNone();
+        uint16_t NextLength = (uint16_t)(Entry.mateLength() - 1);
+        for (const core::Move32 Move : Moves) {
+            if (core::Move16(Move) == Entry.move()) {
+                NextMove = Move;
+                if constexpr (!Attacking) {
+                    break;
+                }
+            } else if constexpr (Attacking) {
+                // A sibling may have been proven with a shorter mate after
+                // this node was. One probe per check keeps the walk linear.
+                S->doMove<C>(Move);
+                DfPnProofEntry Child;
+                if (findProof(S->getHash(), &Child) &&
+                    Child.mateLength() < NextLength) {
+                    ShorterMove = Move;
+                    NextLength = Child.mateLength();
+                }
+                S->undoMove<~C>();
+            }
+        }
+        if (!ShorterMove.isNone()) {
+            NextMove = ShorterMove;
+        }
+
+        if (!NextMove.isNone()) {
+            PV->push_back(NextMove);
+            S->doMove<C>(NextMove);
+            walkProofTree<~C, !Attacking, WilyPromote>(S, Depth + 1,
+                                                       NextLength, PV);
+            S->undoMove<~C>();
+            return;
+        }
+    }
+
+    // The proof of this subtree is not retained: walk the TT instead.
+    auto Rest = findPV<C, Attacking, WilyPromote>(S, Depth);
+    PV->insert(PV->end(), Rest.begin(), Rest.end());
+}
+
 std::vector<core::Move32> SolverImpl::findPV(core::internal::StateImpl* S,
                                              bool Strict) const {
+    if (ProofTableSize > 0) {
+        std::vector<core::Move32> PV;
+        if (Strict) {
+            (S->getSideToMove() == core::Black)
+                ? walkProofTree<core::Black, true, false>(S, 0, UINT16_MAX, &PV)
+                : walkProofTree<core::White, true, false>(S, 0, UINT16_MAX,
+                                                          &PV);
+        } else {
+            (S->getSideToMove() == core::Black)
+                ? walkProofTree<core::Black, true, true>(S, 0, UINT16_MAX, &PV)
+                : walkProofTree<core::White, true, true>(S, 0, UINT16_MAX,
+                                                         &PV);
+        }
+        return PV;
+    }
+
     if (Strict) {
         return (S->getSideToMove() == core::Black)
                    ? findPV<core::Black, true, false>(S, 0)
@@ -619,37 +1488,109 @@ template <core::Color C, bool WilyPromote>
 core::Move32 SolverImpl::solve(core::internal::StateImpl* S,
                                uint64_t MaxNodeCount, uint64_t MaxDepth) {
     ++Generation;
-    if (Generation == 0) {
+    if (Generation == PersistentGeneration) {
         // Entries from a different root must not reappear when the 16-bit
         // generation wraps around.
         clearTT();
         Generation = 1;
     }
-    SearchedNodeCount = 0;
+    IsDepthLimited.store(false, std::memory_order_relaxed);
+    SearchedNodeCount.store(0, std::memory_order_relaxed);
+    ExactNodeHitCount.store(0, std::memory_order_relaxed);
+    DominatedNodeHitCount.store(0, std::memory_order_relaxed);
+    solver::dfpn::Statistics EmptyStatistics;
+    EmptyStatistics.Enabled = StatisticsEnabled;
+    std::fill(ThreadStatistics.begin(), ThreadStatistics.end(),
+              EmptyStatistics);
+    IsRootSolved = false;
+    RootBestMove = core::Move32::MoveNone();
+    RootPly = S->getPly(false);
+
+    IsClockUsed = TimeLimitMilliseconds > 0 || static_cast<bool>(Callback);
+    StartTime = Clock::now();
+    Deadline = StartTime + std::chrono::milliseconds(TimeLimitMilliseconds);
+    NextProgressTime =
+        StartTime + std::chrono::milliseconds(ProgressIntervalMilliseconds);
+    updateRootValue(DfPnValue(1, 1));
+
+    // Helpers search their own copies of the root and share only the TTs.
+    // Copies are made up front since the main thread mutates `S`.
+    std::vector<core::internal::StateImpl> HelperStates;
+    HelperStates.reserve(NumThreads - 1);
+    for (std::size_t I = 1; I < NumThreads; ++I) {
+        HelperStates.emplace_back(S->clone());
+    }
+
+    std::vector<std::thread> Helpers;
+    Helpers.reserve(NumThreads - 1);
+    for (std::size_t I = 1; I < NumThreads; ++I) {
+        Helpers.emplace_back(
+            [this, &HelperStates, I, MaxNodeCount, MaxDepth]() {
+                SearchThread Thread(
+                    I, &RepetitionTables[I * RepetitionTableSize]);
+                searchRoot<C, WilyPromote>(&HelperStates[I - 1], &Thread,
+                                           MaxNodeCount, MaxDepth);
+            });
+    }
 
+    SearchThread MainThread(0, RepetitionTables.get());
+    MainThread.ClockCountdown = ClockCheckInterval;
+    MainThread.CollectionCountdown = CollectionCheckInterval;
+    searchRoot<C, WilyPromote>(S, &MainThread, MaxNodeCount, MaxDepth);
+
+    StopRequested.store(true, std::memory_order_relaxed);
+    for (auto& Helper : Helpers) {
+        Helper.join();
+    }
+
+    if (Callback) {
+        reportProgress(&MainThread, Clock::now());
+    }
+
+    DepthLimitedGenerations[Generation] =
+        IsDepthLimited.load(std::memory_order_relaxed);
+
+    // Clear the flag here rather than at the start, so that a `stop()`
+    // issued before or while this solve was starting is not lost.
+    StopRequested.store(false, std::memory_order_relaxed);
+
+    return RootBestMove;
+}
+
+template <core::Color C, bool WilyPromote>
+void SolverImpl::searchRoot(core::internal::StateImpl* S, SearchThread* Thread,
+                            uint64_t MaxNodeCount, uint64_t MaxDepth) {
     // The root has no real incoming edge, so keep one synthetic edge value on
     // the stack. All non-root values are persisted in the edge TT.
     DfPnValue RootEdgeValue(1, 1);
     DfPnValue Threshold(DfPnValue::Infinity, DfPnValue::Infinity);
 
-    while (true) {
-        const core::Move32 BestMove = search<C, true, WilyPromote>(
-            S, 0, &RootEdgeValue, &Threshold, MaxNodeCount, MaxDepth);
-
-        if (RootEdgeValue.ProofNumber == 0) {
-            // Proven.
-            return BestMove;
-        }
-
-        if (RootEdgeValue.DisproofNumber == 0) {
-            // Disproven.
-            return core::Move32::MoveNone();
+    while (isSearchable(Thread, MaxNodeCount)) {
+        const core::Move32 BestMove =
+            search<C, true, WilyPromote>(S, Thread, 0, &RootEdgeValue,
+                                         &Threshold, MaxNodeCount, MaxDepth);
+        updateRootValue(RootEdgeValue);
+
+        if (RootEdgeValue.ProofNumber == 0 ||
+            RootEdgeValue.DisproofNumber == 0) {
+            // Whichever thread solves the root first reports the result and
+            // stops the others.
+            std::lock_guard<std::mutex> Lock(RootResultMutex);
+            if (!IsRootSolved) {
+                IsRootSolved = true;
+                RootBestMove = (RootEdgeValue.ProofNumber == 0)
+                                   ? BestMove
+                                   : core::Move32::MoveNone();
+            }
+            StopRequested.store(true, std::memory_order_relaxed);
+            break;
         }
 
-        if (MaxNodeCount > 0 && searchedNodeCount() >= MaxNodeCount) {
-            return core::Move32::MoveNone();
-        }
+        Threshold = DfPnValue(DfPnValue::Infinity, DfPnValue::Infinity);
     }
+
+    flushNodeCount(Thread);
+    ThreadStatistics[Thread->ThreadId] = Thread->Stats;
 }
 
 std::vector<core::Move32> SolverImpl::solveWithPV(core::State* S,
@@ -663,14 +1604,171 @@ std::vector<core::Move32> SolverImpl::solveWithPV(core::State* S,
         return {};
     }
 
-    // Then, traverse the tree through a terminal node with
-    // a shortest-win longest-loss move sequence.
+    // Then, traverse the proven moves down to a terminal node.
     core::internal::MutableStateAdapter Adapter(*S);
     return findPV(Adapter.get(), Strict);
 }
 
 uint64_t SolverImpl::searchedNodeCount() const {
-    return SearchedNodeCount;
+    return SearchedNodeCount.load(std::memory_order_relaxed);
+}
+
+solver::dfpn::NodeTTHits SolverImpl::nodeTTHits() const {
+    solver::dfpn::NodeTTHits Hits;
+    Hits.Exact = ExactNodeHitCount.load(std::memory_order_relaxed);
+    Hits.Dominated = DominatedNodeHitCount.load(std::memory_order_relaxed);
+    return Hits;
+}
+
+solver::dfpn::Statistics SolverImpl::statistics() const {
+    solver::dfpn::Statistics Sum;
+    Sum.Enabled = StatisticsEnabled;
+
+    const auto Add = [](solver::dfpn::Statistics::Table* To,
+                        const solver::dfpn::Statistics::Table& From) {
+        To->Hits += From.Hits;
+        To->Misses += From.Misses;
+        To->Replacements += From.Replacements;
+    };
+
+    for (const auto& Stats : ThreadStatistics) {
+        Add(&Sum.NodeTT, Stats.NodeTT);
+        Add(&Sum.EdgeTT, Stats.EdgeTT);
+        Sum.DominationHits += Stats.DominationHits;
+        Sum.RepetitionCutoffs += Stats.RepetitionCutoffs;
+        Sum.AttackerNodes += Stats.AttackerNodes;
+        Sum.AttackerMoves += Stats.AttackerMoves;
+        Sum.DefenderNodes += Stats.DefenderNodes;
+        Sum.DefenderMoves += Stats.DefenderMoves;
+        Sum.MaxDepthReached =
+            std::max(Sum.MaxDepthReached, Stats.MaxDepthReached);
+        Sum.MoveGenerationNanoseconds += Stats.MoveGenerationNanoseconds;
+        Sum.TTNanoseconds += Stats.TTNanoseconds;
+    }
+
+    return Sum;
+}
+
+std::vector<solver::dfpn::Statistics> SolverImpl::threadStatistics() const {
+    return ThreadStatistics;
+}
+
+std::size_t SolverImpl::numThreads() const {
+    return NumThreads;
+}
+
+std::size_t SolverImpl::saveTT(const std::string& Path) const {
+    std::ofstream Ofs(Path, std::ios::out | std::ios::binary);
+    if (!Ofs) {
+        throw std::runtime_error("Failed to open " + Path + ".");
+    }
+
+    TTFileHeader Header;
+    std::memcpy(Header.Magic, TTFileMagic, sizeof(TTFileMagic));
+    Header.Version = TTFileVersion;
+    Header.RecordSize = sizeof(TTFileRecord);
+    Header.NodeTTSize = NodeTTSize;
+    Header.NumRecords = 0;
+
+    // The number of records is patched after the entries are written.
+    Ofs.write(reinterpret_cast<const char*>(&Header), sizeof(Header));
+
+    // Node entries only hold solved values, so anything that has been
+    // written since the last wipe is worth keeping, whatever its generation.
+    for (std::size_t I = 0; I < NodeTTSize; ++I) {
+        for (std::size_t J = 0; J < DfPnNodeTTBundle::BundleSize; ++J) {
+            const DfPnNodeTTEntry& Entry = NodeTT[I].Entries[J];
+            if (Entry.generation() == 0) {
+                break;
+            }
+            if (Entry.proofNumber() != 0 && Entry.disproofNumber() != 0) {
+                continue;
+            }
+            // Only the disproofs depend on the depth limit: a proof found
+            // with a limit is a proof without it as well.
+            if (Entry.proofNumber() != 0 &&
+                DepthLimitedGenerations[Entry.generation()]) {
+                continue;
+            }
+
+            TTFileRecord Record;
+            Record.BundleIndex = I;
+            Record.Entry = Entry;
+            Ofs.write(reinterpret_cast<const char*>(&Record), sizeof(Record));
+            ++Header.NumRecords;
+        }
+    }
+
+    Ofs.seekp(0);
+    Ofs.write(reinterpret_cast<const char*>(&Header), sizeof(Header));
+
+    if (!Ofs) {
+        throw std::runtime_error("Failed to write " + Path + ".");
+    }
+
+    return Header.NumRecords;
+}
+
+std::size_t SolverImpl::loadTT(const std::string& Path) {
+    std::ifstream Ifs(Path, std::ios::in | std::ios::binary);
+    if (!Ifs) {
+        throw std::runtime_error("Failed to open " + Path + ".");
+    }
+
+    TTFileHeader Header;
+    Ifs.read(reinterpret_cast<char*>(&Header), sizeof(Header));
+    if (!Ifs ||
+        std::memcmp(Header.Magic, TTFileMagic, sizeof(TTFileMagic)) != 0) {
+        throw std::runtime_error("Not a df-pn transposition table file.");
+    }
+    if (Header.Version != TTFileVersion ||
+        Header.RecordSize != sizeof(TTFileRecord)) {
+        throw std::runtime_error(
+            "Unsupported df-pn transposition table file version.");
+    }
+    if (Header.NodeTTSize != NodeTTSize) {
+        // The bundle index cannot be recomputed without the search depth,
+        // so a snapshot fits only a table of the same size.
+        throw std::runtime_error("The transposition table size differs from "
+                                 "the one of the snapshot.");
+    }
+
+    std::size_t Loaded = 0;
+    for (uint64_t R = 0; R < Header.NumRecords; ++R) {
+        TTFileRecord Record;
+        Ifs.read(reinterpret_cast<char*>(&Record), sizeof(Record));
+        if (!Ifs) {
+            throw std::runtime_error("The snapshot is truncated.");
+        }
+        if (Record.BundleIndex >= NodeTTSize) {
+            throw std::runtime_error("The snapshot is broken.");
+        }
+
+        // Fill the first entry that is not loaded yet, which keeps the
+        // loaded entries packed at the front of the bundle. Any other entry
+        // is from an old search and is dead for the next one anyway.
+        DfPnNodeTTBundle& Bundle = NodeTT[Record.BundleIndex];
+        for (std::size_t J = 0; J < DfPnNodeTTBundle::BundleSize; ++J) {
+            if (Bundle.Entries[J].generation() != PersistentGeneration) {
+                Bundle.Entries[J] = Record.Entry;
+                Bundle.Entries[J].setGeneration(PersistentGeneration);
+                ++Loaded;
+                break;
+            }
+        }
+    }
+
+    return Loaded;
+}
+
+solver::dfpn::MemoryReport SolverImpl::memoryReport() const {
+    solver::dfpn::MemoryReport Report;
+    addToReport(&Report, NodeTT.memory());
+    addToReport(&Report, EdgeTT.memory());
+    if (ProofTableSize > 0) {
+        addToReport(&Report, ProofTable.memory());
+    }
+    return Report;
 }
 
 } // namespace dfpn
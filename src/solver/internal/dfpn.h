@@ -8,8 +8,18 @@
 //
 
 #include "../../core/internal/stateimpl.h"
+#include "../../core/movelist.h"
 #include "../../core/types.h"
 #include "../dfpn.h"
+#include "tablememory.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <limits>
+#include <mutex>
+#include <string>
+#include <vector>
 
 #ifndef NSHOGI_SOLVER_INTERNAL_DFPN_H
 #define NSHOGI_SOLVER_INTERNAL_DFPN_H
@@ -24,33 +34,44 @@ struct DfPnValue {
     explicit DfPnValue()
         : ProofNumber(1)
         , DisproofNumber(1)
-        , NodeCacheable(true) {
+        , RepetitionDepth(NoRepetitionDepth) {
     }
 
-    explicit DfPnValue(uint32_t P, uint32_t D, bool CanCacheNode = true)
+    explicit DfPnValue(uint32_t P, uint32_t D,
+                       int32_t Repetition = NoRepetitionDepth)
         : ProofNumber(P)
         , DisproofNumber(D)
-        , NodeCacheable(CanCacheNode) {
+        , RepetitionDepth(Repetition) {
     }
 
     bool operator==(const DfPnValue& V) const {
         return ProofNumber == V.ProofNumber &&
                DisproofNumber == V.DisproofNumber &&
-               NodeCacheable == V.NodeCacheable;
+               RepetitionDepth == V.RepetitionDepth;
+    }
+
+    bool isPathDependent() const {
+        return RepetitionDepth != NoRepetitionDepth;
     }
 
     uint32_t ProofNumber;
     uint32_t DisproofNumber;
-    // Path-dependent values remain valid for their edge but must not enter the
-    // shared node cache.
-    bool NodeCacheable;
+    // The depth of the shallowest node on the current path whose repetition
+    // the value relies on, or `NoRepetitionDepth`. It is negative if the
+    // repeated position precedes the root. A value is valid only below the
+    // node at this depth, i.e., it depends on the path to it.
+    int32_t RepetitionDepth;
 
     static constexpr uint32_t Infinity = 1 << 14;
+    static constexpr int32_t NoRepetitionDepth =
+        std::numeric_limits<int32_t>::max();
 };
 
 // A node entry is a derived cache of its outgoing edge statistics. Keeping
 // attacking stands separate from the position hash allows solved values to be
-// reused through stand superiority/inferiority.
+// reused through stand superiority/inferiority. Only solved values are kept,
+// so one of the two numbers is always zero and a flag stands in for it, which
+// leaves room for the work spent on solving the node.
 // sizeof(DfPnNodeTTEntry) == 16 byte.
 struct DfPnNodeTTEntry {
  public:
@@ -63,17 +84,25 @@ struct DfPnNodeTTEntry {
     }
 
     uint16_t proofNumber() const {
-        return ProofNumberValue;
+        return isProof() ? 0 : (NumberValue & NUMBER_MASK);
     }
 
     uint16_t disproofNumber() const {
-        return DisproofNumberValue;
+        return isProof() ? (NumberValue & NUMBER_MASK) : 0;
+    }
+
+    uint16_t work() const {
+        return WorkValue;
     }
 
     uint16_t generation() const {
         return static_cast<uint16_t>(PositionData >> HASH_BITS);
     }
 
+    bool isProof() const {
+        return (NumberValue & PROOF_FLAG) != 0;
+    }
+
     bool isSamePosition(uint64_t Hash) const {
         return (Hash >> (64 - HASH_BITS)) == positionHash();
     }
@@ -87,12 +116,14 @@ struct DfPnNodeTTEntry {
         StandsAttackingValue = static_cast<uint32_t>(Stands);
     }
 
-    void setProofNumber(uint16_t Proof) {
-        ProofNumberValue = Proof;
+    // Either of the numbers must be zero, and the other one must fit in 15
+    // bits.
+    void setValue(uint16_t Proof, uint16_t Disproof) {
+        NumberValue = (Proof == 0) ? (uint16_t)(PROOF_FLAG | Disproof) : Proof;
     }
 
-    void setDisproofNumber(uint16_t Disproof) {
-        DisproofNumberValue = Disproof;
+    void setWork(uint16_t NewWork) {
+        WorkValue = NewWork;
     }
 
     void setGeneration(uint16_t NewGeneration) {
@@ -103,8 +134,8 @@ struct DfPnNodeTTEntry {
 
     void reset() {
         StandsAttackingValue = 0;
-        ProofNumberValue = 0;
-        DisproofNumberValue = 0;
+        NumberValue = 0;
+        WorkValue = 0;
         PositionData = 0;
     }
 
@@ -112,10 +143,12 @@ struct DfPnNodeTTEntry {
     static constexpr int HASH_BITS = 48;
     static constexpr uint64_t HASH_MASK = (1ULL << HASH_BITS) - 1ULL;
     static constexpr uint64_t GENERATION_MASK = ~HASH_MASK;
+    static constexpr uint16_t PROOF_FLAG = 1 << 15;
+    static constexpr uint16_t NUMBER_MASK = PROOF_FLAG - 1;
 
     uint32_t StandsAttackingValue;
-    uint16_t ProofNumberValue;
-    uint16_t DisproofNumberValue;
+    uint16_t NumberValue;
+    uint16_t WorkValue;
     uint64_t PositionData;
 };
 
@@ -127,67 +160,77 @@ struct alignas(256) DfPnNodeTTBundle {
 
 // An entry stores the statistics for one outgoing edge. The source position
 // and Move16 uniquely identify the edge; proof/disproof numbers describe the
-// subtree reached by taking that edge.
+// subtree reached by taking that edge. Path-dependent disproofs never enter
+// the table (see `DfPnRepetitionEntry`). The work, the number of
+// nodes searched below the edge, tells how costly the entry is to rebuild.
 // sizeof(DfPnEdgeTTEntry) == 16 byte.
 struct DfPnEdgeTTEntry {
  public:
-    uint64_t sourceHash() const {
-        return SourceHash;
-    }
-
     core::Move16 move() const {
         return core::Move16::fromValue(Move);
     }
 
     uint16_t proofNumber() const {
-        return ProofNumberAndFlags & PROOF_NUMBER_MASK;
-    }
-
-    bool isNodeCacheable() const {
-        return (ProofNumberAndFlags & NOT_NODE_CACHEABLE_BIT) == 0;
+        return ProofNumber;
     }
 
     uint16_t disproofNumber() const {
         return DisproofNumber;
     }
 
+    uint16_t work() const {
+        return Work;
+    }
+
     uint16_t generation() const {
-        return Generation;
+        return static_cast<uint16_t>(SourceData >> HASH_BITS);
+    }
+
+    bool isSolved() const {
+        return ProofNumber == 0 || DisproofNumber == 0;
     }
 
     bool isSameEdge(uint64_t Hash, core::Move32 EdgeMove) const {
-        return Hash == sourceHash() && core::Move16(EdgeMove) == move();
+        return (Hash >> (64 - HASH_BITS)) == (SourceData & HASH_MASK) &&
+               core::Move16(EdgeMove) == move();
     }
 
     void setSourceHash(uint64_t Hash) {
-        SourceHash = Hash;
+        const uint64_t CurrentGeneration = SourceData & GENERATION_MASK;
+        SourceData = CurrentGeneration | (Hash >> (64 - HASH_BITS));
     }
 
     void setMove(core::Move32 EdgeMove) {
         Move = core::Move16(EdgeMove).value();
     }
 
-    void setProofNumberAndNodeCacheable(uint16_t Proof, bool Cacheable) {
-        ProofNumberAndFlags = Proof | (Cacheable ? 0 : NOT_NODE_CACHEABLE_BIT);
+    void setProofNumber(uint16_t Proof) {
+        ProofNumber = Proof;
     }
 
     void setDisproofNumber(uint16_t Disproof) {
         DisproofNumber = Disproof;
     }
 
+    void setWork(uint16_t NewWork) {
+        Work = NewWork;
+    }
+
     void setGeneration(uint16_t NewGeneration) {
-        Generation = NewGeneration;
+        const uint64_t Hash = SourceData & HASH_MASK;
+        SourceData = (static_cast<uint64_t>(NewGeneration) << HASH_BITS) | Hash;
     }
 
  private:
-    static constexpr uint16_t NOT_NODE_CACHEABLE_BIT = 1U << 15;
-    static constexpr uint16_t PROOF_NUMBER_MASK = 0x7fffU;
+    static constexpr int HASH_BITS = 48;
+    static constexpr uint64_t HASH_MASK = (1ULL << HASH_BITS) - 1ULL;
+    static constexpr uint64_t GENERATION_MASK = ~HASH_MASK;
 
-    uint64_t SourceHash;
+    uint64_t SourceData;
     uint16_t Move;
-    uint16_t ProofNumberAndFlags;
+    uint16_t ProofNumber;
     uint16_t DisproofNumber;
-    uint16_t Generation;
+    uint16_t Work;
 };
 
 // sizeof(DfPnEdgeTTBundle) == 256 byte.
@@ -196,9 +239,205 @@ struct alignas(256) DfPnEdgeTTBundle {
     DfPnEdgeTTEntry Entries[BundleSize];
 };
 
+// A disproof by repetition holds only for the paths through the repeated
+// position. Sharing it through the edge table would let it leak into other
+// paths (the graph history interaction problem), so each thread keeps it in
+// a table of its own instead, keyed by the path to the child of the edge.
+// The table has a fixed size and an entry simply replaces the one in its
+// slot: forgetting a disproof only costs a re-search.
+struct DfPnRepetitionEntry {
+    uint64_t PathKey;
+    DfPnValue Value;
+    uint16_t Generation;
+};
+
+// An entry of the proof-tree side table. It remembers, for a proven node,
+// the move to follow when extracting a PV and the number of plies to mate
+// along the retained moves. The move is chosen among the children that have
+// entries when the node is proven (the fewest plies at OR nodes and the
+// most at AND nodes). It is not revisited when a child is proven again
+// with another length. `walkProofTree()` re-checks the retained children
+// of OR nodes instead. The PV is still a mate but not necessarily the
+// shortest one.
+// sizeof(DfPnProofEntry) == 16 byte.
+struct DfPnProofEntry {
+ public:
+    uint64_t hash() const {
+        return Hash;
+    }
+
+    core::Move16 move() const {
+        return core::Move16::fromValue(Move);
+    }
+
+    uint16_t mateLength() const {
+        return MateLength;
+    }
+
+    uint16_t generation() const {
+        return Generation;
+    }
+
+    void set(uint64_t NewHash, core::Move32 NewMove, uint16_t Length,
+             uint16_t NewGeneration) {
+        Hash = NewHash;
+        Move = core::Move16(NewMove).value();
+        MateLength = Length;
+        Generation = NewGeneration;
+    }
+
+    void setGeneration(uint16_t NewGeneration) {
+        Generation = NewGeneration;
+    }
+
+ private:
+    uint64_t Hash;
+    uint16_t Move;
+    uint16_t MateLength;
+    uint16_t Generation;
+    uint16_t Padding;
+};
+
+// sizeof(DfPnProofBundle) == 64 byte.
+struct alignas(64) DfPnProofBundle {
+    static constexpr std::size_t BundleSize = 4;
+    DfPnProofEntry Entries[BundleSize];
+};
+
+// A test-and-test-and-set lock guarding a stripe of TT bundles. Bundles are
+// exactly 256 bytes, so locks live in a separate array instead of inside them.
+class SpinLock {
+ public:
+    SpinLock()
+        : Locked(false) {
+    }
+
+    void lock() noexcept {
+        while (Locked.exchange(true, std::memory_order_acquire)) {
+            while (Locked.load(std::memory_order_relaxed)) {
+            }
+        }
+    }
+
+    void unlock() noexcept {
+        Locked.store(false, std::memory_order_release);
+    }
+
+ private:
+    std::atomic<bool> Locked;
+};
+
+// Locks a TT stripe when the solver runs in parallel, and is a no-op
+// otherwise so that the single-threaded search pays nothing for it.
+class TTLockGuard {
+ public:
+    explicit TTLockGuard(SpinLock* L) noexcept
+        : Lock(L) {
+        if (Lock != nullptr) {
+            Lock->lock();
+        }
+    }
+
+    ~TTLockGuard() {
+        if (Lock != nullptr) {
+            Lock->unlock();
+        }
+    }
+
+    TTLockGuard(const TTLockGuard&) = delete;
+    TTLockGuard& operator=(const TTLockGuard&) = delete;
+
+ private:
+    SpinLock* const Lock;
+};
+
+// Whether the search collects `solver::dfpn::Statistics`. Ordinary builds
+// compile every counter update away.
+#ifdef NSHOGI_SOLVER_STATS
+inline constexpr bool StatisticsEnabled = true;
+#else
+inline constexpr bool StatisticsEnabled = false;
+#endif
+
+// Adds the duration of its scope to `*Nanoseconds` if statistics are
+// enabled and `Nanoseconds` is not null, and does nothing otherwise.
+class StatisticsTimer {
+ public:
+    explicit StatisticsTimer(uint64_t* Nanoseconds) noexcept
+        : Counter(Nanoseconds) {
+        if constexpr (StatisticsEnabled) {
+            Start = std::chrono::steady_clock::now();
+        }
+    }
+
+    ~StatisticsTimer() {
+        if constexpr (StatisticsEnabled) {
+            if (Counter == nullptr) {
+                return;
+            }
+            *Counter += (uint64_t)std::chrono::duration_cast<
+                            std::chrono::nanoseconds>(
+                            std::chrono::steady_clock::now() - Start)
+                            .count();
+        }
+    }
+
+    StatisticsTimer(const StatisticsTimer&) = delete;
+    StatisticsTimer& operator=(const StatisticsTimer&) = delete;
+
+ private:
+    uint64_t* const Counter;
+    std::chrono::steady_clock::time_point Start;
+};
+
+// Per-thread search context. Node counts are accumulated locally and
+// published to the shared counter in batches to keep the counter's cache
+// line from bouncing between threads.
+struct SearchThread {
+ public:
+    explicit SearchThread(std::size_t Id, DfPnRepetitionEntry* Repetitions)
+        : ThreadId(Id)
+        , NodeCount(0)
+        , PendingNodeCount(0)
+        , ClockCountdown(0)
+        , CollectionCountdown(0)
+        , PathKey(0)
+        , RepetitionTable(Repetitions) {
+        Stats.Enabled = StatisticsEnabled;
+    }
+
+    bool isMainThread() const {
+        return ThreadId == 0;
+    }
+
+    std::size_t ThreadId;
+
+    // The nodes searched by this thread so far. The difference between two
+    // readings is the work spent on a subtree.
+    uint64_t NodeCount;
+    uint64_t PendingNodeCount;
+
+    // Nodes left until the main thread reads the clock again.
+    uint64_t ClockCountdown;
+
+    // Nodes left until the main thread checks the fill rate of the table.
+    uint64_t CollectionCountdown;
+
+    // The key of the moves from the root to the current node.
+    uint64_t PathKey;
+
+    // The `SolverImpl::RepetitionTableSize` entries of this thread.
+    DfPnRepetitionEntry* RepetitionTable;
+
+    // Updated only if `StatisticsEnabled`.
+    solver::dfpn::Statistics Stats;
+};
+
 class SolverImpl {
  public:
-    SolverImpl(std::size_t MemoryMB);
+    SolverImpl(std::size_t MemoryMB, std::size_t NumThreads = 1,
+               const solver::dfpn::MemoryOptions& Options =
+                   solver::dfpn::MemoryOptions());
     ~SolverImpl();
 
     core::Move32 solve(core::State* S, uint64_t MaxNodeCount, uint64_t MaxDepth,
@@ -207,34 +446,187 @@ class SolverImpl {
                                           uint64_t MaxDepth, bool Strict);
 
     uint64_t searchedNodeCount() const;
+    solver::dfpn::NodeTTHits nodeTTHits() const;
+    solver::dfpn::Statistics statistics() const;
+    std::vector<solver::dfpn::Statistics> threadStatistics() const;
+    std::size_t numThreads() const;
+    solver::dfpn::MemoryReport memoryReport() const;
+
+    std::size_t saveTT(const std::string& Path) const;
+    std::size_t loadTT(const std::string& Path);
+
+    // Allocates the proof-tree side table with `MemoryMB` megabytes, or
+    // releases it if `MemoryMB` is 0.
+    void setProofTreeRetention(std::size_t MemoryMB);
+
+    void setHeuristics(const solver::dfpn::Heuristics& H);
+    void setGarbageCollection(const solver::dfpn::GarbageCollection& GC);
+    void setTimeLimit(uint64_t Milliseconds);
+    void stop();
+    void setProgressCallback(solver::dfpn::ProgressCallback Callback,
+                             uint64_t IntervalMilliseconds);
+
+    // The df-pn+ estimate of the attacker node `Evasion` leads to, used
+    // before the node is searched when `Heuristics::InitialNumbers` is set.
+    template <core::Color C, bool WilyPromote>
+    static DfPnValue estimateEvasionEdge(core::internal::StateImpl* S,
+                                         core::Move32 Evasion);
 
  private:
+    using Clock = std::chrono::steady_clock;
+
+    // Publish thread-local node counts every this many nodes.
+    static constexpr uint64_t NodeCountFlushInterval = 256;
+
+    // The main thread reads the clock every this many nodes, which is a few
+    // milliseconds at typical speeds.
+    static constexpr uint64_t ClockCheckInterval = 1024;
+
+    // The number of edge bundles sampled to estimate the fill rate.
+    static constexpr std::size_t FillRateSampleSize = 64;
+
+    // The main thread checks the fill rate every this many nodes.
+    static constexpr uint64_t CollectionCheckInterval = 4096;
+
+    // The number of edge bundles sampled to find the values to collect.
+    static constexpr std::size_t CollectionSampleSize = 1024;
+
+    // The least disproof number `estimateEvasionEdge()` gives to an attacker
+    // node with a mate in one. It is above every initial disproof number so
+    // that an evasion allowing a mate in one is tried after all the others.
+    static constexpr uint32_t MateIn1DisproofNumber = 8;
+
+    // The number of entries of `SearchThread::RepetitionTable`.
+    static constexpr std::size_t RepetitionTableSize = 1 << 16;
+
+    // The fixed-point scale of `ThresholdEpsilonScaled`.
+    static constexpr uint32_t ThresholdEpsilonScale = 256;
+
+    uint32_t secondBestThreshold(uint32_t SecondBest) const;
+
+    // Edges being searched by some thread look this much harder to helper
+    // threads per searching thread, so that helpers spread over the tree.
+    static constexpr uint32_t VirtualProofNumber = 4;
+
     void clearTT();
 
+    // Frees about `CollectionRatio` of the live edge entries, the least
+    // valuable ones by `retentionValue()`.
+    void collectGarbage();
+
+    // Solved entries rank above every unsolved one, and more work ranks
+    // higher within each of the two tiers.
+    static uint32_t retentionValue(const DfPnEdgeTTEntry& Entry) {
+        return (Entry.isSolved() ? (1U << 16) : 0U) | Entry.work();
+    }
+
+    static uint16_t saturateWork(uint64_t Work) {
+        return (uint16_t)std::min<uint64_t>(Work, UINT16_MAX);
+    }
+
+    // Node entries loaded by `loadTT()` carry this generation and are live
+    // in every search. `Generation` never takes this value.
+    static constexpr uint16_t PersistentGeneration = 0xffff;
+
+    bool isLiveNodeEntry(const DfPnNodeTTEntry& Entry) const {
+        return Entry.generation() == Generation ||
+               Entry.generation() == PersistentGeneration;
+    }
+
+    template <bool Attacking>
+    std::size_t nodeTTIndex(uint64_t PositionHash, uint64_t Depth) const;
+    template <bool Attacking>
+    std::size_t edgeTTIndex(uint64_t EdgeHash, uint64_t Depth) const;
+
     template <core::Color C, bool Attacking>
-    void storeNodeToTT(core::internal::StateImpl* S, uint64_t Depth,
-                       const DfPnValue& Value);
+    void prefetchChildren(const core::internal::StateImpl* S,
+                          const core::MoveList& Moves, uint64_t Depth) const;
+
+    SpinLock* getNodeTTLock(std::size_t Index) const;
+    SpinLock* getEdgeTTLock(std::size_t Index) const;
+
+    std::atomic<uint16_t>* getSearchingCount(core::internal::StateImpl* S,
+                                            core::Move32 Move) const;
+    uint32_t virtualNumber(const SearchThread* Thread,
+                           core::internal::StateImpl* S,
+                           core::Move32 Move) const;
+
+    void countNode(SearchThread* Thread);
+    void checkClock(SearchThread* Thread);
+    void reportProgress(const SearchThread* Thread, Clock::time_point Now);
+    void updateRootValue(const DfPnValue& Value);
+    double ttFillRate() const;
+    void flushNodeCount(SearchThread* Thread);
+    bool isSearchable(const SearchThread* Thread, uint64_t MaxNodeCount) const;
+
+    // The statistics of the table accesses go to `Thread` if it is given.
+    // `Work` is the number of nodes searched to obtain `Value`.
+    template <core::Color C, bool Attacking>
+    void storeNodeToTT(core::internal::StateImpl* S, SearchThread* Thread,
+                       uint64_t Depth, const DfPnValue& Value, uint64_t Work);
 
     template <core::Color C, bool Attacking>
     DfPnValue loadNodeFromTT(core::internal::StateImpl* S, uint64_t Depth,
-                             bool* IsFound) const;
+                             bool* IsFound,
+                             SearchThread* Thread = nullptr) const;
 
+    // `Work` is the number of nodes searched below the edge since the last
+    // store, and adds up on the entry.
     template <bool Attacking>
-    void storeEdgeToTT(core::internal::StateImpl* S, core::Move32 Move,
-                       uint64_t Depth, const DfPnValue& Value);
+    void storeEdgeToTT(core::internal::StateImpl* S, SearchThread* Thread,
+                       core::Move32 Move, uint64_t Depth,
+                       const DfPnValue& Value, uint64_t Work);
 
     template <bool Attacking>
     DfPnValue loadEdgeFromTT(core::internal::StateImpl* S, core::Move32 Move,
                              uint64_t Depth, bool* IsFound) const;
 
+    // Look up the repetition table of the thread before the edge table, and
+    // keep path-dependent disproofs out of the edge table.
+    template <bool Attacking>
+    DfPnValue loadEdge(core::internal::StateImpl* S, SearchThread* Thread,
+                       core::Move32 Move, uint64_t Depth, bool* IsFound) const;
+    template <bool Attacking>
+    void storeEdge(core::internal::StateImpl* S, SearchThread* Thread,
+                   core::Move32 Move, uint64_t Depth, const DfPnValue& Value,
+                   uint64_t Work);
+
+    // The depth of the repetition the current position makes, as a
+    // `DfPnValue::RepetitionDepth`. Must be called on a repetition.
+    int32_t repetitionDepth(const core::internal::StateImpl* S) const;
+
     template <core::Color C, bool WilyPromote>
     core::Move32 solve(core::internal::StateImpl* S, uint64_t MaxNodeCount,
                        uint64_t MaxDepth);
 
+    template <core::Color C, bool WilyPromote>
+    void searchRoot(core::internal::StateImpl* S, SearchThread* Thread,
+                    uint64_t MaxNodeCount, uint64_t MaxDepth);
+
     template <core::Color C, bool Attacking, bool WilyPromote>
-    core::Move32 search(core::internal::StateImpl* S, uint64_t Depth,
-                        DfPnValue* IncomingEdgeValue, DfPnValue* Threshold,
-                        uint64_t MaxNodeCount, uint64_t MaxDepth);
+    core::Move32 search(core::internal::StateImpl* S, SearchThread* Thread,
+                        uint64_t Depth, DfPnValue* IncomingEdgeValue,
+                        DfPnValue* Threshold, uint64_t MaxNodeCount,
+                        uint64_t MaxDepth);
+
+    template <core::Color C, bool Attacking, bool WilyPromote>
+    void searchChild(core::internal::StateImpl* S, SearchThread* Thread,
+                     core::Move32 Move, uint64_t Depth, DfPnValue* EdgeValue,
+                     DfPnValue* EdgeThreshold, uint64_t MaxNodeCount,
+                     uint64_t MaxDepth);
+
+    bool findProof(uint64_t Hash, DfPnProofEntry* Entry) const;
+    void storeProof(uint64_t Hash, core::Move32 Move, uint16_t MateLength);
+    // Records the proof of the current node computed from its children's
+    // side-table entries. Does nothing if retention is disabled or a
+    // needed child entry is missing.
+    template <core::Color C, bool Attacking>
+    void retainProof(core::internal::StateImpl* S, const core::MoveList& Moves,
+                     uint64_t Depth);
+
+    template <core::Color C, bool Attacking, bool WilyPromote>
+    void walkProofTree(core::internal::StateImpl* S, uint64_t Depth,
+                       uint16_t MaxLength, std::vector<core::Move32>* PV) const;
 
     template <core::Color C, bool Attacking, bool WilyPromote>
     std::vector<core::Move32> findPV(core::internal::StateImpl* S,
@@ -243,13 +635,78 @@ class SolverImpl {
                                      bool Strict) const;
 
     std::size_t NodeTTSize;
-    std::unique_ptr<DfPnNodeTTBundle[]> NodeTT;
+    TableArray<DfPnNodeTTBundle> NodeTT;
 
     std::size_t EdgeTTSize;
-    std::unique_ptr<DfPnEdgeTTBundle[]> EdgeTT;
+    TableArray<DfPnEdgeTTBundle> EdgeTT;
+
+    // The proof-tree side table. Empty unless retention is enabled.
+    std::size_t ProofTableSize;
+    TableArray<DfPnProofBundle> ProofTable;
+    solver::dfpn::MemoryOptions TableOptions;
 
+    std::size_t NumThreads;
+
+    // Allocated only for parallel search.
+    std::size_t NodeTTLockCount;
+    std::unique_ptr<SpinLock[]> NodeTTLocks;
+    std::size_t EdgeTTLockCount;
+    std::unique_ptr<SpinLock[]> EdgeTTLocks;
+    std::size_t SearchingCountSize;
+    std::unique_ptr<std::atomic<uint16_t>[]> SearchingCounts;
+
+    // `SearchThread::RepetitionTable` of every thread, one after another.
+    std::unique_ptr<DfPnRepetitionEntry[]> RepetitionTables;
+
+    // Bumped by every `solve()`. Entries of any other generation are
+    // treated as empty, so starting a new problem costs O(1); the tables are
+    // wiped only when the counter wraps around.
     uint16_t Generation;
-    uint64_t SearchedNodeCount;
+
+    // Whether the `MaxDepth` cutoff disproved a node in the current solve,
+    // and, by generation, whether it did in the solve of that generation.
+    // The disproofs of such a solve may not hold without its depth limit.
+    std::atomic<bool> IsDepthLimited;
+    std::vector<bool> DepthLimitedGenerations;
+
+    std::atomic<uint64_t> SearchedNodeCount;
+
+    // The ply of the root, from which repetition depths are measured.
+    uint16_t RootPly;
+
+    // Solved node entries are rarely hit compared to the searched nodes, so
+    // shared counters do not cause contention.
+    mutable std::atomic<uint64_t> ExactNodeHitCount;
+    mutable std::atomic<uint64_t> DominatedNodeHitCount;
+
+    // The statistics of the last solve, by thread id. Each thread writes
+    // its own slot when it finishes its search.
+    std::vector<solver::dfpn::Statistics> ThreadStatistics;
+
+    std::atomic<bool> StopRequested;
+
+    std::mutex RootResultMutex;
+    bool IsRootSolved;
+    core::Move32 RootBestMove;
+
+    bool UseHeuristicNumbers;
+    uint32_t ThresholdEpsilonScaled;
+
+    // Garbage collection is off if the threshold is 1 or more.
+    double CollectionFillRateThreshold;
+    double CollectionRatio;
+
+    // The time limit and the progress reports, both driven by the main
+    // thread. `IsClockUsed` is set iff either of them is enabled.
+    uint64_t TimeLimitMilliseconds;
+    solver::dfpn::ProgressCallback Callback;
+    uint64_t ProgressIntervalMilliseconds;
+    bool IsClockUsed;
+    Clock::time_point StartTime;
+    Clock::time_point Deadline;
+    Clock::time_point NextProgressTime;
+    std::atomic<uint32_t> RootProofNumber;
+    std::atomic<uint32_t> RootDisproofNumber;
 };
 
 } // namespace dfpn
@@ -0,0 +1,243 @@
+//
+// Copyright (c) 2025-2026 @nyashiki
+//
+// This software is licensed under the MIT license.
+// For details, see the LICENSE file in the root of this repository.
+//
+// SPDX-License-Identifier: MIT
+//
+
+#include "dfs.h"
+#include "../../core/internal/movegenerator.h"
+#include "../../core/internal/stateadapter.h"
+#include "mate1ply.h"
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+
+namespace nshogi {
+namespace solver {
+namespace internal {
+namespace dfs {
+
+SolverImpl::SolverImpl(std::size_t MemoryKB)
+    : NodeCount(0) {
+    static_assert(sizeof(DfsTTEntry) == 16);
+
+    // A power of two so that an index is a mask of the hash.
+    const std::size_t Size = std::bit_floor(std::max<std::size_t>(
+        1, MemoryKB * 1024ULL / sizeof(DfsTTEntry)));
+    TT.resize(Size);
+    TTMask = Size - 1;
+}
+
+core::Move32 SolverImpl::solve(core::State* S, int Limit) {
+    core::internal::MutableStateAdapter Adapter(*S);
+    if (S->getSideToMove() == core::Black) {
+        return solve<core::Black>(Adapter.get(), Limit);
+    } else {
+        return solve<core::White>(Adapter.get(), Limit);
+    }
+}
+
+uint64_t SolverImpl::searchedNodeCount() const {
+    return NodeCount;
+}
+
+template <core::Color C>
+core::Move32 SolverImpl::solve(core::internal::StateImpl* S, int Limit) {
+    NodeCount = 0;
+    Killers.assign((std::size_t)std::max(Limit, 0) + 1,
+                   core::Move32::MoveNone());
+
+    // Mates only end on odd plies. Each iteration leaves its mating moves and
+    // refutations in the table and the killers, which order the next one,
+    // and the first mate found is a shortest one.
+    for (int Depth = 1; Depth <= Limit; Depth += 2) {
+        const core::Move32 Move = attack<C>(S, 0, Depth);
+        if (!Move.isNone()) {
+            return Move;
+        }
+    }
+
+    return core::Move32::MoveNone();
+}
+
+template <core::Color C>
+core::Move32 SolverImpl::attack(core::internal::StateImpl* S, int Ply,
+                                int Limit) {
+    ++NodeCount;
+
+    if (Limit <= 0) {
+        return core::Move32::MoveNone();
+    }
+
+    const uint64_t Hash = S->getHash();
+    core::Move16 TTMove = core::Move16::MoveNone();
+    if (const DfsTTEntry* Entry = probe(Hash)) {
+        if (Entry->kind() == DfsTTEntry::Kind::Disproven &&
+            Entry->depth() >= Limit) {
+            return core::Move32::MoveNone();
+        }
+        if (Entry->kind() == DfsTTEntry::Kind::Proven &&
+            Entry->depth() <= Limit && S->isLegal<C>(Entry->move())) {
+            return S->getMove32FromMove16(Entry->move());
+        }
+        TTMove = Entry->move();
+    }
+
+    const auto Move1Ply = mate1ply::solve<C>(*S);
+    if (!Move1Ply.isNone()) {
+        store(Hash, Move1Ply, 1, DfsTTEntry::Kind::Proven);
+        return Move1Ply;
+    }
+
+    auto CheckMoves = [&]() {
+        if (Limit > 3 && S->getStandCount<C, core::PTK_Pawn>() > 0) {
+            // Generate non-promoting moves to avoid utifu-dume rule.
+            return core::internal::MoveGeneratorInternal::
+                generateLegalCheckMoves<C, false>(*S);
+        } else {
+            return core::internal::MoveGeneratorInternal::
+                generateLegalCheckMoves<C, true>(*S);
+        }
+    }();
+    orderMoves(&CheckMoves, TTMove, Killers[(std::size_t)Ply], true);
+
+    for (const core::Move32 Move : CheckMoves) {
+        S->doMove<C>(Move);
+
+        const auto CounterMove = defence<~C>(S, Ply + 1, Limit - 1);
+
+        S->undoMove<~C>();
+
+        if (CounterMove.isNone()) {
+            Killers[(std::size_t)Ply] = Move;
+            store(Hash, Move, Limit, DfsTTEntry::Kind::Proven);
+            return Move;
+        }
+    }
+
+    store(Hash, core::Move32::MoveNone(), Limit, DfsTTEntry::Kind::Disproven);
+    return core::Move32::MoveNone();
+}
+
+template <core::Color C>
+core::Move32 SolverImpl::defence(core::internal::StateImpl* S, int Ply,
+                                 int Limit) {
+    assert(!S->getCheckerBB().isZero());
+    ++NodeCount;
+
+    // Positions without any evasion are never stored: whether they are mated
+    // depends on the last move (utifu-dume), not only on the position.
+    const uint64_t Hash = S->getHash();
+    core::Move16 TTMove = core::Move16::MoveNone();
+    if (Limit > 1) {
+        if (const DfsTTEntry* Entry = probe(Hash)) {
+            if (Entry->kind() == DfsTTEntry::Kind::Proven &&
+                Entry->depth() <= Limit) {
+                return core::Move32::MoveNone();
+            }
+            if (Entry->kind() == DfsTTEntry::Kind::Disproven &&
+                Entry->depth() >= Limit && S->isLegal<C>(Entry->move())) {
+                return S->getMove32FromMove16(Entry->move());
+            }
+            TTMove = Entry->move();
+        }
+    }
+
+    auto DefenceMoves =
+        core::internal::MoveGeneratorInternal::generateLegalEvasionMoves<C,
+                                                                         true>(
+            *S);
+
+    if (DefenceMoves.size() == 0) {
+        const core::Move32 LastMove = S->getLastMove();
+        if (LastMove.drop() && LastMove.pieceType() == core::PTK_Pawn) {
+            // Rule: utchifu-dume.
+            return core::Move32::MoveWin();
+        }
+        return core::Move32::MoveNone();
+    }
+
+    if (Limit <= 1) {
+        return DefenceMoves[0];
+    }
+
+    orderMoves(&DefenceMoves, TTMove, Killers[(std::size_t)Ply], false);
+
+    for (const core::Move32 Move : DefenceMoves) {
+        S->doMove<C>(Move);
+
+        const auto CheckMove = attack<~C>(S, Ply + 1, Limit - 1);
+
+        S->undoMove<~C>();
+
+        if (CheckMove.isNone()) {
+            Killers[(std::size_t)Ply] = Move;
+            store(Hash, Move, Limit, DfsTTEntry::Kind::Disproven);
+            return Move;
+        }
+    }
+
+    store(Hash, core::Move32::MoveNone(), Limit, DfsTTEntry::Kind::Proven);
+    return core::Move32::MoveNone();
+}
+
+void SolverImpl::orderMoves(core::MoveList* Moves, core::Move16 TTMove,
+                            core::Move32 Killer, bool Attacking) const {
+    // Captures are the cheapest way to resolve a check or to break the
+    // defence, and drops (mostly interpositions or far checks) are the least
+    // likely to succeed.
+    const auto Rank = [&](core::Move32 Move) {
+        if (core::Move16(Move) == TTMove) {
+            return 0;
+        }
+        if (Move == Killer) {
+            return 1;
+        }
+        if (Move.drop()) {
+            return 5;
+        }
+        if (Move.capturePieceType() != core::PTK_Empty) {
+            return 2;
+        }
+        if (!Attacking && Move.pieceType() == core::PTK_King) {
+            return 3;
+        }
+        return 4;
+    };
+
+    // A stable insertion sort, which needs no buffer unlike
+    // `std::stable_sort()`.
+    for (std::size_t I = 1; I < Moves->size(); ++I) {
+        const core::Move32 Move = (*Moves)[I];
+        const int R = Rank(Move);
+        std::size_t J = I;
+        while (J > 0 && Rank((*Moves)[J - 1]) > R) {
+            (*Moves)[J] = (*Moves)[J - 1];
+            --J;
+        }
+        (*Moves)[J] = Move;
+    }
+}
+
+DfsTTEntry* SolverImpl::probe(uint64_t Hash) {
+    DfsTTEntry* Entry = &TT[Hash & TTMask];
+    if (Entry->kind() == DfsTTEntry::Kind::Empty || Entry->hash() != Hash) {
+        return nullptr;
+    }
+    return Entry;
+}
+
+void SolverImpl::store(uint64_t Hash, core::Move32 Move, int Limit,
+                       DfsTTEntry::Kind Kind) {
+    TT[Hash & TTMask].set(Hash, Move, (uint8_t)std::min(Limit, UINT8_MAX),
+                          Kind);
+}
+
+} // namespace dfs
+} // namespace internal
+} // namespace solver
+} // namespace nshogi
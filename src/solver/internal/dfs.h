@@ -0,0 +1,118 @@
+//
+// Copyright (c) 2025-2026 @nyashiki
+//
+// This software is licensed under the MIT license.
+// For details, see the LICENSE file in the root of this repository.
+//
+// SPDX-License-Identifier: MIT
+//
+
+#include "../../core/internal/stateimpl.h"
+#include "../../core/movelist.h"
+#include "../../core/state.h"
+#include "../../core/types.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#ifndef NSHOGI_SOLVER_INTERNAL_DFS_H
+#define NSHOGI_SOLVER_INTERNAL_DFS_H
+
+namespace nshogi {
+namespace solver {
+namespace internal {
+namespace dfs {
+
+// A bound on the number of plies to mate from a position. Results do not
+// depend on the path to the position, so entries stay valid across solves.
+// sizeof(DfsTTEntry) == 16 byte.
+struct DfsTTEntry {
+ public:
+    enum class Kind : uint8_t {
+        Empty,
+        Proven,    // Mated within `depth()` plies.
+        Disproven, // Not mated within `depth()` plies.
+    };
+
+    uint64_t hash() const {
+        return Hash;
+    }
+
+    // The mating move at attacker nodes, and the refutation at defender
+    // nodes. Only used to order the moves.
+    core::Move16 move() const {
+        return core::Move16::fromValue(Move);
+    }
+
+    uint8_t depth() const {
+        return Depth;
+    }
+
+    Kind kind() const {
+        return static_cast<Kind>(KindValue);
+    }
+
+    void set(uint64_t NewHash, core::Move32 NewMove, uint8_t NewDepth,
+             Kind NewKind) {
+        Hash = NewHash;
+        Move = core::Move16(NewMove).value();
+        Depth = NewDepth;
+        KindValue = static_cast<uint8_t>(NewKind);
+    }
+
+ private:
+    uint64_t Hash;
+    uint16_t Move;
+    uint8_t Depth;
+    uint8_t KindValue;
+    uint32_t Padding;
+};
+
+class SolverImpl {
+ public:
+    explicit SolverImpl(std::size_t MemoryKB);
+
+    core::Move32 solve(core::State* S, int Limit);
+
+    uint64_t searchedNodeCount() const;
+
+ private:
+    template <core::Color C>
+    core::Move32 solve(core::internal::StateImpl* S, int Limit);
+
+    // `Ply` is the distance from the root and `Limit` the number of plies
+    // left. A null move means no mate within `Limit` plies.
+    template <core::Color C>
+    core::Move32 attack(core::internal::StateImpl* S, int Ply, int Limit);
+
+    // Returns a refutation, or a null move if every evasion is mated within
+    // `Limit` plies.
+    template <core::Color C>
+    core::Move32 defence(core::internal::StateImpl* S, int Ply, int Limit);
+
+    // Tries the moves most likely to succeed first: the table move, the
+    // killer of the ply, then board moves before drops.
+    void orderMoves(core::MoveList* Moves, core::Move16 TTMove,
+                    core::Move32 Killer, bool Attacking) const;
+
+    DfsTTEntry* probe(uint64_t Hash);
+    void store(uint64_t Hash, core::Move32 Move, int Limit,
+               DfsTTEntry::Kind Kind);
+
+    std::vector<DfsTTEntry> TT;
+    std::size_t TTMask;
+
+    // The last move that succeeded at each ply: a mating move for the
+    // attacker and a refutation for the defender.
+    std::vector<core::Move32> Killers;
+
+    uint64_t NodeCount;
+};
+
+} // namespace dfs
+} // namespace internal
+} // namespace solver
+} // namespace nshogi
+
+#endif // #ifndef NSHOGI_SOLVER_INTERNAL_DFS_H
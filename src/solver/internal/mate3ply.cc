@@ -0,0 +1,114 @@
+//
+// Copyright (c) 2025-2026 @nyashiki
+//
+// This software is licensed under the MIT license.
+// For details, see the LICENSE file in the root of this repository.
+//
+// SPDX-License-Identifier: MIT
+//
+
+#include "mate3ply.h"
+#include "../../core/internal/movegenerator.h"
+#include "mate1ply.h"
+
+#include <cassert>
+
+namespace nshogi {
+namespace solver {
+namespace internal {
+namespace mate3ply {
+
+namespace {
+
+template <core::Color C, int Plies>
+core::Move32 attack(core::internal::StateImpl* S);
+
+// Whether the defender (~C), who is in check, is mated within `Plies`
+// plies. Move lists live on the stack, so nothing is allocated.
+template <core::Color C, int Plies>
+bool isMated(core::internal::StateImpl* S) {
+    assert(!S->getCheckerBB().isZero());
+
+    const auto Evasions = core::internal::MoveGeneratorInternal::
+        generateLegalEvasionMoves<~C, true>(*S);
+
+    if (Evasions.size() == 0) {
+        const core::Move32 LastMove = S->getLastMove();
+        // Rule: utifu-dume.
+        return !(LastMove.drop() && LastMove.pieceType() == core::PTK_Pawn);
+    }
+
+    if constexpr (Plies < 2) {
+        return false;
+    } else {
+        for (const core::Move32 Evasion : Evasions) {
+            S->doMove<~C>(Evasion);
+            const bool Mated = !attack<C, Plies - 1>(S).isNone();
+            S->undoMove<C>();
+
+            if (!Mated) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+}
+
+template <core::Color C, int Plies>
+core::Move32 attack(core::internal::StateImpl* S) {
+    // Most mates in one are found here without trying every check.
+    const core::Move32 Move1Ply = mate1ply::solve<C>(*S);
+    if (!Move1Ply.isNone()) {
+        return Move1Ply;
+    }
+
+    // `mate1ply::solve()` misses a few mates (some slider moves, promotions
+    // and drops), so the last ply tries every check as well to keep the
+    // search complete. As in `dfs::attack()`, non-promoting moves are
+    // generated when a pawn drop may follow: a promoted piece could turn
+    // the final pawn drop into utifu-dume.
+    const auto CheckMoves = [&]() {
+        if (Plies > 3 && S->getStandCount<C, core::PTK_Pawn>() > 0) {
+            return core::internal::MoveGeneratorInternal::
+                generateLegalCheckMoves<C, false>(*S);
+        } else {
+            return core::internal::MoveGeneratorInternal::
+                generateLegalCheckMoves<C, true>(*S);
+        }
+    }();
+
+    for (const core::Move32 Move : CheckMoves) {
+        S->doMove<C>(Move);
+        const bool Mated = isMated<C, Plies - 1>(S);
+        S->undoMove<~C>();
+
+        if (Mated) {
+            return Move;
+        }
+    }
+
+    return core::Move32::MoveNone();
+}
+
+} // namespace
+
+template <core::Color C, int Plies>
+core::Move32 solve(core::internal::StateImpl* S) {
+    static_assert(Plies == 3 || Plies == 5);
+    return attack<C, Plies>(S);
+}
+
+template core::Move32
+solve<core::Black, 3>(core::internal::StateImpl* S);
+template core::Move32
+solve<core::White, 3>(core::internal::StateImpl* S);
+template core::Move32
+solve<core::Black, 5>(core::internal::StateImpl* S);
+template core::Move32
+solve<core::White, 5>(core::internal::StateImpl* S);
+
+} // namespace mate3ply
+} // namespace internal
+} // namespace solver
+} // namespace nshogi
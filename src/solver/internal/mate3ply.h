@@ -0,0 +1,31 @@
+//
+// Copyright (c) 2025-2026 @nyashiki
+//
+// This software is licensed under the MIT license.
+// For details, see the LICENSE file in the root of this repository.
+//
+// SPDX-License-Identifier: MIT
+//
+
+#ifndef NSHOGI_SOLVER_INTERNAL_MATE3PLY_H
+#define NSHOGI_SOLVER_INTERNAL_MATE3PLY_H
+
+#include "../../core/internal/stateimpl.h"
+#include "../../core/types.h"
+
+namespace nshogi {
+namespace solver {
+namespace internal {
+namespace mate3ply {
+
+// Finds a mate within `Plies` (3 or 5) plies by trying every check and
+// every evasion. `S` is restored on return.
+template <core::Color C, int Plies>
+core::Move32 solve(core::internal::StateImpl* S);
+
+} // namespace mate3ply
+} // namespace internal
+} // namespace solver
+} // namespace nshogi
+
+#endif // #ifndef NSHOGI_SOLVER_INTERNAL_MATE3PLY_H
@@ -0,0 +1,245 @@
+//
+// Copyright (c) 2025-2026 @nyashiki
+//
+// This software is licensed under the MIT license.
+// For details, see the LICENSE file in the root of this repository.
+//
+// SPDX-License-Identifier: MIT
+//
+
+#include "tablememory.h"
+
+#include <cstdint>
+#include <cstring>
+#include <new>
+
+#ifdef __linux__
+
+#include <fstream>
+#include <string>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <vector>
+
+#endif
+
+namespace nshogi {
+namespace solver {
+namespace internal {
+
+namespace {
+
+#ifdef __linux__
+
+// The default huge page size on x86-64 and most aarch64 kernels. A kernel
+// with a different default size makes MAP_HUGETLB fail, and we fall back.
+constexpr std::size_t HugePageSize = 2ULL * 1024ULL * 1024ULL;
+
+// From <numaif.h>, which is not installed without libnuma.
+constexpr int MPOL_BIND_ = 2;
+constexpr int MPOL_INTERLEAVE_ = 3;
+
+std::size_t roundUp(std::size_t Value, std::size_t Unit) {
+    return (Value + Unit - 1) / Unit * Unit;
+}
+
+// Parses a node list such as "0-1,3" in /sys/devices/system/node/online.
+std::vector<int> onlineNumaNodes() {
+    std::vector<int> Nodes;
+
+    std::ifstream Ifs("/sys/devices/system/node/online");
+    std::string List;
+    if (!std::getline(Ifs, List)) {
+        return Nodes;
+    }
+
+    std::size_t Pos = 0;
+    while (Pos < List.size()) {
+        std::size_t End = List.find(',', Pos);
+        if (End == std::string::npos) {
+            End = List.size();
+        }
+
+        const std::string Range = List.substr(Pos, End - Pos);
+        const std::size_t Dash = Range.find('-');
+        try {
+            const int First = std::stoi(Range.substr(0, Dash));
+            const int Last = (Dash == std::string::npos)
+                                 ? First
+                                 : std::stoi(Range.substr(Dash + 1));
+            for (int Node = First; Node <= Last; ++Node) {
+                Nodes.push_back(Node);
+            }
+        } catch (...) {
+            return {};
+        }
+
+        Pos = End + 1;
+    }
+
+    return Nodes;
+}
+
+// Must be called before the pages are touched.
+bool applyNumaPolicy(void* Data, std::size_t Bytes,
+                     const solver::dfpn::MemoryOptions& Options) {
+    if (Options.Numa == solver::dfpn::NumaPolicy::Default) {
+        return false;
+    }
+
+    const std::vector<int> Nodes = onlineNumaNodes();
+    if (Nodes.size() <= 1) {
+        // Nothing to interleave or bind to on a single-node machine.
+        return false;
+    }
+
+    constexpr std::size_t BitsPerWord = 8 * sizeof(unsigned long);
+    std::vector<unsigned long> Mask(4, 0);
+    int Mode = MPOL_INTERLEAVE_;
+
+    if (Options.Numa == solver::dfpn::NumaPolicy::Interleave) {
+        for (const int Node : Nodes) {
+            if ((std::size_t)Node < Mask.size() * BitsPerWord) {
+                Mask[(std::size_t)Node / BitsPerWord] |=
+                    1UL << ((std::size_t)Node % BitsPerWord);
+            }
+        }
+    } else {
+        if (Options.NumaNode < 0 ||
+            (std::size_t)Options.NumaNode >= Mask.size() * BitsPerWord) {
+            return false;
+        }
+        Mode = MPOL_BIND_;
+        Mask[(std::size_t)Options.NumaNode / BitsPerWord] |=
+            1UL << ((std::size_t)Options.NumaNode % BitsPerWord);
+    }
+
+    return ::syscall(SYS_mbind, Data, Bytes, Mode, Mask.data(),
+                     Mask.size() * BitsPerWord + 1, 0) == 0;
+}
+
+void* mapAnonymous(std::size_t Bytes) {
+    void* Data = ::mmap(nullptr, Bytes, PROT_READ | PROT_WRITE,
+                        MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    return (Data == MAP_FAILED) ? nullptr : Data;
+}
+
+// Maps `Bytes` of anonymous memory whose start is aligned to `Alignment`,
+// which must be a multiple of the page size. The kernel can back only
+// aligned regions with transparent huge pages.
+void* mapAligned(std::size_t Bytes, std::size_t Alignment) {
+    const std::size_t Length = Bytes + Alignment;
+    void* Raw = mapAnonymous(Length);
+    if (Raw == nullptr) {
+        return nullptr;
+    }
+
+    const uintptr_t Begin = reinterpret_cast<uintptr_t>(Raw);
+    const uintptr_t Aligned = (Begin + Alignment - 1) & ~(Alignment - 1);
+    const std::size_t Head = Aligned - Begin;
+    const std::size_t Tail = Length - Head - Bytes;
+
+    if (Head > 0) {
+        ::munmap(Raw, Head);
+    }
+    if (Tail > 0) {
+        ::munmap(reinterpret_cast<void*>(Aligned + Bytes), Tail);
+    }
+
+    return reinterpret_cast<void*>(Aligned);
+}
+
+#endif
+
+} // namespace
+
+TableMemory allocateTableMemory(std::size_t Bytes, std::size_t Alignment,
+                                const solver::dfpn::MemoryOptions& Options) {
+    TableMemory Memory;
+    Memory.Bytes = Bytes;
+
+#ifdef __linux__
+    if (Options.HugePages ||
+        Options.Numa != solver::dfpn::NumaPolicy::Default) {
+        // Anonymous mappings are zero-filled, so no clearing pass is needed.
+        if (Options.HugePages) {
+            const std::size_t Length = roundUp(Bytes, HugePageSize);
+            void* Data =
+                ::mmap(nullptr, Length, PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+            if (Data != MAP_FAILED) {
+                Memory.Data = Data;
+                Memory.Reserved = Length;
+                Memory.Kind = PageKind::ExplicitHuge;
+                Memory.NumaPolicyApplied =
+                    applyNumaPolicy(Data, Length, Options);
+                return Memory;
+            }
+        }
+
+        // Page alignment is enough for any table entry.
+        const std::size_t Length =
+            Options.HugePages ? roundUp(Bytes, HugePageSize) : Bytes;
+        void* Data = Options.HugePages ? mapAligned(Length, HugePageSize)
+                                       : mapAnonymous(Length);
+        if (Data != nullptr) {
+            Memory.Data = Data;
+            Memory.Reserved = Length;
+            if (Options.HugePages &&
+                ::madvise(Data, Length, MADV_HUGEPAGE) == 0) {
+                Memory.Kind = PageKind::TransparentHuge;
+            }
+            Memory.NumaPolicyApplied = applyNumaPolicy(Data, Length, Options);
+            return Memory;
+        }
+    }
+#else
+    (void)Options;
+#endif
+
+    Memory.Data = ::operator new(Bytes, std::align_val_t(Alignment));
+    std::memset(Memory.Data, 0, Bytes);
+    Memory.Reserved = Bytes;
+    Memory.Alignment = Alignment;
+    return Memory;
+}
+
+void releaseTableMemory(TableMemory* Memory) {
+    if (Memory->Data == nullptr) {
+        return;
+    }
+
+    if (Memory->Alignment != 0) {
+        ::operator delete(Memory->Data, std::align_val_t(Memory->Alignment));
+    } else {
+#ifdef __linux__
+        ::munmap(Memory->Data, Memory->Reserved);
+#endif
+    }
+
+    *Memory = TableMemory();
+}
+
+void addToReport(solver::dfpn::MemoryReport* Report,
+                 const TableMemory& Memory) {
+    switch (Memory.Kind) {
+    case PageKind::ExplicitHuge:
+        Report->ExplicitHugePageBytes += Memory.Reserved;
+        break;
+    case PageKind::TransparentHuge:
+        Report->TransparentHugePageBytes += Memory.Reserved;
+        break;
+    case PageKind::Standard:
+        Report->StandardPageBytes += Memory.Reserved;
+        break;
+    }
+
+    if (Memory.NumaPolicyApplied) {
+        ++Report->NumaPolicyAppliedCount;
+    }
+}
+
+} // namespace internal
+} // namespace solver
+} // namespace nshogi
@@ -0,0 +1,97 @@
+//
+// Copyright (c) 2025-2026 @nyashiki
+//
+// This software is licensed under the MIT license.
+// For details, see the LICENSE file in the root of this repository.
+//
+// SPDX-License-Identifier: MIT
+//
+
+#include "../dfpn.h"
+
+#include <cstddef>
+#include <type_traits>
+
+#ifndef NSHOGI_SOLVER_INTERNAL_TABLEMEMORY_H
+#define NSHOGI_SOLVER_INTERNAL_TABLEMEMORY_H
+
+namespace nshogi {
+namespace solver {
+namespace internal {
+
+enum class PageKind {
+    Standard,
+    TransparentHuge,
+    ExplicitHuge,
+};
+
+// A zero-initialized memory block for a large table.
+struct TableMemory {
+    void* Data = nullptr;
+    std::size_t Bytes = 0;     // The requested size.
+    std::size_t Reserved = 0;  // The size actually reserved.
+    std::size_t Alignment = 0; // Non-zero iff allocated by operator new.
+    PageKind Kind = PageKind::Standard;
+    bool NumaPolicyApplied = false;
+};
+
+TableMemory allocateTableMemory(std::size_t Bytes, std::size_t Alignment,
+                                const solver::dfpn::MemoryOptions& Options);
+void releaseTableMemory(TableMemory* Memory);
+
+void addToReport(solver::dfpn::MemoryReport* Report,
+                 const TableMemory& Memory);
+
+// An owning array of trivially copyable table entries whose memory is
+// obtained by `allocateTableMemory()`.
+template <typename T>
+class TableArray {
+ public:
+    static_assert(std::is_trivially_copyable_v<T>);
+    static_assert(std::is_trivially_destructible_v<T>);
+
+    TableArray()
+        : Data(nullptr) {
+    }
+
+    ~TableArray() {
+        releaseTableMemory(&Memory);
+    }
+
+    TableArray(const TableArray&) = delete;
+    TableArray& operator=(const TableArray&) = delete;
+
+    void allocate(std::size_t Size,
+                  const solver::dfpn::MemoryOptions& Options) {
+        releaseTableMemory(&Memory);
+        Memory = allocateTableMemory(Size * sizeof(T), alignof(T), Options);
+        Data = static_cast<T*>(Memory.Data);
+    }
+
+    void release() {
+        releaseTableMemory(&Memory);
+        Data = nullptr;
+    }
+
+    T& operator[](std::size_t Index) const {
+        return Data[Index];
+    }
+
+    T* get() const {
+        return Data;
+    }
+
+    const TableMemory& memory() const {
+        return Memory;
+    }
+
+ private:
+    T* Data;
+    TableMemory Memory;
+};
+
+} // namespace internal
+} // namespace solver
+} // namespace nshogi
+
+#endif // #ifndef NSHOGI_SOLVER_INTERNAL_TABLEMEMORY_H
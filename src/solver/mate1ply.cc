@@ -13,8 +13,40 @@
 #include "../core/internal/stateimpl.h"
 #include "internal/mate1ply.h"
 
+#include <algorithm>
+#include <thread>
+#include <vector>
+
 namespace nshogi {
 
+namespace {
+
+void solveRange(std::span<const core::State> States, core::Move32* Out) {
+    // A state is reached through its pointer and its current step through
+    // a pointer of the state, so the two are prefetched in two stages.
+    constexpr std::size_t PrefetchDistance = 4;
+
+    const auto Impl = [&](std::size_t I) {
+        return core::internal::ImmutableStateAdapter(States[I]).get();
+    };
+
+    for (std::size_t I = 0; I < States.size(); ++I) {
+        if (I + 2 * PrefetchDistance < States.size()) {
+            Impl(I + 2 * PrefetchDistance)->prefetch();
+        }
+        if (I + PrefetchDistance < States.size()) {
+            Impl(I + PrefetchDistance)->prefetchCurrentStep();
+        }
+
+        const core::internal::StateImpl* S = Impl(I);
+        Out[I] = S->getSideToMove() == core::Black
+                     ? solver::internal::mate1ply::solve<core::Black>(*S)
+                     : solver::internal::mate1ply::solve<core::White>(*S);
+    }
+}
+
+} // namespace
+
 template <core::Color C>
 core::Move32 solver::mate1ply::solve(const core::State& S) {
     core::internal::ImmutableStateAdapter Adapter(S);
@@ -31,6 +63,32 @@ core::Move32 solver::mate1ply::solve(const core::State& S) {
     }
 }
 
+void solver::mate1ply::solveBatch(std::span<const core::State> States,
+                                  core::Move32* Out, std::size_t NumThreads) {
+    // No thread is left without a position.
+    NumThreads = std::clamp<std::size_t>(
+        NumThreads, 1, std::max<std::size_t>(States.size(), 1));
+
+    const auto Range = [&](std::size_t I) {
+        return States.size() * I / NumThreads;
+    };
+
+    std::vector<std::thread> Threads;
+    Threads.reserve(NumThreads - 1);
+    for (std::size_t I = 1; I < NumThreads; ++I) {
+        Threads.emplace_back([&, I]() {
+            solveRange(States.subspan(Range(I), Range(I + 1) - Range(I)),
+                       Out + Range(I));
+        });
+    }
+
+    solveRange(States.subspan(0, Range(1)), Out);
+
+    for (auto& Thread : Threads) {
+        Thread.join();
+    }
+}
+
 template core::Move32
 solver::mate1ply::solve<core::Color::Black>(const core::State&);
 template core::Move32
@@ -13,6 +13,9 @@
 #include "../core/state.h"
 #include "../core/types.h"
 
+#include <cstddef>
+#include <span>
+
 namespace nshogi {
 namespace solver {
 namespace mate1ply {
@@ -24,6 +27,21 @@ core::Move32 solve(const core::State& S);
 /// within one ply. Otherwise, returns an one-ply-checkmate move.
 core::Move32 solve(const core::State& S);
 
+///
+/// @brief Solve many positions at once.
+///
+/// The positions are split into `NumThreads` contiguous ranges. Each thread
+/// prefetches the states a few positions ahead of the one it is solving,
+/// so that the cache misses of a large set overlap with the search.
+///
+/// @param States The positions to solve.
+/// @param Out Receives the result of each position in the input order. Must
+///        have room for `States.size()` moves.
+/// @param NumThreads The number of threads, including the calling thread.
+///
+void solveBatch(std::span<const core::State> States, core::Move32* Out,
+                std::size_t NumThreads = 1);
+
 } // namespace mate1ply
 } // namespace solver
 } // namespace nshogi
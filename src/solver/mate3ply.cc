@@ -0,0 +1,42 @@
+//
+// Copyright (c) 2025-2026 @nyashiki
+//
+// This software is licensed under the MIT license.
+// For details, see the LICENSE file in the root of this repository.
+//
+// SPDX-License-Identifier: MIT
+//
+
+#include "mate3ply.h"
+#include "../core/internal/stateadapter.h"
+#include "../core/internal/stateimpl.h"
+#include "internal/mate3ply.h"
+
+namespace nshogi {
+
+namespace {
+
+template <int Plies>
+core::Move32 solveWithin(core::State* S) {
+    core::internal::MutableStateAdapter Adapter(*S);
+
+    if (S->getSideToMove() == core::Black) {
+        return solver::internal::mate3ply::solve<core::Black, Plies>(
+            Adapter.get());
+    } else {
+        return solver::internal::mate3ply::solve<core::White, Plies>(
+            Adapter.get());
+    }
+}
+
+} // namespace
+
+core::Move32 solver::mate3ply::solve(core::State* S) {
+    return solveWithin<3>(S);
+}
+
+core::Move32 solver::mate5ply::solve(core::State* S) {
+    return solveWithin<5>(S);
+}
+
+} // namespace nshogi
@@ -0,0 +1,51 @@
+//
+// Copyright (c) 2025-2026 @nyashiki
+//
+// This software is licensed under the MIT license.
+// For details, see the LICENSE file in the root of this repository.
+//
+// SPDX-License-Identifier: MIT
+//
+
+#ifndef NSHOGI_SOLVER_MATE3PLY_H
+#define NSHOGI_SOLVER_MATE3PLY_H
+
+#include "../core/state.h"
+#include "../core/types.h"
+
+namespace nshogi {
+namespace solver {
+namespace mate3ply {
+
+///
+/// @brief Find a mate within three plies without any table or allocation.
+///
+/// Every check and every evasion is tried, with `mate1ply::solve()` as a
+/// shortcut at each attacker node, so the result is exact for mates of up
+/// to three plies. Only non-promoting moves of pieces that would gain by
+/// promoting are skipped. `S` is modified during the search and restored
+/// on return.
+///
+/// @return A mating move, or `Move32::MoveNone()`.
+///
+core::Move32 solve(core::State* S);
+
+} // namespace mate3ply
+
+namespace mate5ply {
+
+///
+/// @brief Find a mate within five plies in the same way as
+/// `mate3ply::solve()`.
+///
+/// As `dfs::solve()` does, the attacker's non-promoting moves are tried as
+/// well while it holds a pawn and more than three plies are left, since a
+/// promoted piece may turn a later pawn drop into utifu-dume.
+///
+core::Move32 solve(core::State* S);
+
+} // namespace mate5ply
+} // namespace solver
+} // namespace nshogi
+
+#endif // #ifndef NSHOGI_SOLVER_MATE3PLY_H
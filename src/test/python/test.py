@@ -232,6 +232,24 @@ class TestSolver(unittest.TestCase):
                 checkmate_move = solver.solve(s, with_pv=True)
                 self.assertTrue(len(checkmate_move) > 0)
 
+    def test_batched_dfpn_mate7ply(self):
+        with open("res/test/mate-7-ply.txt", "r") as f:
+            sfens = [line.strip() for line in f]
+
+        solver = nshogi.solver.BatchedDfPn(16, num_workers=2)
+        max_node_counts = [100000] * len(sfens)
+
+        checkmate_moves = solver.solve_sfens(sfens, max_node_counts)
+        self.assertEqual(len(sfens), len(checkmate_moves))
+        for checkmate_move in checkmate_moves:
+            self.assertFalse(checkmate_move.is_none())
+
+        states = [nshogi.io.sfen.make_state_from_sfen(sfen) for sfen in sfens]
+        pvs = solver.solve(states, max_node_counts, with_pv=True)
+        self.assertEqual(len(sfens), len(pvs))
+        for pv in pvs:
+            self.assertTrue(len(pv) > 0)
+
 class TestML(unittest.TestCase):
     def setUp(self):
         self.sfens = []
@@ -15,8 +15,11 @@
 #include "common.h"
 
 #include <cstring>
+#include <filesystem>
 #include <fstream>
 #include <random>
+#include <string>
+#include <vector>
 
 TEST(CAPI, FeatureType) {
     using namespace nshogi::ml;
@@ -729,6 +732,155 @@ TEST(CAPI, DfPn) {
     nshogiApi()->solverApi()->destroyDfPnSolver(Solver);
 }
 
+TEST(CAPI, ParallelDfPn) {
+    std::ifstream Ifs("./res/test/mate-9-ply.txt");
+
+    nshogi_solver_dfpn_t* Solver =
+        nshogiApi()->solverApi()->createParallelDfPnSolver(64, 2);
+    std::string Line;
+    while (std::getline(Ifs, Line)) {
+        nshogi_state_t* State =
+            nshogiApi()->ioApi()->createStateFromSfen(Line.c_str());
+
+        nshogi_move_t CheckmateMove =
+            nshogiApi()->solverApi()->solveByDfPn(State, Solver, 0, 0, 0);
+
+        TEST_ASSERT_FALSE(nshogiApi()->moveApi()->isNone(CheckmateMove));
+        nshogiApi()->stateApi()->destroyState(State);
+    }
+    nshogiApi()->solverApi()->destroyDfPnSolver(Solver);
+
+    TEST_ASSERT_TRUE(
+        nshogiApi()->solverApi()->createParallelDfPnSolver(64, 0) == nullptr);
+    TEST_ASSERT_TRUE(
+        nshogiApi()->solverApi()->createParallelDfPnSolver(64, -1) == nullptr);
+}
+
+TEST(CAPI, BatchedDfPn) {
+    std::ifstream Ifs("./res/test/mate-9-ply.txt");
+
+    std::vector<std::string> Lines;
+    std::string Line;
+    while (std::getline(Ifs, Line)) {
+        Lines.push_back(Line);
+    }
+
+    std::vector<const char*> Sfens;
+    std::vector<nshogi_state_t*> States;
+    for (const auto& L : Lines) {
+        Sfens.push_back(L.c_str());
+        States.push_back(nshogiApi()->ioApi()->createStateFromSfen(L.c_str()));
+    }
+    const std::vector<uint64_t> MaxNodeCounts(Lines.size(), 100000);
+    std::vector<nshogi_move_t> Results(Lines.size());
+
+    nshogi_solver_batched_dfpn_t* Solver =
+        nshogiApi()->solverApi()->createBatchedDfPnSolver(16, 2);
+
+    TEST_ASSERT_EQ(nshogiApi()->solverApi()->solveSfenBatchByDfPn(
+                       Solver, Sfens.data(), MaxNodeCounts.data(),
+                       (int)Sfens.size(), 0, 0, Results.data()),
+                   0);
+    for (const auto CheckmateMove : Results) {
+        TEST_ASSERT_FALSE(nshogiApi()->moveApi()->isNone(CheckmateMove));
+    }
+
+    TEST_ASSERT_EQ(nshogiApi()->solverApi()->solveBatchByDfPn(
+                       Solver, States.data(), MaxNodeCounts.data(),
+                       (int)States.size(), 0, 0, Results.data()),
+                   0);
+    for (const auto CheckmateMove : Results) {
+        TEST_ASSERT_FALSE(nshogiApi()->moveApi()->isNone(CheckmateMove));
+    }
+
+    // Errors are reported, not thrown across the C ABI.
+    const char* InvalidSfens[] = {"4k4/9/9/9/9/9/9/9/4K4 b G 1", "invalid"};
+    TEST_ASSERT_EQ(nshogiApi()->solverApi()->solveSfenBatchByDfPn(
+                       Solver, InvalidSfens, MaxNodeCounts.data(), 2, 0, 0,
+                       Results.data()),
+                   -1);
+    TEST_ASSERT_EQ(nshogiApi()->solverApi()->solveSfenBatchByDfPn(
+                       Solver, Sfens.data(), MaxNodeCounts.data(), -1, 0, 0,
+                       Results.data()),
+                   -1);
+    TEST_ASSERT_EQ(nshogiApi()->solverApi()->solveBatchByDfPn(
+                       Solver, States.data(), MaxNodeCounts.data(), -1, 0, 0,
+                       Results.data()),
+                   -1);
+    TEST_ASSERT_TRUE(
+        nshogiApi()->solverApi()->createBatchedDfPnSolver(16, 0) == nullptr);
+
+    for (auto* State : States) {
+        nshogiApi()->stateApi()->destroyState(State);
+    }
+    nshogiApi()->solverApi()->destroyBatchedDfPnSolver(Solver);
+}
+
+TEST(CAPI, SaveAndLoadDfPnTT) {
+    const std::string Path = std::filesystem::temp_directory_path().string() +
+                             "/capi_dfpn_tt_test.bin";
+
+    nshogi_state_t* State = nshogiApi()->ioApi()->createStateFromSfen(
+        "4k4/9/4G4/9/9/9/9/9/4K4 b G 1");
+
+    nshogi_solver_dfpn_t* Solver =
+        nshogiApi()->solverApi()->createDfPnSolver(16);
+    nshogiApi()->solverApi()->solveByDfPn(State, Solver, 0, 0, 0);
+    TEST_ASSERT_TRUE(
+        nshogiApi()->solverApi()->saveDfPnTT(Solver, Path.c_str()) > 0);
+    nshogiApi()->solverApi()->destroyDfPnSolver(Solver);
+
+    Solver = nshogiApi()->solverApi()->createDfPnSolver(16);
+    TEST_ASSERT_TRUE(
+        nshogiApi()->solverApi()->loadDfPnTT(Solver, Path.c_str()) > 0);
+    nshogi_move_t CheckmateMove =
+        nshogiApi()->solverApi()->solveByDfPn(State, Solver, 0, 0, 0);
+    TEST_ASSERT_FALSE(nshogiApi()->moveApi()->isNone(CheckmateMove));
+    nshogiApi()->solverApi()->destroyDfPnSolver(Solver);
+
+    // A missing file is reported, not thrown.
+    Solver = nshogiApi()->solverApi()->createDfPnSolver(16);
+    TEST_ASSERT_EQ(nshogiApi()->solverApi()->loadDfPnTT(
+                       Solver, (Path + ".missing").c_str()),
+                   (int64_t)-1);
+    nshogiApi()->solverApi()->destroyDfPnSolver(Solver);
+
+    nshogiApi()->stateApi()->destroyState(State);
+    std::filesystem::remove(Path);
+}
+
+namespace {
+
+void countDfPnProgress(const nshogi_solver_dfpn_progress_t* Progress,
+                       void* UserData) {
+    uint64_t* LastNodeCount = static_cast<uint64_t*>(UserData);
+    *LastNodeCount = Progress->node_count;
+}
+
+} // namespace
+
+TEST(CAPI, DfPnTimeLimitAndProgress) {
+    nshogi_state_t* State = nshogiApi()->ioApi()->createStateFromSfen(
+        "4k4/9/9/9/9/9/9/9/4K4 b RB 1");
+
+    nshogi_solver_dfpn_t* Solver =
+        nshogiApi()->solverApi()->createDfPnSolver(16);
+    uint64_t LastNodeCount = 0;
+    nshogiApi()->solverApi()->setDfPnTimeLimit(Solver, 50);
+    nshogiApi()->solverApi()->setDfPnProgressCallback(
+        Solver, countDfPnProgress, &LastNodeCount, 10);
+
+    nshogi_move_t CheckmateMove =
+        nshogiApi()->solverApi()->solveByDfPn(State, Solver, 0, 0, 0);
+    TEST_ASSERT_TRUE(nshogiApi()->moveApi()->isNone(CheckmateMove));
+    TEST_ASSERT_TRUE(LastNodeCount > 0);
+
+    nshogiApi()->solverApi()->setDfPnProgressCallback(Solver, nullptr, nullptr,
+                                                      0);
+    nshogiApi()->solverApi()->destroyDfPnSolver(Solver);
+    nshogiApi()->stateApi()->destroyState(State);
+}
+
 TEST(CAPI, MLFeatureVector) {
     float* Dest = static_cast<float*>(malloc(4 * 9 * 9 * sizeof(float)));
 
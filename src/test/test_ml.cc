@@ -1718,6 +1718,44 @@ TEST(ML, SimpleTeacherState) {
     }
 }
 
+TEST(ML, SimpleTeacherStateWithArena) {
+    const int N = 100;
+    std::mt19937_64 mt(20260302);
+
+    nshogi::ml::SimpleTeacher SimpleTeacher;
+    nshogi::core::StateArena Arena;
+
+    for (int I = 0; I < N; ++I) {
+        nshogi::core::State State =
+            nshogi::core::StateBuilder::getInitialState();
+
+        for (uint16_t Ply = 0; Ply < 1024; ++Ply) {
+            const auto Moves =
+                nshogi::core::MoveGenerator::generateLegalMoves(State);
+
+            if (Moves.size() == 0) {
+                break;
+            }
+
+            SimpleTeacher.setState(State);
+            {
+                const nshogi::core::State Loaded =
+                    SimpleTeacher.getState(Arena);
+                TEST_ASSERT_TRUE(
+                    State.getPosition().equals(Loaded.getPosition(), true));
+                TEST_ASSERT_EQ(State.getPly(), Loaded.getPly());
+                TEST_ASSERT_EQ(Loaded.getPly(false), 0);
+                TEST_ASSERT_EQ(State.getHash(), Loaded.getHash());
+                TEST_ASSERT_EQ(State.isInCheck(), Loaded.isInCheck());
+            }
+            TEST_ASSERT_EQ(Arena.size(), (std::size_t)1);
+
+            const auto RandomMove = Moves[mt() % Moves.size()];
+            State.doMove(RandomMove);
+        }
+    }
+}
+
 TEST(ML, SimpleTeacherConfig) {
     nshogi::ml::SimpleTeacher SimpleTeacher;
 
@@ -22,6 +22,7 @@
 #include "../core/extendedstate.h"
 #include "../core/internal/bitboard.h"
 #include "../core/movegenerator.h"
+#include "../core/movepicker.h"
 #include "../core/state.h"
 #include "../io/sfen.h"
 
@@ -243,6 +244,173 @@ TEST(MoveGeneration, CaptureMoves) {
     }
 }
 
+TEST(MoveGeneration, PseudoLegalMoves) {
+    const int N = 1000;
+    std::mt19937_64 mt(20261018);
+
+    for (int I = 0; I < N; ++I) {
+        nshogi::core::State State =
+            nshogi::core::StateBuilder::getInitialState();
+
+        for (uint16_t Ply = 0; Ply < 512; ++Ply) {
+            const auto Moves =
+                nshogi::core::MoveGenerator::generateLegalMoves<false>(State);
+
+            if (Moves.size() == 0) {
+                break;
+            }
+
+            const auto PseudoLegalMoves =
+                nshogi::core::MoveGenerator::generatePseudoLegalMoves<false>(
+                    State);
+
+            // The legal moves are exactly the pseudo-legal moves that pass
+            // `isPseudoLegalMoveLegal()`.
+            std::size_t NumLegal = 0;
+            for (const auto& Move : PseudoLegalMoves) {
+                const bool IsLegal = State.isPseudoLegalMoveLegal(Move);
+                TEST_ASSERT_EQ(IsLegal, State.isLegal(Move));
+                TEST_ASSERT_EQ(IsLegal, Moves.find(Move) != Moves.end());
+                NumLegal += IsLegal;
+            }
+            TEST_ASSERT_EQ(NumLegal, Moves.size());
+
+            const auto RandomMove = Moves[mt() % Moves.size()];
+            State.doMove(RandomMove);
+        }
+    }
+}
+
+TEST(MoveGeneration, QuiescenceMoves) {
+    const int N = 300;
+    std::mt19937_64 mt(20261020);
+
+    const auto ToSet = [](const nshogi::core::MoveList& Moves) {
+        return std::set<nshogi::core::Move32>(Moves.begin(), Moves.end());
+    };
+
+    for (int I = 0; I < N; ++I) {
+        nshogi::core::State State =
+            nshogi::core::StateBuilder::getInitialState();
+
+        for (uint16_t Ply = 0; Ply < 512; ++Ply) {
+            const auto Moves =
+                nshogi::core::MoveGenerator::generateLegalMoves<false>(State);
+
+            if (Moves.size() == 0) {
+                break;
+            }
+
+            const nshogi::core::Square Sq =
+                (Ply > 0 && mt() % 2 == 0)
+                    ? State.getLastMove().to()
+                    : (nshogi::core::Square)(mt() % nshogi::core::NumSquares);
+
+            std::set<nshogi::core::Move32> QuietChecks;
+            std::set<nshogi::core::Move32> CapturesOn;
+            std::set<nshogi::core::Move32> QuietPromotions;
+            for (const auto& Move : Moves) {
+                const bool Capture =
+                    Move.capturePieceType() != nshogi::core::PTK_Empty;
+
+                State.doMove(Move);
+                const bool Check = State.isInCheck();
+                State.undoMove();
+
+                if (Check && !Capture) {
+                    QuietChecks.insert(Move);
+                }
+                if (Capture && Move.to() == Sq) {
+                    CapturesOn.insert(Move);
+                }
+                if (Move.promote() && !Capture) {
+                    QuietPromotions.insert(Move);
+                }
+            }
+
+            const auto QuietCheckMoves =
+                nshogi::core::MoveGenerator::generateLegalQuietCheckMoves<
+                    false>(State);
+            const auto CaptureMovesOn =
+                nshogi::core::MoveGenerator::generateLegalCaptureMovesOn<false>(
+                    State, Sq);
+            const auto QuietPromotionMoves =
+                nshogi::core::MoveGenerator::generateLegalQuietPromotionMoves(
+                    State);
+
+            TEST_ASSERT_EQ(QuietCheckMoves.size(), QuietChecks.size());
+            TEST_ASSERT_TRUE(ToSet(QuietCheckMoves) == QuietChecks);
+            TEST_ASSERT_EQ(CaptureMovesOn.size(), CapturesOn.size());
+            TEST_ASSERT_TRUE(ToSet(CaptureMovesOn) == CapturesOn);
+            TEST_ASSERT_EQ(QuietPromotionMoves.size(), QuietPromotions.size());
+            TEST_ASSERT_TRUE(ToSet(QuietPromotionMoves) == QuietPromotions);
+
+            const auto RandomMove = Moves[mt() % Moves.size()];
+            State.doMove(RandomMove);
+        }
+    }
+}
+
+TEST(MoveGeneration, MovePickerYieldsLegalMovesInStages) {
+    const int N = 300;
+    std::mt19937_64 mt(20261019);
+
+    for (int I = 0; I < N; ++I) {
+        nshogi::core::State State =
+            nshogi::core::StateBuilder::getInitialState();
+        nshogi::core::Move32 PreviousMove = nshogi::core::Move32::MoveNone();
+
+        for (uint16_t Ply = 0; Ply < 512; ++Ply) {
+            const auto Moves =
+                nshogi::core::MoveGenerator::generateLegalMoves<false>(State);
+
+            if (Moves.size() == 0) {
+                break;
+            }
+
+            // The hash move and the killers may be illegal here.
+            const nshogi::core::Move32 HashMove =
+                (mt() % 2 == 0) ? Moves[mt() % Moves.size()] : PreviousMove;
+            const nshogi::core::Move32 Killer1 = Moves[mt() % Moves.size()];
+            const nshogi::core::Move32 Killer2 =
+                (mt() % 2 == 0) ? Moves[mt() % Moves.size()] : PreviousMove;
+
+            nshogi::core::MovePicker<false> Picker(State, HashMove, Killer1,
+                                                   Killer2);
+            std::set<nshogi::core::Move32> Picked;
+            // 0: captures, 1: other board moves, 2: drops.
+            int LastKind = 0;
+            for (std::size_t J = 0;; ++J) {
+                const nshogi::core::Move32 Move = Picker.next();
+                if (Move.isNone()) {
+                    break;
+                }
+
+                TEST_ASSERT_TRUE(Moves.find(Move) != Moves.end());
+                TEST_ASSERT_TRUE(Picked.insert(Move).second);
+
+                if (J == 0 && State.isLegal(HashMove)) {
+                    TEST_ASSERT_TRUE(Move == HashMove);
+                }
+                if (!State.isInCheck() && Move != HashMove &&
+                    Move != Killer1 && Move != Killer2) {
+                    const int Kind =
+                        Move.drop() ? 2
+                        : (Move.capturePieceType() != nshogi::core::PTK_Empty)
+                            ? 0
+                            : 1;
+                    TEST_ASSERT_TRUE(Kind >= LastKind);
+                    LastKind = Kind;
+                }
+            }
+            TEST_ASSERT_EQ(Picked.size(), Moves.size());
+
+            PreviousMove = Moves[mt() % Moves.size()];
+            State.doMove(PreviousMove);
+        }
+    }
+}
+
 TEST(MoveGeneration, SameAfterDoAndUndo) {
     const int N = 100;
     std::mt19937_64 mt(20260428);
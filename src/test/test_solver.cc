@@ -9,14 +9,27 @@
 
 #include "common.h"
 
+#include "../core/movegenerator.h"
+#include "../core/internal/stateadapter.h"
 #include "../core/positionbuilder.h"
 #include "../core/statebuilder.h"
 #include "../io/sfen.h"
 #include "../solver/dfpn.h"
 #include "../solver/dfs.h"
+#include "../solver/internal/dfpn.h"
 #include "../solver/mate1ply.h"
+#include "../solver/mate3ply.h"
 
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
 #include <fstream>
+#include <future>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
 
 TEST(Mate1Ply, Handmade1) {
     nshogi::core::State State = nshogi::io::sfen::StateBuilder::newState(
@@ -263,6 +276,28 @@ TEST(Mate1Ply, NoMatesColorTemplate) {
     }
 }
 
+TEST(Mate1Ply, Batch) {
+    std::vector<nshogi::core::State> States;
+    for (const char* Name : {"mate-1-ply", "no-mate-1-ply"}) {
+        std::ifstream Ifs(std::string("./res/test/") + Name + ".txt");
+
+        std::string Line;
+        while (std::getline(Ifs, Line)) {
+            States.push_back(nshogi::io::sfen::StateBuilder::newState(Line));
+        }
+    }
+
+    for (const std::size_t NumThreads : {std::size_t(1), std::size_t(3)}) {
+        std::vector<nshogi::core::Move32> Out(States.size());
+        nshogi::solver::mate1ply::solveBatch(States, Out.data(), NumThreads);
+
+        for (std::size_t I = 0; I < States.size(); ++I) {
+            TEST_ASSERT_TRUE(Out[I] ==
+                             nshogi::solver::mate1ply::solve(States[I]));
+        }
+    }
+}
+
 TEST(Mate3Ply, Problems) {
     std::ifstream Ifs("./res/test/mate-3-ply.txt");
 
@@ -299,6 +334,139 @@ TEST(Mate7Ply, Problems) {
     }
 }
 
+TEST(Mate3Ply, Solver) {
+    for (const char* Name : {"mate-1-ply", "mate-3-ply"}) {
+        std::ifstream Ifs(std::string("./res/test/") + Name + ".txt");
+
+        std::string Line;
+        while (std::getline(Ifs, Line)) {
+            auto State = nshogi::io::sfen::StateBuilder::newState(Line);
+            const uint64_t Hash = State.getHash();
+            const auto CheckmateMove = nshogi::solver::mate3ply::solve(&State);
+
+            TEST_ASSERT_FALSE(CheckmateMove.isNone());
+            TEST_ASSERT_EQ(State.getHash(), Hash);
+        }
+    }
+}
+
+TEST(Mate5Ply, Solver) {
+    std::ifstream Ifs("./res/test/mate-5-ply.txt");
+
+    std::string Line;
+    while (std::getline(Ifs, Line)) {
+        auto State = nshogi::io::sfen::StateBuilder::newState(Line);
+        const uint64_t Hash = State.getHash();
+        const auto CheckmateMove = nshogi::solver::mate5ply::solve(&State);
+
+        TEST_ASSERT_FALSE(CheckmateMove.isNone());
+
+        State.doMove(CheckmateMove);
+        const auto Evasions =
+            nshogi::core::MoveGenerator::generateLegalMoves(State);
+        for (const auto Evasion : Evasions) {
+            State.doMove(Evasion);
+            TEST_ASSERT_FALSE(nshogi::solver::dfs::solve(&State, 3).isNone());
+            State.undoMove();
+        }
+        State.undoMove();
+
+        TEST_ASSERT_EQ(State.getHash(), Hash);
+    }
+}
+
+TEST(Mate5Ply, NonPromotion) {
+    // Promoting the rook would leave the last pawn drop as utifu-dume.
+    const std::pair<const char*, const char*> Problems[] = {
+        {"3+B5/k8/8r/6s2/G1R6/9/9/9/7K1 b P 1", "7e7b"},
+        {"5rR2/8k/8B/1b3+R3/9/9/9/9/3K5 b 2P 1", "3a3b"},
+    };
+
+    for (const auto& [Sfen, Expected] : Problems) {
+        auto State = nshogi::io::sfen::StateBuilder::newState(Sfen);
+        const auto CheckmateMove = nshogi::solver::mate5ply::solve(&State);
+
+        TEST_ASSERT_EQ(nshogi::io::sfen::move32ToSfen(CheckmateMove),
+                       std::string(Expected));
+    }
+}
+
+TEST(Mate5Ply, NoMate) {
+    const char* Sfens[] = {
+        // The first problem above without the pawn.
+        "3+B5/k8/8r/6s2/G1R6/9/9/9/7K1 b - 1",
+        // The only mates are by dropping a pawn (utifu-dume).
+        "k8/2+R6/9/9/9/9/9/9/3K5 b P 1",
+        "8k/9/7+R1/N8/9/9/9/9/8K b P 1",
+    };
+
+    for (const char* Sfen : Sfens) {
+        auto State = nshogi::io::sfen::StateBuilder::newState(Sfen);
+
+        TEST_ASSERT_TRUE(nshogi::solver::mate3ply::solve(&State).isNone());
+        TEST_ASSERT_TRUE(nshogi::solver::mate5ply::solve(&State).isNone());
+    }
+}
+
+TEST(Dfs, ReusedSolverShortestMate) {
+    nshogi::solver::dfs::Solver Solver;
+
+    std::ifstream Ifs("./res/test/mate-3-ply.txt");
+    std::string Line;
+    while (std::getline(Ifs, Line)) {
+        auto State = nshogi::io::sfen::StateBuilder::newState(Line);
+
+        // Iterative deepening stops at the shortest mate even when a
+        // longer one is allowed.
+        const auto Move = Solver.solve(&State, 9);
+        TEST_ASSERT_FALSE(Move.isNone());
+        const uint64_t NodeCount = Solver.searchedNodeCount();
+
+        State.doMove(Move);
+        const auto Evasions =
+            nshogi::core::MoveGenerator::generateLegalMoves(State);
+        for (const auto Evasion : Evasions) {
+            State.doMove(Evasion);
+            TEST_ASSERT_FALSE(nshogi::solver::dfs::solve(&State, 1).isNone());
+            State.undoMove();
+        }
+        State.undoMove();
+
+        // The table keeps the result for the next solve.
+        TEST_ASSERT_TRUE(Solver.solve(&State, 3) == Move);
+        TEST_ASSERT_TRUE(Solver.searchedNodeCount() <= NodeCount);
+    }
+}
+
+TEST(DfPn, Statistics) {
+    nshogi::solver::dfpn::Solver Solver(64);
+
+    std::ifstream Ifs("./res/test/mate-5-ply.txt");
+    std::string Line;
+    std::getline(Ifs, Line);
+    auto State = nshogi::io::sfen::StateBuilder::newState(Line);
+    TEST_ASSERT_FALSE(Solver.solve(&State, 100000).isNone());
+
+    const auto Stats = Solver.statistics();
+    TEST_ASSERT_EQ(Solver.threadStatistics().size(), (std::size_t)1);
+
+    if (!Stats.Enabled) {
+        TEST_ASSERT_EQ(Stats.AttackerNodes, (uint64_t)0);
+        TEST_ASSERT_EQ(Stats.NodeTT.Hits + Stats.NodeTT.Misses, (uint64_t)0);
+        return;
+    }
+
+    // A visit cut off by the tables is counted as a node but not expanded.
+    TEST_ASSERT_TRUE(Stats.AttackerNodes > 0);
+    TEST_ASSERT_TRUE(Stats.DefenderNodes > 0);
+    TEST_ASSERT_TRUE(Stats.AttackerNodes + Stats.DefenderNodes <=
+                     Solver.searchedNodeCount());
+    TEST_ASSERT_TRUE(Stats.attackerBranchingFactor() > 0.0);
+    TEST_ASSERT_TRUE(Stats.EdgeTT.Hits + Stats.EdgeTT.Misses > 0);
+    TEST_ASSERT_TRUE(Stats.MaxDepthReached >= 4);
+    TEST_ASSERT_TRUE(Stats.MoveGenerationNanoseconds > 0);
+}
+
 TEST(DfPn, Mate1Ply) {
     std::ifstream Ifs("./res/test/mate-1-ply.txt");
 
@@ -389,3 +557,550 @@ TEST(DfPn, Mate11Ply) {
         TEST_ASSERT_FALSE(CheckmateMove.isNone());
     }
 }
+
+TEST(DfPn, HeuristicsMate11Ply) {
+    std::ifstream Ifs("./res/test/mate-11-ply.txt");
+
+    nshogi::solver::dfpn::Solver Solver(64);
+    nshogi::solver::dfpn::Heuristics H;
+    H.InitialNumbers = true;
+    H.ThresholdEpsilon = 0.25;
+    Solver.setHeuristics(H);
+
+    std::string Line;
+    while (std::getline(Ifs, Line)) {
+        auto State = nshogi::io::sfen::StateBuilder::newState(Line);
+        auto PV = Solver.solveWithPV(&State, 1000000);
+
+        TEST_ASSERT_TRUE(PV.size() > 0);
+        TEST_ASSERT_EQ(PV.size() % 2, (std::size_t)1);
+    }
+
+    H.ThresholdEpsilon = -1.0;
+    bool Thrown = false;
+    try {
+        Solver.setHeuristics(H);
+    } catch (const std::invalid_argument&) {
+        Thrown = true;
+    }
+    TEST_ASSERT_TRUE(Thrown);
+}
+
+TEST(DfPn, HeuristicsMateIn1EvasionsLast) {
+    using nshogi::solver::internal::dfpn::DfPnValue;
+    using nshogi::solver::internal::dfpn::SolverImpl;
+
+    std::ifstream Ifs("./res/test/mate-3-ply.txt");
+
+    // Every evasion allowing a mate in one must be estimated harder to
+    // refute than every evasion that does not, whatever kind of move it is.
+    std::size_t NumCompared = 0;
+    std::string Line;
+    while (std::getline(Ifs, Line)) {
+        auto State = nshogi::io::sfen::StateBuilder::newState(Line);
+        const auto Checks =
+            nshogi::core::MoveGenerator::generateLegalCheckMoves(State);
+
+        for (const auto Check : Checks) {
+            State.doMove(Check);
+            const auto Evasions =
+                nshogi::core::MoveGenerator::generateLegalMoves(State);
+
+            uint32_t MinMate1Disproof = DfPnValue::Infinity;
+            uint32_t MaxOtherDisproof = 0;
+            nshogi::core::internal::MutableStateAdapter Adapter(State);
+            for (const auto Evasion : Evasions) {
+                const auto Value =
+                    (State.getSideToMove() == nshogi::core::Black)
+                        ? SolverImpl::estimateEvasionEdge<nshogi::core::Black,
+                                                          false>(Adapter.get(),
+                                                                 Evasion)
+                        : SolverImpl::estimateEvasionEdge<nshogi::core::White,
+                                                          false>(Adapter.get(),
+                                                                 Evasion);
+                if (Value.DisproofNumber == 0) {
+                    continue;
+                }
+
+                State.doMove(Evasion);
+                const bool IsMate1 =
+                    !nshogi::solver::mate1ply::solve(State).isNone();
+                State.undoMove();
+
+                if (IsMate1) {
+                    MinMate1Disproof =
+                        std::min(MinMate1Disproof, Value.DisproofNumber);
+                } else {
+                    MaxOtherDisproof =
+                        std::max(MaxOtherDisproof, Value.DisproofNumber);
+                }
+            }
+
+            if (MaxOtherDisproof > 0 &&
+                MinMate1Disproof < DfPnValue::Infinity) {
+                TEST_ASSERT_TRUE(MinMate1Disproof > MaxOtherDisproof);
+                ++NumCompared;
+            }
+            State.undoMove();
+        }
+    }
+    TEST_ASSERT_TRUE(NumCompared > 0);
+}
+
+TEST(DfPn, GarbageCollectionMate11Ply) {
+    std::ifstream Ifs("./res/test/mate-11-ply.txt");
+
+    // Collect whenever the table is checked, so that every problem is
+    // solved across many collections.
+    nshogi::solver::dfpn::Solver Solver(1);
+    nshogi::solver::dfpn::GarbageCollection GC;
+    GC.FillRateThreshold = 0.0;
+    GC.Ratio = 0.5;
+    Solver.setGarbageCollection(GC);
+
+    std::string Line;
+    while (std::getline(Ifs, Line)) {
+        auto State = nshogi::io::sfen::StateBuilder::newState(Line);
+        auto PV = Solver.solveWithPV(&State, 1000000);
+
+        TEST_ASSERT_TRUE(PV.size() > 0);
+        TEST_ASSERT_EQ(PV.size() % 2, (std::size_t)1);
+    }
+
+    for (const double Ratio : {0.0, 1.5}) {
+        GC.Ratio = Ratio;
+        bool Thrown = false;
+        try {
+            Solver.setGarbageCollection(GC);
+        } catch (const std::invalid_argument&) {
+            Thrown = true;
+        }
+        TEST_ASSERT_TRUE(Thrown);
+    }
+}
+
+TEST(DfPn, StandDominationHits) {
+    std::ifstream Ifs("./res/test/mate-9-ply.txt");
+
+    nshogi::solver::dfpn::Solver Solver(64);
+    uint64_t ExactHits = 0;
+    uint64_t DominatedHits = 0;
+    std::string Line;
+    while (std::getline(Ifs, Line)) {
+        auto State = nshogi::io::sfen::StateBuilder::newState(Line);
+        TEST_ASSERT_FALSE(Solver.solve(&State, 100000).isNone());
+        ExactHits += Solver.nodeTTHits().Exact;
+        DominatedHits += Solver.nodeTTHits().Dominated;
+    }
+
+    TEST_ASSERT_TRUE(ExactHits > 0);
+    TEST_ASSERT_TRUE(DominatedHits > 0);
+}
+
+TEST(DfPn, StandDominationAcrossSnapshots) {
+    const std::string Path = std::filesystem::temp_directory_path().string() +
+                             "/dfpn_domination_test.bin";
+
+    {
+        nshogi::solver::dfpn::Solver Solver(16);
+        auto State = nshogi::io::sfen::StateBuilder::newState(
+            "4k4/9/4G4/9/9/9/9/9/4K4 b G 1");
+        TEST_ASSERT_FALSE(Solver.solve(&State, 0).isNone());
+        Solver.saveTT(Path);
+    }
+
+    // The same board with more pieces in hand is proven by the snapshot.
+    nshogi::solver::dfpn::Solver Solver(16);
+    Solver.loadTT(Path);
+    auto State = nshogi::io::sfen::StateBuilder::newState(
+        "4k4/9/4G4/9/9/9/9/9/4K4 b GSP 1");
+    TEST_ASSERT_FALSE(Solver.solve(&State, 0).isNone());
+    TEST_ASSERT_EQ(Solver.nodeTTHits().Exact, (uint64_t)0);
+    TEST_ASSERT_TRUE(Solver.nodeTTHits().Dominated > 0);
+
+    std::filesystem::remove(Path);
+}
+
+TEST(DfPn, PerpetualCheckNoMate) {
+    // The rook can check forever, so the disproof rests on repetitions.
+    const char* Sfen = "8k/9/9/9/9/9/9/9/K8 b R 1";
+    nshogi::solver::dfpn::Solver Solver(64);
+
+    auto State = nshogi::io::sfen::StateBuilder::newState(Sfen);
+    TEST_ASSERT_TRUE(Solver.solve(&State, 200000).isNone());
+    // Solved rather than given up.
+    TEST_ASSERT_TRUE(Solver.searchedNodeCount() < 200000);
+    const uint64_t NodeCount = Solver.searchedNodeCount();
+
+    // The root repeats a position before it. Path-dependent disproofs must
+    // not leak into this search from the previous one, nor the other way.
+    auto RepeatedState = nshogi::io::sfen::StateBuilder::newState(
+        std::string(Sfen) + " moves 9i9h 1a1b 9h9i 1b1a");
+    TEST_ASSERT_TRUE(Solver.solve(&RepeatedState, 200000).isNone());
+    TEST_ASSERT_TRUE(Solver.searchedNodeCount() < 200000);
+
+    TEST_ASSERT_TRUE(Solver.solve(&State, 200000).isNone());
+    TEST_ASSERT_EQ(Solver.searchedNodeCount(), NodeCount);
+}
+
+TEST(DfPn, MateAfterRepeatedRoot) {
+    nshogi::solver::dfpn::Solver Solver(64);
+
+    auto State = nshogi::io::sfen::StateBuilder::newState(
+        "4k4/9/4G4/9/9/9/9/9/4K4 b G 1 moves 5i5h 5a4a 5h5i 4a5a");
+    const auto PV = Solver.solveWithPV(&State, 100000);
+    TEST_ASSERT_EQ(PV.size(), (std::size_t)1);
+}
+
+TEST(DfPn, ParallelMate7Ply) {
+    std::ifstream Ifs("./res/test/mate-7-ply.txt");
+
+    nshogi::solver::dfpn::Solver Solver(64, 4);
+    std::string Line;
+    while (std::getline(Ifs, Line)) {
+        auto State = nshogi::io::sfen::StateBuilder::newState(Line);
+        const std::string Sfen = nshogi::io::sfen::stateToSfen(State);
+        auto PV = Solver.solveWithPV(&State, 0);
+
+        TEST_ASSERT_TRUE(PV.size() > 0);
+        TEST_ASSERT_EQ(PV.size() % 2, (std::size_t)1);
+        // The root must be left untouched by the helper threads.
+        TEST_ASSERT_STREQ(nshogi::io::sfen::stateToSfen(State).c_str(),
+                          Sfen.c_str());
+    }
+}
+
+TEST(DfPn, ProofTreeRetentionPV) {
+    nshogi::solver::dfpn::Solver Solver(64);
+    Solver.setProofTreeRetention(16);
+
+    for (const char* Path :
+         {"./res/test/mate-7-ply.txt", "./res/test/mate-9-ply.txt"}) {
+        std::ifstream Ifs(Path);
+        std::string Line;
+        while (std::getline(Ifs, Line)) {
+            auto State = nshogi::io::sfen::StateBuilder::newState(Line);
+            const auto PV = Solver.solveWithPV(&State, 100000);
+
+            TEST_ASSERT_TRUE(PV.size() > 0);
+            TEST_ASSERT_EQ(PV.size() % 2, (std::size_t)1);
+
+            // The PV must be a legal line ending in checkmate.
+            for (const auto& Move : PV) {
+                const auto Moves =
+                    nshogi::core::MoveGenerator::generateLegalMoves(State);
+                bool IsLegal = false;
+                for (const auto& LegalMove : Moves) {
+                    IsLegal = IsLegal || (LegalMove == Move);
+                }
+                TEST_ASSERT_TRUE(IsLegal);
+                State.doMove(Move);
+            }
+            TEST_ASSERT_TRUE(State.isInCheck());
+            TEST_ASSERT_EQ(
+                nshogi::core::MoveGenerator::generateLegalMoves(State).size(),
+                (std::size_t)0);
+        }
+    }
+}
+
+TEST(DfPn, ParallelNoMate1Ply) {
+    std::ifstream Ifs("./res/test/no-mate-1-ply.txt");
+
+    nshogi::solver::dfpn::Solver Solver(64, 4);
+    std::string Line;
+    while (std::getline(Ifs, Line)) {
+        auto State = nshogi::io::sfen::StateBuilder::newState(Line);
+        auto PV = Solver.solveWithPV(&State, 100000);
+
+        TEST_ASSERT_TRUE(PV.size() == 0 || PV.size() > 1);
+    }
+}
+
+TEST(DfPn, BatchedMate7Ply) {
+    std::ifstream Ifs("./res/test/mate-7-ply.txt");
+
+    std::vector<std::string> Sfens;
+    std::string Line;
+    while (std::getline(Ifs, Line)) {
+        Sfens.push_back(Line);
+    }
+    const std::vector<uint64_t> MaxNodeCounts(Sfens.size(), 100000);
+
+    nshogi::solver::dfpn::BatchedSolver Solver(16, 2);
+    const auto CheckmateMoves = Solver.solve(Sfens, MaxNodeCounts);
+
+    TEST_ASSERT_EQ(CheckmateMoves.size(), Sfens.size());
+    for (const auto& CheckmateMove : CheckmateMoves) {
+        TEST_ASSERT_FALSE(CheckmateMove.isNone());
+    }
+
+    // The same solver is reused with states.
+    std::vector<nshogi::core::State> States;
+    std::vector<nshogi::core::State*> StatePointers;
+    States.reserve(Sfens.size());
+    for (const auto& Sfen : Sfens) {
+        States.push_back(nshogi::io::sfen::StateBuilder::newState(Sfen));
+        StatePointers.push_back(&States.back());
+    }
+
+    const auto PVs = Solver.solveWithPV(StatePointers, MaxNodeCounts);
+
+    TEST_ASSERT_EQ(PVs.size(), Sfens.size());
+    for (std::size_t I = 0; I < PVs.size(); ++I) {
+        TEST_ASSERT_EQ(PVs[I].size() % 2, (std::size_t)1);
+        TEST_ASSERT_STREQ(nshogi::io::sfen::stateToSfen(States[I]).c_str(),
+                          Sfens[I].c_str());
+    }
+}
+
+TEST(DfPn, BatchedMismatchedNodeCounts) {
+    nshogi::solver::dfpn::BatchedSolver Solver(16, 2);
+
+    const std::vector<std::string> Sfens = {
+        "4k4/9/4G4/9/9/9/9/9/4K4 b G 1",
+    };
+    const std::vector<uint64_t> MaxNodeCounts;
+
+    bool Thrown = false;
+    try {
+        Solver.solve(Sfens, MaxNodeCounts);
+    } catch (const std::invalid_argument&) {
+        Thrown = true;
+    }
+
+    TEST_ASSERT_TRUE(Thrown);
+}
+
+TEST(DfPn, DefaultMemoryReport) {
+    nshogi::solver::dfpn::Solver Solver(16);
+    const auto Report = Solver.memoryReport();
+
+    TEST_ASSERT_TRUE(Report.StandardPageBytes >= 16ULL * 1024ULL * 1024ULL -
+                                                     2 * 256ULL);
+    TEST_ASSERT_EQ(Report.ExplicitHugePageBytes, (std::size_t)0);
+    TEST_ASSERT_EQ(Report.TransparentHugePageBytes, (std::size_t)0);
+    TEST_ASSERT_EQ(Report.NumaPolicyAppliedCount, (std::size_t)0);
+}
+
+TEST(DfPn, HugePagesMate5Ply) {
+    nshogi::solver::dfpn::MemoryOptions Options;
+    Options.HugePages = true;
+    Options.Numa = nshogi::solver::dfpn::NumaPolicy::Interleave;
+
+    // Whichever mode is obtained, the whole table must be accounted for.
+    nshogi::solver::dfpn::Solver Solver(16, 1, Options);
+    const auto Report = Solver.memoryReport();
+    TEST_ASSERT_TRUE(Report.ExplicitHugePageBytes +
+                         Report.TransparentHugePageBytes +
+                         Report.StandardPageBytes >=
+                     16ULL * 1024ULL * 1024ULL - 2 * 256ULL);
+    TEST_ASSERT_TRUE(Report.NumaPolicyAppliedCount <= 2);
+
+    std::ifstream Ifs("./res/test/mate-5-ply.txt");
+    std::string Line;
+    while (std::getline(Ifs, Line)) {
+        auto State = nshogi::io::sfen::StateBuilder::newState(Line);
+        auto CheckmateMove = Solver.solve(&State, 100000);
+
+        TEST_ASSERT_FALSE(CheckmateMove.isNone());
+    }
+}
+
+TEST(DfPn, SaveAndLoadTT) {
+    const std::string Path = std::filesystem::temp_directory_path().string() +
+                             "/dfpn_tt_test.bin";
+
+    std::vector<std::string> Sfens;
+    {
+        std::ifstream Ifs("./res/test/mate-9-ply.txt");
+        std::string Line;
+        while (std::getline(Ifs, Line) && Sfens.size() < 100) {
+            Sfens.push_back(Line);
+        }
+    }
+
+    uint64_t ColdNodeCount = 0;
+    {
+        nshogi::solver::dfpn::Solver Solver(16);
+        for (const auto& Sfen : Sfens) {
+            auto State = nshogi::io::sfen::StateBuilder::newState(Sfen);
+            TEST_ASSERT_FALSE(Solver.solve(&State, 100000).isNone());
+            ColdNodeCount += Solver.searchedNodeCount();
+        }
+        TEST_ASSERT_TRUE(Solver.saveTT(Path) > 0);
+    }
+
+    uint64_t WarmNodeCount = 0;
+    {
+        nshogi::solver::dfpn::Solver Solver(16);
+        TEST_ASSERT_TRUE(Solver.loadTT(Path) > 0);
+        for (const auto& Sfen : Sfens) {
+            auto State = nshogi::io::sfen::StateBuilder::newState(Sfen);
+            TEST_ASSERT_FALSE(Solver.solve(&State, 100000).isNone());
+            WarmNodeCount += Solver.searchedNodeCount();
+        }
+    }
+
+    TEST_ASSERT_TRUE(WarmNodeCount < ColdNodeCount);
+
+    // A snapshot fits only a table of the same size.
+    {
+        nshogi::solver::dfpn::Solver Solver(32);
+        bool Thrown = false;
+        try {
+            Solver.loadTT(Path);
+        } catch (const std::runtime_error&) {
+            Thrown = true;
+        }
+        TEST_ASSERT_TRUE(Thrown);
+    }
+
+    // A missing file is reported with its path, as a failed save is.
+    {
+        nshogi::solver::dfpn::Solver Solver(16);
+        std::string Message;
+        try {
+            Solver.loadTT(Path + ".missing");
+        } catch (const std::runtime_error& Error) {
+            Message = Error.what();
+        }
+        TEST_ASSERT_EQ(Message, "Failed to open " + Path + ".missing.");
+    }
+
+    std::filesystem::remove(Path);
+}
+
+TEST(DfPn, SaveAndLoadTTAcrossDepthLimits) {
+    const std::string Path = std::filesystem::temp_directory_path().string() +
+                             "/dfpn_depth_limit_test.bin";
+
+    std::vector<std::string> Sfens;
+    {
+        std::ifstream Ifs("./res/test/mate-5-ply.txt");
+        std::string Line;
+        while (std::getline(Ifs, Line) && Sfens.size() < 20) {
+            Sfens.push_back(Line);
+        }
+    }
+
+    for (const auto& Sfen : Sfens) {
+        // The depth limit is too shallow to find the mate.
+        {
+            nshogi::solver::dfpn::Solver Solver(16);
+            auto State = nshogi::io::sfen::StateBuilder::newState(Sfen);
+            TEST_ASSERT_TRUE(Solver.solve(&State, 100000, 2).isNone());
+            Solver.saveTT(Path);
+        }
+
+        // The disproofs of that solve must not survive into a search
+        // without the limit.
+        nshogi::solver::dfpn::Solver Solver(16);
+        Solver.loadTT(Path);
+        auto State = nshogi::io::sfen::StateBuilder::newState(Sfen);
+        TEST_ASSERT_FALSE(Solver.solve(&State, 100000, 0).isNone());
+    }
+
+    std::filesystem::remove(Path);
+}
+
+namespace {
+
+// A no-mate problem whose search does not finish within a few seconds.
+constexpr const char* LongNoMateSfen = "4k4/9/9/9/9/9/9/9/4K4 b RB 1";
+
+} // namespace
+
+TEST(DfPn, TimeLimit) {
+    nshogi::solver::dfpn::Solver Solver(16);
+    Solver.setTimeLimit(100);
+
+    auto State = nshogi::io::sfen::StateBuilder::newState(LongNoMateSfen);
+    const auto Start = std::chrono::steady_clock::now();
+    const auto Move = Solver.solve(&State, 0, 0);
+    const auto Elapsed = std::chrono::steady_clock::now() - Start;
+
+    TEST_ASSERT_TRUE(Move.isNone());
+    TEST_ASSERT_TRUE(Elapsed < std::chrono::seconds(2));
+
+    // The limit does not prevent solving easy problems.
+    auto MateState = nshogi::io::sfen::StateBuilder::newState(
+        "4k4/9/4G4/9/9/9/9/9/4K4 b G 1");
+    TEST_ASSERT_FALSE(Solver.solve(&MateState, 0, 0).isNone());
+}
+
+TEST(DfPn, StopFromAnotherThread) {
+    constexpr uint64_t MaxNodeCount = 100000000;
+    nshogi::solver::dfpn::Solver Solver(16);
+
+    // The first progress report tells that the search is running, so the
+    // stop cannot arrive before the solve starts.
+    std::promise<void> Started;
+    bool IsStartedSet = false;
+    Solver.setProgressCallback(
+        [&](const nshogi::solver::dfpn::Progress&) {
+            if (!IsStartedSet) {
+                IsStartedSet = true;
+                Started.set_value();
+            }
+        },
+        1);
+
+    auto State = nshogi::io::sfen::StateBuilder::newState(LongNoMateSfen);
+    std::thread Stopper([&Solver, Future = Started.get_future()]() {
+        Future.wait();
+        Solver.stop();
+    });
+    const auto Move = Solver.solve(&State, MaxNodeCount, 0);
+    Stopper.join();
+
+    TEST_ASSERT_TRUE(Move.isNone());
+    TEST_ASSERT_TRUE(Solver.searchedNodeCount() < MaxNodeCount);
+}
+
+TEST(DfPn, StopBeforeSolve) {
+    nshogi::solver::dfpn::Solver Solver(16);
+    auto State = nshogi::io::sfen::StateBuilder::newState(LongNoMateSfen);
+
+    // A stop issued while no solve is running applies to the next solve.
+    Solver.stop();
+    TEST_ASSERT_TRUE(Solver.solve(&State, 100000000, 0).isNone());
+    TEST_ASSERT_EQ(Solver.searchedNodeCount(), (uint64_t)0);
+
+    // And only to that one.
+    auto MateState = nshogi::io::sfen::StateBuilder::newState(
+        "4k4/9/4G4/9/9/9/9/9/4K4 b G 1");
+    TEST_ASSERT_FALSE(Solver.solve(&MateState, 0, 0).isNone());
+}
+
+TEST(DfPn, ProgressCallback) {
+    nshogi::solver::dfpn::Solver Solver(16);
+    Solver.setTimeLimit(200);
+
+    std::vector<nshogi::solver::dfpn::Progress> Reports;
+    Solver.setProgressCallback(
+        [&Reports](const nshogi::solver::dfpn::Progress& P) {
+            Reports.push_back(P);
+        },
+        20);
+
+    auto State = nshogi::io::sfen::StateBuilder::newState(LongNoMateSfen);
+    Solver.solve(&State, 0, 0);
+
+    TEST_ASSERT_TRUE(Reports.size() >= 2);
+    for (std::size_t I = 1; I < Reports.size(); ++I) {
+        TEST_ASSERT_TRUE(Reports[I - 1].NodeCount <= Reports[I].NodeCount);
+    }
+    TEST_ASSERT_EQ(Reports.back().NodeCount, Solver.searchedNodeCount());
+    TEST_ASSERT_TRUE(Reports.back().NodesPerSecond > 0);
+    TEST_ASSERT_TRUE(Reports.back().RootProofNumber > 0);
+    TEST_ASSERT_TRUE(Reports.back().RootDisproofNumber > 0);
+    TEST_ASSERT_TRUE(Reports.back().TTFillRate > 0);
+    TEST_ASSERT_TRUE(Reports.back().TTFillRate <= 1);
+
+    // An empty callback disables the reports.
+    Reports.clear();
+    Solver.setProgressCallback(nullptr);
+    Solver.solve(&State, 10000, 0);
+    TEST_ASSERT_EQ(Reports.size(), (std::size_t)0);
+}
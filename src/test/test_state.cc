@@ -9,11 +9,13 @@
 
 #include "common.h"
 
+#include "../core/attackmapstate.h"
 #include "../core/extendedstate.h"
 #include "../core/internal/hash.h"
 #include "../core/internal/stateadapter.h"
 #include "../core/movegenerator.h"
 #include "../core/positionbuilder.h"
+#include "../core/statearena.h"
 #include "../core/statebuilder.h"
 #include "../io/sfen.h"
 
@@ -25,6 +27,7 @@
 #include <iostream>
 #include <map>
 #include <random>
+#include <type_traits>
 
 namespace {
 
@@ -591,6 +594,41 @@ TEST(State, HashRecomputeRandom) {
     }
 }
 
+TEST(State, BoardHashAfterMoveRandom) {
+    const int N = 100;
+    std::mt19937_64 mt(20260517);
+
+    for (int I = 0; I < N; ++I) {
+        nshogi::core::State State =
+            nshogi::core::StateBuilder::getInitialState();
+
+        nshogi::core::internal::ImmutableStateAdapter Adapter(State);
+
+        for (uint16_t Ply = 0; Ply < 1024; ++Ply) {
+            const auto Moves =
+                nshogi::core::MoveGenerator::generateLegalMoves(State);
+
+            if (Moves.size() == 0) {
+                break;
+            }
+
+            for (const auto Move : Moves) {
+                const uint64_t Expected =
+                    (State.getSideToMove() == nshogi::core::Black)
+                        ? Adapter->getBoardHashAfter<nshogi::core::Black>(Move)
+                        : Adapter->getBoardHashAfter<nshogi::core::White>(
+                              Move);
+
+                State.doMove(Move);
+                TEST_ASSERT_EQ(Adapter->getBoardHash(), Expected);
+                State.undoMove();
+            }
+
+            State.doMove(Moves[mt() % Moves.size()]);
+        }
+    }
+}
+
 TEST(State, CloneRandom) {
     const int N = 1000;
     std::mt19937_64 mt(20230730);
@@ -632,6 +670,209 @@ TEST(State, CloneRandom) {
     }
 }
 
+TEST(State, SnapshotRandom) {
+    static_assert(
+        std::is_trivially_copyable_v<nshogi::core::StateSnapshot>);
+
+    const int N = 300;
+    std::mt19937_64 mt(20260301);
+
+    nshogi::core::State Reused = nshogi::core::StateBuilder::getInitialState();
+
+    for (int I = 0; I < N; ++I) {
+        nshogi::core::State State =
+            nshogi::core::StateBuilder::getInitialState();
+
+        for (uint16_t Ply = 0; Ply < 256; ++Ply) {
+            const nshogi::core::StateSnapshot Snapshot = State.snapshot();
+            nshogi::core::State Restored =
+                nshogi::core::StateBuilder::newState(Snapshot);
+            Reused.restore(Snapshot);
+
+            testRecomputeHelper(Restored);
+            testRecomputeHelper(Reused);
+
+            TEST_ASSERT_EQ(Restored.getHash(), State.getHash());
+            TEST_ASSERT_EQ(Reused.getHash(), State.getHash());
+            TEST_ASSERT_EQ(Restored.getPly(), State.getPly());
+            TEST_ASSERT_EQ(Restored.getPly(false), 0);
+            TEST_ASSERT_EQ(Reused.getPly(), State.getPly());
+            TEST_ASSERT_EQ(Restored.isInCheck(), State.isInCheck());
+            TEST_ASSERT_EQ(nshogi::io::sfen::positionToSfen(
+                               Restored.getPosition(), Restored.getPly(false)),
+                           nshogi::io::sfen::positionToSfen(
+                               State.getPosition(), State.getPly(false)));
+            TEST_ASSERT_TRUE(Restored.getInitialPosition().equals(
+                State.getPosition(), true));
+
+            const auto Moves =
+                nshogi::core::MoveGenerator::generateLegalMoves(State);
+            const auto MovesByRestored =
+                nshogi::core::MoveGenerator::generateLegalMoves(Restored);
+
+            TEST_ASSERT_EQ(Moves.size(), MovesByRestored.size());
+            if (Moves.size() == 0) {
+                break;
+            }
+
+            for (std::size_t J = 0; J < Moves.size(); ++J) {
+                TEST_ASSERT_EQ(Moves[J], MovesByRestored[J]);
+            }
+
+            // Both states must stay in sync after the snapshot.
+            const auto RandomMove = Moves[mt() % Moves.size()];
+            State.doMove(RandomMove);
+            Restored.doMove(RandomMove);
+            Reused.doMove(RandomMove);
+            TEST_ASSERT_EQ(Restored.getHash(), State.getHash());
+            TEST_ASSERT_EQ(Reused.getHash(), State.getHash());
+            TEST_ASSERT_EQ(Restored.getLastMove(), RandomMove);
+            testRecomputeHelper(Restored);
+            Restored.undoMove();
+            TEST_ASSERT_EQ(Restored.getPly(false), 0);
+            TEST_ASSERT_TRUE(
+                Restored.getPosition().equals(Restored.getInitialPosition()));
+        }
+    }
+}
+
+TEST(State, SnapshotWithHistoryRandom) {
+    const int N = 100;
+    std::mt19937_64 mt(20260304);
+
+    for (int I = 0; I < N; ++I) {
+        nshogi::core::State State =
+            nshogi::core::StateBuilder::getInitialState();
+
+        for (uint16_t Ply = 0; Ply < 256; ++Ply) {
+            const nshogi::core::StateSnapshot Snapshot =
+                State.snapshot(nshogi::core::StateSnapshot::MaxHistoryLength);
+            nshogi::core::State Restored =
+                nshogi::core::StateBuilder::newState(Snapshot);
+            testRecomputeHelper(Restored);
+
+            const uint16_t Length =
+                std::min(State.getPly(false),
+                         nshogi::core::StateSnapshot::MaxHistoryLength);
+            TEST_ASSERT_EQ(Restored.getPly(false), Length);
+            TEST_ASSERT_EQ(Restored.getPly(), State.getPly());
+            TEST_ASSERT_EQ(Restored.getLastMove(), State.getLastMove());
+            TEST_ASSERT_EQ(Restored.isLastMoveDroppingAPawn(),
+                           State.isLastMoveDroppingAPawn());
+
+            // The kept history holds the latest repetition if any.
+            if (Restored.getRepetitionStatus(false) !=
+                nshogi::core::RepetitionStatus::NoRepetition) {
+                TEST_ASSERT_EQ(Restored.getRepetitionStatus(false),
+                               State.getRepetitionStatus(false));
+            }
+
+            // The initial position and the moves from it are those of the
+            // original state `Length` plies back.
+            nshogi::core::State Replayed =
+                nshogi::core::StateBuilder::newState(
+                    Restored.getInitialPosition(),
+                    Restored.getInitialPosition().getPlyOffset());
+            for (uint16_t J = 0; J < Length; ++J) {
+                TEST_ASSERT_EQ(
+                    Restored.getHistoryMove(J),
+                    State.getHistoryMove(
+                        (uint16_t)(State.getPly(false) - Length + J)));
+                Replayed.doMove(Restored.getHistoryMove(J));
+            }
+            TEST_ASSERT_EQ(Replayed.getHash(), State.getHash());
+            TEST_ASSERT_TRUE(
+                Replayed.getPosition().equals(State.getPosition(), true));
+
+            const auto Moves =
+                nshogi::core::MoveGenerator::generateLegalMoves(State);
+            if (Moves.size() == 0) {
+                break;
+            }
+
+            const auto RandomMove = Moves[mt() % Moves.size()];
+            State.doMove(RandomMove);
+            Restored.doMove(RandomMove);
+            TEST_ASSERT_EQ(Restored.getHash(), State.getHash());
+            TEST_ASSERT_EQ(Restored.getLastMove(), RandomMove);
+            Restored.undoMove();
+            TEST_ASSERT_EQ(Restored.getPly(false), Length);
+        }
+    }
+}
+
+TEST(State, LastMoveAfterRestore) {
+    nshogi::core::State State = nshogi::io::sfen::StateBuilder::newState(
+        "lnsgkgsnl/1r5b1/pppp1pppp/9/9/9/PPPP1PPPP/1B5R1/LNSGKGSNL b Pp 1 "
+        "moves P*5e");
+    TEST_ASSERT_TRUE(State.isLastMoveDroppingAPawn());
+
+    // Without a history the last move is not known, but the pawn drop is.
+    State.restore(State.snapshot());
+    TEST_ASSERT_EQ(State.getPly(false), 0);
+    TEST_ASSERT_TRUE(State.getLastMove().isNone());
+    TEST_ASSERT_TRUE(State.isLastMoveDroppingAPawn());
+
+    const nshogi::core::State Restored =
+        nshogi::core::StateBuilder::newState(State.snapshot());
+    TEST_ASSERT_TRUE(Restored.getLastMove().isNone());
+    TEST_ASSERT_TRUE(Restored.isLastMoveDroppingAPawn());
+
+    // An initial state has no last move either.
+    const nshogi::core::State Initial =
+        nshogi::core::StateBuilder::getInitialState();
+    TEST_ASSERT_TRUE(Initial.getLastMove().isNone());
+    TEST_ASSERT_FALSE(Initial.isLastMoveDroppingAPawn());
+}
+
+TEST(State, ArenaRandom) {
+    const int N = 100;
+    std::mt19937_64 mt(20260303);
+
+    nshogi::core::StateArena Arena;
+    std::vector<nshogi::core::State> States;
+
+    for (int I = 0; I < N; ++I) {
+        nshogi::core::State State =
+            nshogi::core::StateBuilder::getInitialState();
+
+        for (uint16_t Ply = 0; Ply < 256; ++Ply) {
+            nshogi::core::State FromArena =
+                nshogi::core::StateBuilder::newState(State.getPosition(),
+                                                     State.getPly(), Arena);
+            testRecomputeHelper(FromArena);
+            TEST_ASSERT_EQ(FromArena.getHash(), State.getHash());
+            TEST_ASSERT_EQ(FromArena.getPly(), State.getPly());
+            TEST_ASSERT_EQ(FromArena.getPly(false), 0);
+
+            const auto Moves =
+                nshogi::core::MoveGenerator::generateLegalMoves(State);
+            if (Moves.size() == 0) {
+                break;
+            }
+
+            // Leave some history behind for the next user of the memory.
+            const auto RandomMove = Moves[mt() % Moves.size()];
+            State.doMove(RandomMove);
+            FromArena.doMove(RandomMove);
+            TEST_ASSERT_EQ(FromArena.getHash(), State.getHash());
+
+            // Keep some states alive so that the arena holds several.
+            if (mt() % 4 == 0) {
+                States.push_back(std::move(FromArena));
+            }
+            if (States.size() > 8) {
+                States.clear();
+            }
+        }
+    }
+
+    States.clear();
+    TEST_ASSERT_TRUE(Arena.size() > 1);
+    Arena.clear();
+    TEST_ASSERT_EQ(Arena.size(), (std::size_t)0);
+}
+
 TEST(State, RepetitionHandmade1) {
     const std::string Sfen = "lnsgkgsnl/1r5b1/ppppppppp/9/9/9/PPPPPPPPP/1B5R1/"
                              "LNSGKGSNL b - 1 moves 2h3h 8b7b 3h2h 7b8b";
@@ -641,6 +882,37 @@ TEST(State, RepetitionHandmade1) {
                    nshogi::core::RepetitionStatus::Repetition);
 }
 
+TEST(State, RepetitionAfterUndoAndClone) {
+    const std::string Sfen = "lnsgkgsnl/1r5b1/ppppppppp/9/9/9/PPPPPPPPP/1B5R1/"
+                             "LNSGKGSNL b - 1 moves 2h3h 8b7b 3h2h 7b8b";
+    nshogi::core::State State = nshogi::io::sfen::StateBuilder::newState(Sfen);
+
+    // Taking back the last move must forget the repeated position.
+    const nshogi::core::Move32 LastMove = State.getLastMove();
+    State.undoMove();
+    TEST_ASSERT_EQ(State.getRepetitionStatus(false),
+                   nshogi::core::RepetitionStatus::NoRepetition);
+    State.doMove(LastMove);
+    TEST_ASSERT_EQ(State.getRepetitionStatus(false),
+                   nshogi::core::RepetitionStatus::Repetition);
+
+    const nshogi::core::State Cloned = State.clone();
+    TEST_ASSERT_EQ(Cloned.getRepetitionStatus(false),
+                   nshogi::core::RepetitionStatus::Repetition);
+
+    // A restored state repeats only the history kept in the snapshot.
+    const nshogi::core::StateSnapshot Snapshot = State.snapshot(4);
+    State.restore(State.snapshot());
+    TEST_ASSERT_EQ(State.getRepetitionStatus(false),
+                   nshogi::core::RepetitionStatus::NoRepetition);
+
+    State.restore(Snapshot);
+    TEST_ASSERT_EQ(State.getPly(false), 4);
+    TEST_ASSERT_EQ(State.getLastMove(), LastMove);
+    TEST_ASSERT_EQ(State.getRepetitionStatus(false),
+                   nshogi::core::RepetitionStatus::Repetition);
+}
+
 TEST(State, RepetitionHandmade2) {
     nshogi::core::State State = nshogi::core::StateBuilder::getInitialState();
     TEST_ASSERT_EQ(State.getRepetitionStatus(false),
@@ -1372,3 +1644,83 @@ TEST(ExtendedState, ComputeSEEMatchesSmallestMoveIteration) {
         }
     }
 }
+
+namespace {
+
+void testAttackCounts(const nshogi::core::AttackMapState& State) {
+    const nshogi::core::AttackMapState Fresh(State.getState().clone());
+    nshogi::core::internal::ImmutableStateAdapter Adapter(State.getState());
+
+    const nshogi::core::internal::bitboard::Bitboard AttackBBs[] = {
+        Adapter->getAttackBB<nshogi::core::Black>(),
+        Adapter->getAttackBB<nshogi::core::White>(),
+    };
+
+    for (nshogi::core::Color C : nshogi::core::Colors) {
+        for (nshogi::core::Square Sq : nshogi::core::Squares) {
+            TEST_ASSERT_EQ(State.getAttackCount(C, Sq),
+                           Fresh.getAttackCount(C, Sq));
+            TEST_ASSERT_EQ(State.getAttackCount(C, Sq) > 0,
+                           AttackBBs[C].isSet(Sq));
+        }
+    }
+}
+
+} // namespace
+
+TEST(AttackMapState, InitialPosition) {
+    const nshogi::core::AttackMapState State =
+        nshogi::core::StateBuilder::getInitialState();
+
+    // The king, the two golds and the rook.
+    TEST_ASSERT_EQ(State.getAttackCount(nshogi::core::Black,
+                                        nshogi::core::Sq5H), 4);
+    TEST_ASSERT_EQ(State.getAttackCount(nshogi::core::White,
+                                        nshogi::core::Sq5B), 4);
+
+    // The bishop and the knight.
+    TEST_ASSERT_EQ(State.getAttackCount(nshogi::core::Black,
+                                        nshogi::core::Sq7G), 2);
+    TEST_ASSERT_EQ(State.getAttackCount(nshogi::core::White,
+                                        nshogi::core::Sq3C), 2);
+
+    TEST_ASSERT_EQ(State.getAttackCount(nshogi::core::Black,
+                                        nshogi::core::Sq5E), 0);
+    TEST_ASSERT_EQ(State.getAttackCount(nshogi::core::White,
+                                        nshogi::core::Sq5E), 0);
+
+    testAttackCounts(State);
+}
+
+TEST(AttackMapState, DoMoveUndoMoveRandom) {
+    const int N = 100;
+    std::mt19937_64 mt(20260824);
+
+    for (int I = 0; I < N; ++I) {
+        nshogi::core::AttackMapState State =
+            nshogi::core::StateBuilder::getInitialState();
+
+        for (uint16_t Ply = 0; Ply < 512; ++Ply) {
+            testAttackCounts(State);
+
+            const auto Moves = nshogi::core::MoveGenerator::generateLegalMoves(
+                State.getState());
+            if (Moves.size() == 0) {
+                break;
+            }
+
+            // Try a move and take it back before going on.
+            State.doMove(Moves[mt() % Moves.size()]);
+            testAttackCounts(State);
+            State.undoMove();
+            testAttackCounts(State);
+
+            State.doMove(Moves[mt() % Moves.size()]);
+        }
+
+        while (State.getState().getPly() > 0) {
+            State.undoMove();
+        }
+        testAttackCounts(State);
+    }
+}